@@ -0,0 +1,401 @@
+/* contains implementation for operations on Bit enCoded Matrices (bcm.h)
+ * for the Flack left coset decomposition program which uses
+ * uses alogorithms outlined in Acta Cryst. (1987), A43,
+ * 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifdef NEED_C89_COMPATIBILITY
+#undef _ISOC99_SOURCE
+#else
+#define _ISOC99_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <limits.h>
+
+#include "symm_mat.h"
+#include "bcm.h"
+
+/* Each matrix element occupies a 2 bit field (see the encoding scheme
+ * described in symm_mat.c): 0x0 => 0, 0x1 => 1, 0x2 => -1.  Field 'k' holds
+ * the element [k/3][k%3].  The pattern 0x3 is never produced by
+ * encode_matrix().
+ */
+#define FIELD(m, k)     (((m) >> (2 * (k))) & 0x3U)
+#define PLUS_BITS       0x15555U  /* low bit of every field */
+#define MINUS_BITS      0x2aaaaU  /* high bit of every field */
+
+static const int field_value[4] = { 0, 1, -1, 0 };
+static const unsigned int value_field[3] = { 0x2, 0x0, 0x1 };  /* indexed by value + 1 */
+
+/* bcm_unpack(): decodes the nine elements of a bcm into 'e' in row major order */
+void bcm_unpack( unsigned int a, int e[9] )
+{
+    int k;
+
+    for( k = 0; k < 9; k++ ) {
+         e[k] = field_value[FIELD(a, k)];
+    }
+    return;
+}
+
+/* bcm_pack(): encodes nine integer elements given in row major order,
+ * returns BCM_ERROR if any of them lies outside of -1..1
+ */
+unsigned int bcm_pack( const int e[9] )
+{
+    int k;
+    unsigned int cmx = 0;
+
+    for( k = 0; k < 9; k++ ) {
+         if( (e[k] < -1) || (e[k] > 1) ) {
+             return BCM_ERROR;
+         }
+         cmx |= value_field[e[k] + 1] << (2 * k);
+    }
+    return cmx;
+}
+
+/* determinant of a matrix unpacked in row major order */
+static int unpacked_determinant( const int e[9] )
+{
+    return e[0] * (e[4] * e[8] - e[5] * e[7]) -
+           e[1] * (e[3] * e[8] - e[5] * e[6]) +
+           e[2] * (e[3] * e[7] - e[4] * e[6]);
+}
+
+/* bcm_is_valid(): returns 1 if 'a' is a well formed encoding of a matrix,
+ * and 0 if it is BCM_ERROR, out of range, or contains the 0x3 bit pattern.
+ */
+int bcm_is_valid( unsigned int a )
+{
+    if( (BCM_ERROR == a) || (a >= BCM_INDEX_SIZE) ) {
+        return 0;
+    }
+    return 0 == (a & (a >> 1) & PLUS_BITS) ? 1 : 0;
+}
+
+/* bcm_element(): returns the matrix element [row][col] of an encoded matrix */
+int bcm_element( unsigned int a, int row, int col )
+{
+    return field_value[FIELD(a, 3 * row + col)];
+}
+
+/* bcm_multiply(): returns the encoded product a*b */
+unsigned int bcm_multiply( unsigned int a, unsigned int b )
+{
+    int i, j;
+    int ea[9], eb[9], ec[9];
+
+    if( !bcm_is_valid(a) || !bcm_is_valid(b) ) {
+        return BCM_ERROR;
+    }
+
+    bcm_unpack( a, ea );
+    bcm_unpack( b, eb );
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              ec[3*i+j] = ea[3*i] * eb[j] + ea[3*i+1] * eb[3+j] + ea[3*i+2] * eb[6+j];
+         }
+    }
+    return bcm_pack( ec );
+}
+
+/* bcm_negate(): returns the encoding of -a.  Negating an element just swaps
+ * the two bits of its field, so this is done for all nine elements at once.
+ */
+unsigned int bcm_negate( unsigned int a )
+{
+    if( !bcm_is_valid(a) ) {
+        return BCM_ERROR;
+    }
+    return ((a & PLUS_BITS) << 1) | ((a & MINUS_BITS) >> 1);
+}
+
+/* bcm_transpose(): returns the encoding of the transpose of a.  The diagonal
+ * fields stay put and the off diagonal fields are swapped pairwise.
+ */
+unsigned int bcm_transpose( unsigned int a )
+{
+    if( !bcm_is_valid(a) ) {
+        return BCM_ERROR;
+    }
+    return (a & 0x30303U)                 /* [0][0], [1][1], [2][2] */
+           | ((a & 0x00c0cU) << 4)        /* [0][1] -> [1][0], [1][2] -> [2][1] */
+           | ((a & 0x0c0c0U) >> 4)        /* [1][0] -> [0][1], [2][1] -> [1][2] */
+           | ((a & 0x00030U) << 8)        /* [0][2] -> [2][0] */
+           | ((a & 0x03000U) >> 8);       /* [2][0] -> [0][2] */
+}
+
+/* bcm_inverse(): returns the encoding of the inverse of a.  Only matrices
+ * with a determinant of +1 or -1 have an inverse which can be encoded.
+ */
+unsigned int bcm_inverse( unsigned int a )
+{
+    int det;
+    int e[9], inv[9];
+
+    if( !bcm_is_valid(a) ) {
+        return BCM_ERROR;
+    }
+    bcm_unpack( a, e );
+    det = unpacked_determinant( e );
+    if( (1 != det) && (-1 != det) ) {
+        return BCM_ERROR;
+    }
+
+/* adjugate divided by the determinant, which for det = +/-1 is a multiplication */
+    inv[0] =  (e[4] * e[8] - e[5] * e[7]) * det;
+    inv[1] = -(e[1] * e[8] - e[2] * e[7]) * det;
+    inv[2] =  (e[1] * e[5] - e[2] * e[4]) * det;
+    inv[3] = -(e[3] * e[8] - e[5] * e[6]) * det;
+    inv[4] =  (e[0] * e[8] - e[2] * e[6]) * det;
+    inv[5] = -(e[0] * e[5] - e[2] * e[3]) * det;
+    inv[6] =  (e[3] * e[7] - e[4] * e[6]) * det;
+    inv[7] = -(e[0] * e[7] - e[1] * e[6]) * det;
+    inv[8] =  (e[0] * e[4] - e[1] * e[3]) * det;
+
+    return bcm_pack( inv );
+}
+
+/* bcm_determinant(): returns the determinant of an encoded matrix */
+int bcm_determinant( unsigned int a )
+{
+    int e[9];
+
+    bcm_unpack( a, e );
+    return unpacked_determinant( e );
+}
+
+/* bcm_trace(): returns the trace of an encoded matrix */
+int bcm_trace( unsigned int a )
+{
+    return field_value[FIELD(a, 0)] + field_value[FIELD(a, 4)] + field_value[FIELD(a, 8)];
+}
+
+/* bcm_index_array(): records the position of each of the 'n' encoded
+ * matrices of 'bcm' in the index 'x'.  Matrices which could not be encoded
+ * (BCM_ERROR) are not indexed.  If an encoding occurs more than once the
+ * first position is kept.  Returns the number of operators indexed, or -1
+ * if the group is too large to be indexed.
+ */
+int bcm_index_array( struct bcm_index *x, const unsigned int *bcm, int n )
+{
+    int i,
+        n_indexed = 0;
+
+    if( n > 255 ) {  /* slot values must fit in an unsigned char */
+        return -1;
+    }
+    for( i = 0; i < n; i++ ) {
+         if( (BCM_ERROR == bcm[i]) || (bcm[i] >= BCM_INDEX_SIZE) ) {
+             continue;
+         }
+         if( 0 == x->slot[bcm[i]] ) {
+             x->slot[bcm[i]] = (unsigned char)(i + 1);
+             n_indexed++;
+         }
+    }
+    return n_indexed;
+}
+
+/* bcm_unindex_array(): clears the slots set by bcm_index_array() so that
+ * the index can be reused for another group.  Only the slots belonging to
+ * 'bcm' are touched, rather than the whole table.
+ */
+void bcm_unindex_array( struct bcm_index *x, const unsigned int *bcm, int n )
+{
+    int i;
+
+    for( i = 0; i < n; i++ ) {
+         if( bcm[i] < BCM_INDEX_SIZE ) {
+             x->slot[bcm[i]] = 0;
+         }
+    }
+    return;
+}
+
+/* bcm_index_group(): as bcm_index_array() for the sentinel terminated array
+ * 'g'.
+ */
+int bcm_index_group( struct bcm_index *x, struct symm_op *g )
+{
+    int i,
+        n_indexed = 0;
+
+    for( i = 0; 0 != g[i].bcm; i++ ) {
+         if( i >= 255 ) {
+             bcm_unindex_group( x, g );
+             return -1;
+         }
+         if( (BCM_ERROR == g[i].bcm) || (g[i].bcm >= BCM_INDEX_SIZE) ) {
+             continue;
+         }
+         if( 0 == x->slot[g[i].bcm] ) {
+             x->slot[g[i].bcm] = (unsigned char)(i + 1);
+             n_indexed++;
+         }
+    }
+    return n_indexed;
+}
+
+/* bcm_unindex_group(): as bcm_unindex_array() for the sentinel terminated
+ * array 'g'.
+ */
+void bcm_unindex_group( struct bcm_index *x, struct symm_op *g )
+{
+    int i;
+
+    for( i = 0; 0 != g[i].bcm; i++ ) {
+         if( g[i].bcm < BCM_INDEX_SIZE ) {
+             x->slot[g[i].bcm] = 0;
+         }
+    }
+    return;
+}
+
+/* bcm_index_lookup(): returns the array position of the operator encoded by
+ * 'bcm', or BCM_NOT_FOUND if it is not a member of the indexed group.
+ */
+int bcm_index_lookup( const struct bcm_index *x, unsigned int bcm )
+{
+    if( (BCM_ERROR == bcm) || (bcm >= BCM_INDEX_SIZE) ) {
+        return BCM_NOT_FOUND;
+    }
+    return (int)x->slot[bcm] - 1;
+}
+
+/* bcm_closure(): generates the group from the 'n_gens' encoded generators in
+ * 'gens'.  The operators are written to 'ops', the identity first, and a
+ * bitmap over all encodings marks those already found.  Each new operator is
+ * multiplied by every generator, and new products go on the end of the
+ * list, which is the worklist.  Returns the order of the group, or -1 if a
+ * generator or product can't be encoded or the group has more than 'max_ops'
+ * operators (i.e. it isn't a crystallographic point group).
+ */
+int bcm_closure( const unsigned int *gens, int n_gens, unsigned int *ops, int max_ops )
+{
+    static unsigned char found[BCM_INDEX_SIZE / CHAR_BIT];
+    unsigned int p;
+    int i, j,
+        n = 0,
+        ok = 1;
+
+    if( max_ops < 1 ) {
+        return -1;
+    }
+    for( j = 0; j < n_gens; j++ ) {
+         if( !bcm_is_valid( gens[j] ) ) {
+             return -1;
+         }
+    }
+
+    ops[n++] = IDENTITY_BCM;
+    found[IDENTITY_BCM / CHAR_BIT] |= (unsigned char)(1U << (IDENTITY_BCM % CHAR_BIT));
+
+    for( i = 0; ok && (i < n); i++ ) {
+         for( j = 0; ok && (j < n_gens); j++ ) {
+              p = bcm_multiply( ops[i], gens[j] );
+              if( BCM_ERROR == p ) {
+                  ok = 0;
+              }
+              else if( 0 == (found[p / CHAR_BIT] & (1U << (p % CHAR_BIT))) ) {
+                  if( n == max_ops ) {
+                      ok = 0;
+                  }
+                  else {
+                      found[p / CHAR_BIT] |= (unsigned char)(1U << (p % CHAR_BIT));
+                      ops[n++] = p;
+                  }
+              }
+         }
+    }
+
+/* clear only the bytes which were used, so the bitmap is ready for reuse */
+    for( i = 0; i < n; i++ ) {
+         found[ops[i] / CHAR_BIT] = 0;
+    }
+    return ok ? n : -1;
+}
+
+/* bcm_centric_order(): puts the 'n' operators of a group in the order which
+ * Flack's algorithm B expects of a centric group: the identity, which is
+ * swapped with the first operator, the rest of the proper operators in
+ * their order, then the inversion related partners in the same order, so
+ * that ops[i + n/2] = -ops[i].  An acentric group only has its identity
+ * swapped to the front.  Returns 0, or
+ * -1 if a partner is missing, i.e. 'ops' is not a group.
+ */
+int bcm_centric_order( unsigned int *ops, int n )
+{
+    unsigned int t;
+    int i, j, k,
+        n_proper = 0,
+        centric = 0;
+
+    for( i = 0; i < n; i++ ) {
+         if( IDENTITY_BCM == ops[i] ) {
+             ops[i] = ops[0];
+             ops[0] = IDENTITY_BCM;
+             break;
+         }
+    }
+    for( i = 0; i < n; i++ ) {
+         if( INVERSION_BCM == ops[i] ) {
+             centric = 1;
+         }
+    }
+    if( !centric ) {
+        return 0;
+    }
+    if( 0 != n % 2 ) {
+        return -1;
+    }
+
+/* the proper operators to the front, keeping their order */
+    for( i = 0; i < n; i++ ) {
+         if( bcm_determinant( ops[i] ) > 0 ) {
+             t = ops[i];
+             for( j = i; j > n_proper; j-- ) {
+                  ops[j] = ops[j-1];
+             }
+             ops[n_proper++] = t;
+         }
+    }
+    if( 2 * n_proper != n ) {
+        return -1;
+    }
+
+/* then each partner to the place of its proper operator */
+    for( i = 0; i < n_proper; i++ ) {
+         for( k = n_proper + i; (k < n) && (ops[k] != bcm_negate( ops[i] )); k++ )
+              ;
+         if( k == n ) {
+             return -1;
+         }
+         t = ops[k];
+         ops[k] = ops[n_proper + i];
+         ops[n_proper + i] = t;
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+/* contains public interface for operations on Bit enCoded Matrices (BCM)
+ * for the Flack left coset decomposition program which uses
+ * uses alogorithms outlined in Acta Cryst. (1987), A43,
+ * 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef BCM_H
+#define BCM_H
+
+#include "symm_mat.h"
+
+#define IDENTITY_BCM    0x10101
+
+/* a BCM uses 2 bits for each of the 9 matrix elements (see symm_mat.c), so
+ * every valid encoding is less than 2^18.  This lets us index a group
+ * directly by its encoded matrices with a flat table.
+ */
+#define BCM_BITS        18
+#define BCM_INDEX_SIZE  (1U << BCM_BITS)
+#define BCM_NOT_FOUND   (-1)
+
+/* bcm_index maps a BCM to the position of that operator in a sentinel
+ * terminated array of struct symm_op.  A slot holds 1 + the array index
+ * of the operator, or 0 when the operator is not a member of the group.
+ * The table is large (256 kB), so callers should keep a single static
+ * instance and index/unindex groups as they are needed.
+ */
+struct bcm_index {
+       unsigned char slot[BCM_INDEX_SIZE];
+       };
+
+/* prototypes */
+
+/* integer group algebra on encoded matrices.  None of these touch floating
+ * point data.  Functions returning an encoded matrix return BCM_ERROR if an
+ * argument is BCM_ERROR, or if the result has an element which is not
+ * -1, 0, or 1 and so cannot be encoded.
+ */
+unsigned int bcm_pack( const int e[9] );
+void bcm_unpack( unsigned int a, int e[9] );
+int bcm_is_valid( unsigned int a );
+int bcm_element( unsigned int a, int row, int col );
+unsigned int bcm_multiply( unsigned int a, unsigned int b );
+unsigned int bcm_negate( unsigned int a );
+unsigned int bcm_transpose( unsigned int a );
+unsigned int bcm_inverse( unsigned int a );
+int bcm_determinant( unsigned int a );
+int bcm_trace( unsigned int a );
+
+/* indexing of groups by encoded matrix */
+int bcm_index_array( struct bcm_index *x, const unsigned int *bcm, int n );
+void bcm_unindex_array( struct bcm_index *x, const unsigned int *bcm, int n );
+int bcm_index_group( struct bcm_index *x, struct symm_op *g );
+void bcm_unindex_group( struct bcm_index *x, struct symm_op *g );
+int bcm_index_lookup( const struct bcm_index *x, unsigned int bcm );
+
+/* generation of a group from its generators */
+int bcm_closure( const unsigned int *gens, int n_gens, unsigned int *ops, int max_ops );
+int bcm_centric_order( unsigned int *ops, int n );
+
+#endif
@@ -0,0 +1,1044 @@
+/* contains implementation for the bulk screening of unit cells of the
+ * Flack left coset decomposition program which uses alogorithms outlined
+ * in Acta Cryst. (1987), A43, 564-568, by H. D. Flack.
+ *
+ * 'coset -B' reads the cells and space groups of many structures, from
+ * PDB CRYST1 records, CIF cell and symmetry items or CSV rows, and screens
+ * each of them for merohedral and pseudo-merohedral twinning: the
+ * supergroup is the lattice symmetry of the cell (see lattice_symm.h), the
+ * subgroup is the point group of the space group, and the twin laws of the
+ * coset decomposition are counted and ranked by their obliquity.  Each
+ * structure gives one line of output.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifdef NEED_C89_COMPATIBILITY
+#undef _ISOC99_SOURCE
+#else
+#define _ISOC99_SOURCE
+#endif
+
+/* the entries are screened by worker processes where there is fork(),
+ * otherwise one at a time (see shelx_exec.c for USE_SYSTEM_FUNCTION)
+ */
+#ifndef USE_SYSTEM_FUNCTION
+#define _XOPEN_SOURCE 500
+#define FORKEXEC
+#endif
+
+#ifdef FORKEXEC
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <errno.h>
+
+#ifdef NEED_C89_COMPATIBILITY
+#include "c89_util.h"
+#endif
+
+#include "float_util.h"
+#include "bcm.h"
+#include "symm_group.h"
+#include "group_mask.h"
+#include "coset.h"
+#include "rational.h"
+#include "twin_class.h"
+#include "twin_metric.h"
+#include "lattice_symm.h"
+#include "point_group.h"
+#include "task.h"
+#include "bulk.h"
+
+#define MSG_BUF_SZ       256
+#define ALL_CELL_ITEMS   0x3fu     /* a, b, c, alpha, beta, gamma */
+#define AXES_TOLERANCE   1.0e-3    /* relative, for rhombohedral axes */
+#define ANGLE_TOLERANCE  0.01      /* degrees */
+
+/* the first six are the cell parameters in the order of struct unit_cell,
+ * the rest are the space group.  mmCIF names, e.g. _cell.length_a, are
+ * the same once the '.' is read as '_'.
+ */
+static const char *cif_items[] = {
+       "_cell_length_a", "_cell_length_b", "_cell_length_c",
+       "_cell_angle_alpha", "_cell_angle_beta", "_cell_angle_gamma",
+       "_symmetry_space_group_name_h-m",
+       "_space_group_name_h-m_alt",
+       NULL
+       };
+
+/* record names which start a PDB file */
+static const char *pdb_records[] = {
+       "HEADER", "CRYST1", "TITLE ", "COMPND", "SOURCE", "KEYWDS", "EXPDTA",
+       "AUTHOR", "REMARK", "SEQRES", "ATOM  ", "HETATM", "MODEL ",
+       NULL
+       };
+
+static const char *format_names[] = { "", "pdb", "cif", "csv", NULL };
+
+
+/* starts_with(): 1 if 's' starts with 'prefix', ignoring case */
+static int starts_with( const char *s, const char *prefix )
+{
+    while( '\0' != *prefix ) {
+        if( tolower( (unsigned char)*s ) != tolower( (unsigned char)*prefix ) ) {
+            return 0;
+        }
+        s++;
+        prefix++;
+    }
+    return 1;
+}
+
+/* parse_number(): reads a number which may be followed by blanks or by its
+ * standard uncertainty in parentheses, e.g. "12.345(3)".  Returns 0, or -1
+ * if 's' is not a number.
+ */
+static int parse_number( const char *s, double *x )
+{
+    char *end;
+
+    *x = strtod( s, &end );
+    if( end == s ) {
+        return -1;
+    }
+    while( isspace( (unsigned char)*end ) ) {
+        end++;
+    }
+    return ('\0' == *end) || ('(' == *end) ? 0 : -1;
+}
+
+/* trim(): strips blanks, and one pair of quotes, from both ends of 's' */
+static char *trim( char *s )
+{
+    size_t n;
+
+    while( isspace( (unsigned char)*s ) ) {
+        s++;
+    }
+    n = strlen( s );
+    while( (n > 0) && isspace( (unsigned char)s[n-1] ) ) {
+        s[--n] = '\0';
+    }
+    if( (n >= 2) && (('"' == s[0]) || ('\'' == s[0])) && (s[n-1] == s[0]) ) {
+        s[n-1] = '\0';
+        s++;
+    }
+    return s;
+}
+
+static void set_cell_item( struct bulk_entry *e, int k, double x )
+{
+    double *p[6];
+
+    p[0] = &e->cell.a;
+    p[1] = &e->cell.b;
+    p[2] = &e->cell.c;
+    p[3] = &e->cell.alpha;
+    p[4] = &e->cell.beta;
+    p[5] = &e->cell.gamma;
+    *p[k] = x;
+    e->cell_items |= 1u << k;
+    return;
+}
+
+static void set_space_group( struct bulk_entry *e, const char *s )
+{
+    snprintf( e->space_group, sizeof(e->space_group), "%s", s );
+    return;
+}
+
+/* start_entry(): begins a new entry, named 'id' if it is given, otherwise
+ * after the file and its place in it
+ */
+static void start_entry( struct bulk_reader *r, const char *id )
+{
+    memset( &r->entry, 0, sizeof(r->entry) );
+    if( (NULL != id) && ('\0' != *id) ) {
+        snprintf( r->entry.id, sizeof(r->entry.id), "%s", id );
+    }
+    else if( 0 == r->n_entries ) {
+        snprintf( r->entry.id, sizeof(r->entry.id), "%s", r->base_id );
+    }
+    else {
+        snprintf( r->entry.id, sizeof(r->entry.id), "%.19s:%d", r->base_id, r->n_entries + 1 );
+    }
+    r->entry.error = NULL;
+    r->open_entry = 1;
+    return;
+}
+
+/* finish_entry(): returns the entry which has been read in 'e', with the
+ * reason it can't be screened if it can't.  Returns 1.
+ */
+static int finish_entry( struct bulk_reader *r, struct bulk_entry *e )
+{
+    const struct unit_cell *c = &r->entry.cell;
+
+    if( NULL != r->entry.error ) {
+        ;
+    }
+    else if( ALL_CELL_ITEMS != r->entry.cell_items ) {
+        r->entry.error = "no unit cell";
+    }
+    else if( !cell_is_valid( c ) ) {
+        r->entry.error = "the unit cell is not valid";
+    }
+    else if( (1.0 == c->a) && (1.0 == c->b) && (1.0 == c->c) ) {
+        r->entry.error = "no unit cell (1 1 1 90 90 90 placeholder)";
+    }
+    else if( '\0' == r->entry.space_group[0] ) {
+        r->entry.error = "no space group";
+    }
+    *e = r->entry;
+    r->open_entry = 0;
+    r->n_entries++;
+    return 1;
+}
+
+/* read_line(): the next line of the file without its line end.  The rest
+ * of an overlong line is skipped.  Returns NULL at the end of the file.
+ */
+static char *read_line( struct bulk_reader *r )
+{
+    size_t n;
+    int ch;
+
+    if( NULL == fgets( r->line, sizeof(r->line), r->fp ) ) {
+        return NULL;
+    }
+    r->line_num++;
+    n = strlen( r->line );
+    if( (n > 0) && ('\n' != r->line[n-1]) ) {
+        while( (EOF != (ch = getc( r->fp ))) && ('\n' != ch) ) {
+            ;
+        }
+    }
+    while( (n > 0) && (('\n' == r->line[n-1]) || ('\r' == r->line[n-1])) ) {
+        r->line[--n] = '\0';
+    }
+    return r->line;
+}
+
+/* sniff_format(): the format of a file from its first lines, or BULK_SNIFF
+ * if 'line' doesn't tell
+ */
+static int sniff_format( const char *line )
+{
+    int k;
+
+    if( starts_with( line, "#\\#CIF" ) || starts_with( line, "data_" ) || ('_' == line[0]) ) {
+        return BULK_CIF;
+    }
+    for( k = 0; NULL != pdb_records[k]; k++ ) {
+         if( 0 == strncmp( line, pdb_records[k], strlen( pdb_records[k] ) ) ) {
+             return BULK_PDB;
+         }
+    }
+    line += strspn( line, " \t" );
+    if( ('\0' == *line) || ('#' == *line) ) {
+        return BULK_SNIFF;
+    }
+    return BULK_CSV;
+}
+
+/* pdb_field(): columns 'first' to 'last' (from 1, as in the PDB format
+ * description) of a record, without blanks
+ */
+static char *pdb_field( char *buf, size_t len, const char *line, int first, int last )
+{
+    size_t n = strlen( line ),
+           k = 0;
+    int col;
+
+    for( col = first; (col <= last) && ((size_t)col <= n) && (k + 1 < len); col++ ) {
+         buf[k++] = line[col-1];
+    }
+    buf[k] = '\0';
+    return trim( buf );
+}
+
+/* pdb_line(): a PDB file gives an entry at each CRYST1 record, named by the
+ * id code of the HEADER record before it.  A HEADER without a CRYST1 gives
+ * an entry which can't be screened.  Returns 1 if there is an entry in
+ * 'e'.
+ */
+static int pdb_line( struct bulk_reader *r, struct bulk_entry *e )
+{
+    static const int cols[6][2] = { {7, 15}, {16, 24}, {25, 33}, {34, 40}, {41, 47}, {48, 54} };
+    char buf[BULK_ID_LEN];
+    double x;
+    int k, got = 0;
+
+    if( 0 == strncmp( r->line, "HEADER", 6 ) ) {
+        if( r->open_entry ) {
+            r->entry.error = "no CRYST1 record";
+            got = finish_entry( r, e );
+        }
+        start_entry( r, pdb_field( buf, sizeof(buf), r->line, 63, 66 ) );
+        return got;
+    }
+    if( 0 != strncmp( r->line, "CRYST1", 6 ) ) {
+        return 0;
+    }
+
+    if( !r->open_entry ) {
+        start_entry( r, NULL );
+    }
+    for( k = 0; k < 6; k++ ) {
+         if( 0 == parse_number( pdb_field( buf, sizeof(buf), r->line, cols[k][0], cols[k][1] ), &x ) ) {
+             set_cell_item( &r->entry, k, x );
+         }
+    }
+    set_space_group( &r->entry, pdb_field( buf, sizeof(buf), r->line, 56, 66 ) );
+    return finish_entry( r, e );
+}
+
+/* cif_value(): the value which starts at 's', quoted or not, or NULL for
+ * the unknown values '?' and '.'
+ */
+static char *cif_value( char *s )
+{
+    char *end;
+
+    s += strspn( s, " \t" );
+    if( ('\'' == *s) || ('"' == *s) ) {
+        end = strchr( s + 1, *s );
+        while( (NULL != end) && ('\0' != end[1]) && !isspace( (unsigned char)end[1] ) ) {
+            end = strchr( end + 1, *s );
+        }
+        if( NULL != end ) {
+            *end = '\0';
+        }
+        return s + 1;
+    }
+    end = s + strcspn( s, " \t" );
+    *end = '\0';
+    if( ('\0' == *s) || (0 == strcmp( s, "?" )) || (0 == strcmp( s, "." )) ) {
+        return NULL;
+    }
+    return s;
+}
+
+static void set_cif_item( struct bulk_entry *e, int k, char *s )
+{
+    double x;
+
+    s = cif_value( s );
+    if( NULL == s ) {
+        return;
+    }
+    if( k >= 6 ) {
+        set_space_group( e, s );
+    }
+    else if( 0 == parse_number( s, &x ) ) {
+        set_cell_item( e, k, x );
+    }
+    return;
+}
+
+/* cif_item(): the position in cif_items[] of the item at the start of 's',
+ * or -1 if it isn't one of them.  '*value' is set to what follows the name.
+ */
+static int cif_item( char *s, char **value )
+{
+    char name[64];
+    size_t n;
+    int k;
+
+    n = strcspn( s, " \t" );
+    *value = s + n;
+    if( n >= sizeof(name) ) {
+        return -1;
+    }
+    for( k = 0; k < (int)n; k++ ) {
+         name[k] = '.' == s[k] ? '_' : (char)tolower( (unsigned char)s[k] );
+    }
+    name[n] = '\0';
+    for( k = 0; NULL != cif_items[k]; k++ ) {
+         if( 0 == strcmp( name, cif_items[k] ) ) {
+             return k;
+         }
+    }
+    return -1;
+}
+
+/* cif_has_items(): 1 if the data block being read has a cell or symmetry
+ * item.  Blocks without any, e.g. the global block of a journal's CIF,
+ * are not entries.
+ */
+static int cif_has_items( const struct bulk_reader *r )
+{
+    return r->open_entry && ((0 != r->entry.cell_items) || ('\0' != r->entry.space_group[0]));
+}
+
+/* cif_line(): each data block of a CIF is an entry, named by the block.
+ * Items in loops and text fields are passed over.  Returns 1 if there is
+ * an entry in 'e'.
+ */
+static int cif_line( struct bulk_reader *r, struct bulk_entry *e )
+{
+    char *s = r->line, *value;
+    int k, got = 0;
+
+    if( r->cif_text ) {
+        r->cif_text = ';' != s[0];
+        return 0;
+    }
+    if( ';' == s[0] ) {
+        r->cif_text = 1;
+        r->cif_pending = -1;
+        return 0;
+    }
+    s += strspn( s, " \t" );
+    if( ('\0' == *s) || ('#' == *s) ) {
+        return 0;
+    }
+
+    if( starts_with( s, "data_" ) ) {
+        if( cif_has_items( r ) ) {
+            got = finish_entry( r, e );
+        }
+        s += 5;
+        s[strcspn( s, " \t" )] = '\0';
+        start_entry( r, s );
+        r->cif_loop = 0;
+        r->cif_pending = -1;
+        return got;
+    }
+    if( starts_with( s, "loop_" ) ) {
+        r->cif_loop = 1;
+        r->cif_pending = -1;
+        return 0;
+    }
+    if( '_' == *s ) {
+        if( 1 == r->cif_loop ) {  /* a name of the loop's items */
+            return 0;
+        }
+        r->cif_loop = 0;
+        if( !r->open_entry ) {
+            start_entry( r, NULL );
+        }
+        k = cif_item( s, &value );
+        r->cif_pending = -1;
+        if( k >= 0 ) {
+            if( '\0' == value[strspn( value, " \t" )] ) {
+                r->cif_pending = k;
+            }
+            else {
+                set_cif_item( &r->entry, k, value );
+            }
+        }
+        return 0;
+    }
+
+/* a value: of a loop, or of the item on the line before */
+    if( 0 != r->cif_loop ) {
+        r->cif_loop = 2;
+    }
+    else if( r->cif_pending >= 0 ) {
+        set_cif_item( &r->entry, r->cif_pending, s );
+    }
+    r->cif_pending = -1;
+    return 0;
+}
+
+/* csv_line(): a CSV row is id,a,b,c,alpha,beta,gamma,space_group, with
+ * commas or tabs between the fields.  The first row is passed over if its
+ * cell isn't numbers, since it is then a header.  Returns 1 if there is an
+ * entry in 'e'.
+ */
+static int csv_line( struct bulk_reader *r, struct bulk_entry *e )
+{
+    char *field[8], *s = r->line, *p;
+    const char *delim;
+    double x;
+    int k, n = 0, first;
+
+    s += strspn( s, " \t" );
+    if( ('\0' == *s) || ('#' == *s) ) {
+        return 0;
+    }
+    first = 0 == r->csv_rows++;
+
+    delim = NULL != strchr( s, ',' ) ? "," : "\t";
+    for( p = s; (NULL != p) && (n < 8); n++ ) {
+         field[n] = p;
+         p = strpbrk( p, delim );
+         if( NULL != p ) {
+             *p++ = '\0';
+         }
+    }
+    for( k = 0; k < n; k++ ) {
+         field[k] = trim( field[k] );
+    }
+
+    start_entry( r, n > 0 ? field[0] : NULL );
+    if( n < 8 ) {
+        r->entry.error = "expected id,a,b,c,alpha,beta,gamma,space_group";
+        return finish_entry( r, e );
+    }
+    for( k = 0; k < 6; k++ ) {
+         if( 0 == parse_number( field[k+1], &x ) ) {
+             set_cell_item( &r->entry, k, x );
+         }
+    }
+    if( first && (ALL_CELL_ITEMS != r->entry.cell_items) ) {  /* a header */
+        r->open_entry = 0;
+        return 0;
+    }
+    set_space_group( &r->entry, field[7] );
+    return finish_entry( r, e );
+}
+
+/* bulk_open(): opens a file of entries, "-" for stdin.  Without a 'format'
+ * it is known from the file name's extension or, failing that, from its
+ * first lines.  Returns 0, or -1 if the file can't be opened.
+ */
+int bulk_open( struct bulk_reader *r, const char *filename, int format )
+{
+    const char *base, *ext;
+    size_t n;
+
+    memset( r, 0, sizeof(*r) );
+    r->cif_pending = -1;
+    if( 0 == strcmp( filename, "-" ) ) {
+        r->fp = stdin;
+        snprintf( r->base_id, sizeof(r->base_id), "stdin" );
+    }
+    else {
+        errno = 0;
+        r->fp = fopen( filename, "r" );
+        if( NULL == r->fp ) {
+            return -1;
+        }
+        base = strrchr( filename, '/' );
+        base = NULL != base ? base + 1 : filename;
+        ext = strrchr( base, '.' );
+        n = NULL != ext ? (size_t)(ext - base) : strlen( base );
+        if( n >= sizeof(r->base_id) ) {
+            n = sizeof(r->base_id) - 1;
+        }
+        memcpy( r->base_id, base, n );
+        r->base_id[n] = '\0';
+        if( (BULK_SNIFF == format) && (NULL != ext) ) {
+            if( starts_with( ext, ".pdb" ) || starts_with( ext, ".ent" ) ) {
+                format = BULK_PDB;
+            }
+            else if( starts_with( ext, ".cif" ) || starts_with( ext, ".mmcif" ) ) {
+                format = BULK_CIF;
+            }
+            else if( starts_with( ext, ".csv" ) ) {
+                format = BULK_CSV;
+            }
+        }
+    }
+    r->format = format;
+    return 0;
+}
+
+void bulk_close( struct bulk_reader *r )
+{
+    if( (NULL != r->fp) && (stdin != r->fp) ) {
+        fclose( r->fp );
+    }
+    r->fp = NULL;
+    return;
+}
+
+/* bulk_read_entry(): reads the next entry of the file into 'e'.  Returns
+ * 1, or 0 at the end of the file.
+ */
+int bulk_read_entry( struct bulk_reader *r, struct bulk_entry *e )
+{
+    int got = 0;
+
+    while( !got && (NULL != read_line( r )) ) {
+        if( BULK_SNIFF == r->format ) {
+            r->format = sniff_format( r->line );
+        }
+        switch( r->format ) {
+            case BULK_PDB:
+               got = pdb_line( r, e );
+               break;
+            case BULK_CIF:
+               got = cif_line( r, e );
+               break;
+            case BULK_CSV:
+               got = csv_line( r, e );
+               break;
+            default:
+               break;
+        }
+    }
+    if( got ) {
+        return 1;
+    }
+
+/* the end of the file: the last CIF data block, or a PDB file without a
+ * CRYST1 record
+ */
+    if( (BULK_CIF == r->format) && cif_has_items( r ) ) {
+        return finish_entry( r, e );
+    }
+    if( (BULK_PDB == r->format) && (r->open_entry || (0 == r->n_entries)) ) {
+        if( !r->open_entry ) {
+            start_entry( r, NULL );
+        }
+        r->entry.error = "no CRYST1 record";
+        return finish_entry( r, e );
+    }
+    return 0;
+}
+
+/* rhombohedral_to_hexagonal(): a cell of the R lattice on rhombohedral
+ * axes is replaced by the obverse hexagonal cell, the axes on which the
+ * point groups of the catalogue are given.
+ */
+static void rhombohedral_to_hexagonal( struct unit_cell *c )
+{
+    double cos_alpha;
+
+    if( (fabs( c->a - c->b ) > AXES_TOLERANCE * c->a) || (fabs( c->a - c->c ) > AXES_TOLERANCE * c->a) ||
+        (fabs( c->alpha - c->beta ) > ANGLE_TOLERANCE) || (fabs( c->alpha - c->gamma ) > ANGLE_TOLERANCE) ||
+        (fabs( c->alpha - 90.0 ) < ANGLE_TOLERANCE) ) {
+        return;
+    }
+    cos_alpha = cos( DEG2RAD( c->alpha ) );
+    c->c = c->a * sqrt( 3.0 + 6.0 * cos_alpha );
+    c->a = c->b = c->a * sqrt( 2.0 - 2.0 * cos_alpha );
+    c->alpha = c->beta = 90.0;
+    c->gamma = 120.0;
+    return;
+}
+
+static void error_row( char *row, const struct bulk_entry *e, const char *why )
+{
+    snprintf( row, BULK_ROW_LEN, "%s\t%s\t-\t-\t-\t-\t-\t-\t-\t-\terror: %s", e->id,
+              '\0' != e->space_group[0] ? e->space_group : "-", why );
+    return;
+}
+
+/* entry_task(): the task for an entry: the point group of its space group
+ * in the lattice symmetry of its cell.  Returns NULL, with the error row
+ * written, if there is none.
+ */
+static struct task *entry_task( char *row, const struct bulk_entry *e, const struct bulk_options *opt )
+{
+    const struct point_group *pg;
+    struct task *t;
+    char lattice, msg[MSG_BUF_SZ];
+
+    pg = space_group_point_group( e->space_group, &lattice );
+    if( NULL == pg ) {
+        error_row( row, e, "the space group symbol can't be read" );
+        return NULL;
+    }
+    t = malloc( sizeof(*t) );
+    if( NULL != t ) {
+        init_task( t );
+        t->sub = alloc_symm_group();
+    }
+    if( (NULL == t) || (NULL == t->sub) ) {
+        error_row( row, e, strerror( ENOMEM ) );
+        dealloc_task( t );
+        return NULL;
+    }
+    t->coset_decomp = coset_group_A;
+    t->algorithm_name = 'A';
+    symm_group_set_bcm( t->sub, pg->bcm, pg->order );
+    t->n_subgroup_mats = pg->order;
+    snprintf( t->sub_name, sizeof(t->sub_name), "%s", pg->key );
+    t->laue = opt->laue;
+    t->has_cell = 1;
+    t->cell = e->cell;
+    if( 'R' == lattice ) {
+        rhombohedral_to_hexagonal( &t->cell );
+    }
+
+    if( (0 != derive_supergroup( t, lattice, opt->max_obliquity )) || (NULL == t->super) ) {
+        error_row( row, e, "no lattice symmetry was found for the cell" );
+        dealloc_task( t );
+        return NULL;
+    }
+    if( 0 != validate_task( t, msg, sizeof(msg) ) ) {
+        error_row( row, e, msg );
+        dealloc_task( t );
+        return NULL;
+    }
+    return t;
+}
+
+/* screen_task(): the result row of a decomposed task.  The twin laws are
+ * the coset representatives other than the subgroup's own, less those in
+ * its class (with LAUE, the law which is the inversion), and they are
+ * counted as exact (merohedral) or pseudo-merohedral by their obliquity in
+ * the crystal's cell.  Without LAUE, the law of the coset -H is listed but
+ * not counted, so a non-centric crystal isn't merohedral on its account.
+ */
+static void screen_task( char *row, const struct bulk_entry *e, struct task *t )
+{
+    struct group_overlay sub, super;
+    struct rat_matrix inverted_trans;
+    struct twin_law_metric ranked[MAX_GROUP_OPS];
+    int class_of[MAX_HOLOHEDRY_ORDER];
+    char trans[9 * RAT_FORMAT_LEN], classes[16], pseudo[16];
+    const char *result;
+    group_mask reps, laws;
+    double min_pseudo = -1.0;
+    int i, n, n_laws, n_classes, n_exact = 0, n_lattice = 0, own = -1, inverted = -1;
+
+    overlay_init( &sub, t->sub );
+    if( 0 != overlay_transform( &sub, &t->trans ) ) {
+        error_row( row, e, strerror( errno ) );
+        overlay_release( &sub );
+        return;
+    }
+    reps = t->decomposed ? t->reps : t->coset_decomp( t->super, t->super->truth, overlay_group( &sub ) );
+    n_classes = twin_law_classes( t->super, reps, overlay_group( &sub ), t->laue, TWIN_CLASS_NORMALIZER, class_of );
+    for( i = 0; i < t->super->n; i++ ) {
+         if( mask_has( reps, i ) && (symm_group_lookup( overlay_group( &sub ), t->super->bcm[i] ) >= 0) ) {
+             own = i;
+         }
+         if( mask_has( reps, i ) &&
+             (symm_group_lookup( overlay_group( &sub ), bcm_negate( t->super->bcm[i] ) ) >= 0) ) {
+             inverted = i;
+         }
+    }
+    overlay_release( &sub );
+    laws = EMPTY_MASK;
+    for( i = 0; i < t->super->n; i++ ) {
+         if( mask_has( reps, i ) && (i != own) &&
+             ((n_classes <= 0) || (own < 0) || (class_of[i] != class_of[own])) ) {
+             laws = mask_union( laws, mask_bit( i ) );
+         }
+    }
+
+/* the laws in the crystal's cell, for their obliquity */
+    overlay_init( &super, t->super );
+    if( (0 != rat_matrix_invert( &inverted_trans, &t->trans )) ||
+        (0 != overlay_transform( &super, &inverted_trans )) ) {
+        error_row( row, e, "TRANS can't be inverted" );
+        overlay_release( &super );
+        return;
+    }
+    n_laws = rank_twin_laws( &t->cell, overlay_group( &super ), laws, ranked );
+    overlay_release( &super );
+/* the law of the coset -H, the inversion twin of a non-centric crystal,
+ * holds for any lattice and so says nothing about lattice twinning
+ */
+    for( i = 0; i < n_laws; i++ ) {
+         if( (0 == ranked[i].n_fold) || (ranked[i].op == inverted) ) {
+             continue;
+         }
+         n_lattice++;
+         if( ranked[i].obliquity <= BULK_EXACT_OBLIQUITY ) {
+             n_exact++;
+         }
+         else if( (min_pseudo < 0.0) || (ranked[i].obliquity < min_pseudo) ) {
+             min_pseudo = ranked[i].obliquity;
+         }
+    }
+
+    if( n_exact > 0 ) {
+        result = "merohedral";
+    }
+    else if( n_lattice > 0 ) {
+        result = "pseudo-merohedral";
+    }
+    else {
+        result = "none";
+    }
+    rat_matrix_format( trans, sizeof(trans), &t->trans );
+    for( i = 0; '\0' != trans[i]; i++ ) {
+         if( ' ' == trans[i] ) {
+             trans[i] = ',';
+         }
+    }
+    if( n_classes > 0 ) {
+        snprintf( classes, sizeof(classes), "%d", n_classes - 1 );
+    }
+    else {
+        snprintf( classes, sizeof(classes), "-" );
+    }
+    if( min_pseudo >= 0.0 ) {
+        snprintf( pseudo, sizeof(pseudo), "%.3f", min_pseudo );
+    }
+    else {
+        snprintf( pseudo, sizeof(pseudo), "-" );
+    }
+    n = snprintf( row, BULK_ROW_LEN, "%s\t%s\t%s\t%s\t%.3f\t%s\t%d\t%s\t%d\t%s\t%s", e->id, e->space_group,
+                  t->sub_name, t->super_name, t->lattice_obliquity, trans, n_laws, classes, n_exact, pseudo, result );
+    if( (n < 0) || (n >= BULK_ROW_LEN) ) {
+        error_row( row, e, "the result doesn't fit in a row" );
+    }
+    return;
+}
+
+/* bulk_screen(): the result rows of 'n' entries.  The decompositions are
+ * done together by decompose_tasks(), so entries with the same lattice
+ * symmetry share the batch engine.
+ */
+void bulk_screen( char (*rows)[BULK_ROW_LEN], const struct bulk_entry *e, int n, const struct bulk_options *opt )
+{
+    struct task **tasks;
+    int *entry_of;
+    int i, n_tasks = 0;
+
+    tasks = malloc( (n > 0 ? n : 1) * sizeof(*tasks) );
+    entry_of = malloc( (n > 0 ? n : 1) * sizeof(*entry_of) );
+    if( (NULL == tasks) || (NULL == entry_of) ) {
+        for( i = 0; i < n; i++ ) {
+             error_row( rows[i], &e[i], strerror( ENOMEM ) );
+        }
+        free( tasks );
+        free( entry_of );
+        return;
+    }
+
+    for( i = 0; i < n; i++ ) {
+         if( NULL != e[i].error ) {
+             error_row( rows[i], &e[i], e[i].error );
+             continue;
+         }
+         tasks[n_tasks] = entry_task( rows[i], &e[i], opt );
+         if( NULL != tasks[n_tasks] ) {
+             entry_of[n_tasks++] = i;
+         }
+    }
+    decompose_tasks( tasks, n_tasks );
+    for( i = 0; i < n_tasks; i++ ) {
+         screen_task( rows[entry_of[i]], &e[entry_of[i]], tasks[i] );
+         dealloc_task( tasks[i] );
+    }
+    free( tasks );
+    free( entry_of );
+    return;
+}
+
+#ifdef FORKEXEC
+/* screen_in_workers(): screens the 'n' entries in up to opt->n_jobs worker
+ * processes, each taking an equal stripe of them.  A worker writes its
+ * rows to a temporary file, which is read back when it has finished, so
+ * the rows stay in their input order.  A stripe whose worker can't be
+ * started is screened here.
+ */
+static void screen_in_workers( char (*rows)[BULK_ROW_LEN], const struct bulk_entry *e, int n,
+                               const struct bulk_options *opt )
+{
+    FILE *tmp[BULK_MAX_JOBS];
+    pid_t pid[BULK_MAX_JOBS];
+    int first[BULK_MAX_JOBS + 1];
+    int i, w, count, status, ok, n_jobs;
+
+    n_jobs = opt->n_jobs < n ? opt->n_jobs : n;
+    for( w = 0; w <= n_jobs; w++ ) {
+         first[w] = (int)(((long)w * n) / n_jobs);
+    }
+
+/* the workers must not write out what is buffered for stdout */
+    fflush( stdout );
+    fflush( stderr );
+    for( w = 0; w < n_jobs; w++ ) {
+         count = first[w+1] - first[w];
+         tmp[w] = tmpfile();
+         pid[w] = NULL != tmp[w] ? fork() : -1;
+         if( 0 == pid[w] ) {  /* the worker */
+             bulk_screen( rows + first[w], e + first[w], count, opt );
+             ok = ((size_t)count == fwrite( rows + first[w], BULK_ROW_LEN, (size_t)count, tmp[w] )) &&
+                  (0 == fflush( tmp[w] ));
+             _exit( ok ? EXIT_SUCCESS : EXIT_FAILURE );
+         }
+         if( pid[w] < 0 ) {
+             bulk_screen( rows + first[w], e + first[w], count, opt );
+         }
+    }
+
+    for( w = 0; w < n_jobs; w++ ) {
+         count = first[w+1] - first[w];
+         ok = 1;
+         if( pid[w] > 0 ) {
+             ok = (pid[w] == waitpid( pid[w], &status, 0 )) && WIFEXITED(status) &&
+                  (EXIT_SUCCESS == WEXITSTATUS(status));
+             if( ok ) {
+                 rewind( tmp[w] );
+                 ok = (size_t)count == fread( rows + first[w], BULK_ROW_LEN, (size_t)count, tmp[w] );
+             }
+         }
+         if( !ok ) {
+             for( i = first[w]; i < first[w+1]; i++ ) {
+                  error_row( rows[i], &e[i], "the worker process failed" );
+             }
+         }
+         if( NULL != tmp[w] ) {
+             fclose( tmp[w] );
+         }
+    }
+    return;
+}
+#endif
+
+/* screen_chunk(): screens 'n' entries and writes their rows in order */
+static void screen_chunk( FILE *out, char (*rows)[BULK_ROW_LEN], const struct bulk_entry *e, int n,
+                          const struct bulk_options *opt )
+{
+    int i;
+
+#ifdef FORKEXEC
+    if( (opt->n_jobs > 1) && (n > 1) ) {
+        screen_in_workers( rows, e, n, opt );
+    }
+    else {
+        bulk_screen( rows, e, n, opt );
+    }
+#else
+    bulk_screen( rows, e, n, opt );
+#endif
+    for( i = 0; i < n; i++ ) {
+         fprintf( out, "%s\n", rows[i] );
+    }
+    return;
+}
+
+/* default_jobs(): the number of processors, where it can be found */
+static int default_jobs( void )
+{
+#if defined(FORKEXEC) && defined(_SC_NPROCESSORS_ONLN)
+    long n = sysconf( _SC_NPROCESSORS_ONLN );
+
+    if( n > BULK_MAX_JOBS ) {
+        return BULK_MAX_JOBS;
+    }
+    return n > 1 ? (int)n : 1;
+#else
+    return 1;
+#endif
+}
+
+/* bulk_mode(): 'coset -B [-j jobs] [-t max_obliquity] [-f pdb|cif|csv] [-l]
+ * [file ...]' screens the entries of the files, or of stdin, and writes a
+ * row of results for each.  Returns 0 if everything is OK, -1 otherwise.
+ */
+int bulk_mode( FILE *out, int n_args, char **args )
+{
+    static char *from_stdin[] = { "-" };
+    struct bulk_options opt;
+    struct bulk_reader r;
+    struct bulk_entry *entries;
+    char (*rows)[BULK_ROW_LEN];
+    char *end;
+    int k, f, n = 0, chunk;
+
+    opt.n_jobs = default_jobs();
+    opt.max_obliquity = DEFAULT_MAX_OBLIQUITY;
+    opt.laue = 0;
+    opt.format = BULK_SNIFF;
+    for( k = 0; (k < n_args) && ('-' == args[k][0]) && ('\0' != args[k][1]); k++ ) {
+         if( 0 == strcmp( args[k], "-l" ) ) {
+             opt.laue = 1;
+             continue;
+         }
+         if( (0 != strcmp( args[k], "-j" )) && (0 != strcmp( args[k], "-t" )) && (0 != strcmp( args[k], "-f" )) ) {
+             fprintf( stderr, "'%s' is not an option of -B\n", args[k] );
+             return -1;
+         }
+         if( k + 1 >= n_args ) {
+             fprintf( stderr, "%s needs a value\n", args[k] );
+             return -1;
+         }
+         if( 0 == strcmp( args[k], "-j" ) ) {
+             opt.n_jobs = (int)strtol( args[++k], &end, 10 );
+             if( ('\0' != *end) || (opt.n_jobs < 1) || (opt.n_jobs > BULK_MAX_JOBS) ) {
+                 fprintf( stderr, "the number of jobs must be 1 to %d\n", BULK_MAX_JOBS );
+                 return -1;
+             }
+         }
+         else if( 0 == strcmp( args[k], "-t" ) ) {
+             opt.max_obliquity = strtod( args[++k], &end );
+             if( ('\0' != *end) || (opt.max_obliquity < 0.0) || (opt.max_obliquity >= 90.0) ) {
+                 fprintf( stderr, "'%s' is not a valid largest obliquity\n", args[k] );
+                 return -1;
+             }
+         }
+         else {
+             k++;
+             for( f = BULK_PDB; (NULL != format_names[f]) && (0 != strcmp( args[k], format_names[f] )); f++ ) {
+                  ;
+             }
+             if( NULL == format_names[f] ) {
+                 fprintf( stderr, "'%s' is not a format, which are pdb, cif and csv\n", args[k] );
+                 return -1;
+             }
+             opt.format = f;
+         }
+    }
+    if( k == n_args ) {
+        args = from_stdin;
+        n_args = 1;
+        k = 0;
+    }
+
+    chunk = opt.n_jobs * BULK_CHUNK;
+    entries = malloc( chunk * sizeof(*entries) );
+    rows = malloc( chunk * sizeof(*rows) );
+    if( (NULL == entries) || (NULL == rows) ) {
+        fprintf( stderr, "%s:%d: %s\n", __FILE__, __LINE__, strerror( ENOMEM ) );
+        free( entries );
+        free( rows );
+        return -1;
+    }
+
+    fprintf( out, "# id\tspace_group\tpoint_group\tsupergroup\tobliquity\ttrans\tlaws\tclasses\t"
+                  "exact\tmin_pseudo\tresult\n" );
+    for( ; k < n_args; k++ ) {
+         if( 0 != bulk_open( &r, args[k], opt.format ) ) {
+             memset( &entries[n], 0, sizeof(entries[n]) );
+             snprintf( entries[n].id, sizeof(entries[n].id), "%s", args[k] );
+             entries[n].error = "the file can't be opened";
+             n++;
+         }
+         else {
+             while( (n < chunk) && bulk_read_entry( &r, &entries[n] ) ) {
+                 if( ++n == chunk ) {
+                     screen_chunk( out, rows, entries, n, &opt );
+                     n = 0;
+                 }
+             }
+             bulk_close( &r );
+         }
+         if( n == chunk ) {
+             screen_chunk( out, rows, entries, n, &opt );
+             n = 0;
+         }
+    }
+    if( n > 0 ) {
+        screen_chunk( out, rows, entries, n, &opt );
+    }
+    free( entries );
+    free( rows );
+    return 0;
+}
@@ -0,0 +1,87 @@
+/* contains public interface for the bulk screening of unit cells of the
+ * Flack left coset decomposition program which uses alogorithms outlined
+ * in Acta Cryst. (1987), A43, 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef BULK_H
+#define BULK_H
+
+#include <stdio.h>
+
+#include "twin_metric.h"
+#include "point_group.h"
+
+#define BULK_ID_LEN           32
+#define BULK_LINE_LEN         1024
+#define BULK_ROW_LEN          320
+#define BULK_CHUNK            1024    /* entries per job at a time */
+#define BULK_MAX_JOBS         64
+#define BULK_EXACT_OBLIQUITY  0.01    /* degrees, twin laws within this are exact (merohedral) */
+
+enum bulk_format { BULK_SNIFF, BULK_PDB, BULK_CIF, BULK_CSV };
+
+/* one structure of an archive: its id, cell and space group symbol */
+struct bulk_entry {
+       char id[BULK_ID_LEN];
+       char space_group[MAX_SPACE_GROUP_LEN];
+       unsigned int cell_items;     /* bit k is set when cell parameter k has been read */
+       struct unit_cell cell;
+       const char *error;           /* why the entry can't be screened, or NULL */
+       };
+
+/* A streaming reader of the entries of one file: PDB CRYST1 records, the
+ * cell and symmetry items of the data blocks of a CIF (or mmCIF), or CSV
+ * rows of id,a,b,c,alpha,beta,gamma,space_group.  Only one entry is held
+ * at a time, so an archive of any size can be read.
+ */
+struct bulk_reader {
+       FILE *fp;
+       char base_id[BULK_ID_LEN];   /* the file name without directory or extension */
+       int format;
+       int line_num;
+       int n_entries;               /* read from the file so far */
+       int open_entry;              /* an entry has been started but not yet returned */
+       struct bulk_entry entry;     /* the one being read */
+       int cif_pending;             /* CIF item whose value is on the next line, or -1 */
+       int cif_loop;                /* in a CIF loop_: 1 in its item names, 2 in its values */
+       int cif_text;                /* in a CIF text field */
+       int csv_rows;                /* CSV rows seen, the first may be a header */
+       char line[BULK_LINE_LEN];
+       };
+
+/* how the entries are screened */
+struct bulk_options {
+       int n_jobs;                  /* worker processes */
+       double max_obliquity;        /* degrees, for the lattice symmetry (see lattice_symm.h) */
+       int laue;                    /* Friedel pairs are merged (see task.h) */
+       int format;                  /* enum bulk_format */
+       };
+
+/* prototypes */
+int bulk_open( struct bulk_reader *r, const char *filename, int format );
+int bulk_read_entry( struct bulk_reader *r, struct bulk_entry *e );
+void bulk_close( struct bulk_reader *r );
+void bulk_screen( char (*rows)[BULK_ROW_LEN], const struct bulk_entry *e, int n, const struct bulk_options *opt );
+int bulk_mode( FILE *out, int n_args, char **args );
+
+#endif
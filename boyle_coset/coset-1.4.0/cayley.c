@@ -0,0 +1,104 @@
+/* contains implementation for the supergroup multiplication (Cayley)
+ * table interface (cayley.h) for the Flack left coset decomposition
+ * program which uses alogorithms outlined in Acta Cryst. (1987), A43,
+ * 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifdef NEED_C89_COMPATIBILITY
+#undef _ISOC99_SOURCE
+#else
+#define _ISOC99_SOURCE
+#endif
+
+#include <stdlib.h>
+
+#include "symm_mat.h"
+#include "cayley.h"
+
+/* lookup_cayley_table(): returns the table for a supergroup id as returned
+ * by lookup_supergroup(), or NULL if there is no such supergroup.
+ */
+const struct cayley_table *lookup_cayley_table( int point_group )
+{
+    int i;
+
+    for( i = 0; i < n_cayley_tables; i++ ) {
+         if( point_group == cayley_tables[i].point_group ) {
+             return &cayley_tables[i];
+         }
+    }
+    return NULL;
+}
+
+/* match_cayley_bcm(): returns the table whose operators are exactly the
+ * 'n' encoded matrices of 'bcm', in the same order, or NULL if they are not
+ * one of the tabulated supergroups (e.g. they have been transformed).
+ */
+const struct cayley_table *match_cayley_bcm( const unsigned int *bcm, int n )
+{
+    int i, k;
+
+    for( k = 0; k < n_cayley_tables; k++ ) {
+         const struct cayley_table *t = &cayley_tables[k];
+         if( t->order != n ) {
+             continue;
+         }
+         for( i = 0; (i < n) && (t->bcm[i] == bcm[i]); i++ )
+              ;
+         if( i == n ) {
+             return t;
+         }
+    }
+    return NULL;
+}
+
+/* match_cayley_table(): as match_cayley_bcm() for the sentinel terminated
+ * array 'g'.
+ */
+const struct cayley_table *match_cayley_table( struct symm_op *g )
+{
+    int i, k;
+
+    for( k = 0; k < n_cayley_tables; k++ ) {
+         const struct cayley_table *t = &cayley_tables[k];
+         for( i = 0; (i < t->order) && (t->bcm[i] == g[i].bcm); i++ )
+              ;
+         if( (i == t->order) && (0 == g[i].bcm) ) {
+             return t;
+         }
+    }
+    return NULL;
+}
+
+/* cayley_index(): returns the position of the operator encoded by 'bcm' in
+ * the table, or -1 if it is not a member of the group.
+ */
+int cayley_index( const struct cayley_table *t, unsigned int bcm )
+{
+    int idx;
+
+    idx = t->hash[bcm % t->hash_size];
+    if( (idx < 0) || (t->bcm[idx] != bcm) ) {
+        return -1;
+    }
+    return idx;
+}
@@ -0,0 +1,66 @@
+/* contains public interface for the multiplication (Cayley) tables of the
+ * supergroups used by the Flack left coset decomposition program which
+ * uses alogorithms outlined in Acta Cryst. (1987), A43, 564-568, by
+ * H. D. Flack.
+ *
+ * The tables themselves are written at build time by the gen_cayley
+ * program (see gen_cayley.c) into cayley_tables.c.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef CAYLEY_H
+#define CAYLEY_H
+
+#include "symm_mat.h"
+
+#define MAX_HOLOHEDRY_ORDER 48
+
+/* a supergroup with its operators in the order returned by select_symm_ops(),
+ * i.e. the proper rotations followed by their inversion related partners.
+ * Operators are referred to by their position 0..order-1 in 'bcm'.
+ */
+struct cayley_table {
+       const char *name;             /* supergroup name used in the input file */
+       int point_group;              /* id returned by lookup_supergroup() */
+       int order;
+       int identity;                 /* position of the identity operator */
+       int inversion;                /* position of the inversion operator */
+       const unsigned int *bcm;      /* encoded matrix of each operator */
+       const unsigned char *mult;    /* mult[i * order + j] is the position of op(i)*op(j) */
+       const unsigned char *inverse; /* inverse[i] is the position of op(i)^-1 */
+       unsigned int hash_size;       /* BCM -> position map: */
+       const signed char *hash;      /* hash[bcm % hash_size] is a position or -1 */
+       };
+
+/* these are defined in the generated file cayley_tables.c */
+extern const struct cayley_table cayley_tables[];
+extern const int n_cayley_tables;
+
+/* prototypes */
+const struct cayley_table *lookup_cayley_table( int point_group );
+const struct cayley_table *match_cayley_bcm( const unsigned int *bcm, int n );
+const struct cayley_table *match_cayley_table( struct symm_op *g );
+int cayley_index( const struct cayley_table *t, unsigned int bcm );
+
+#define cayley_product(t, i, j) ((int)(t)->mult[(i) * (t)->order + (j)])
+
+#endif
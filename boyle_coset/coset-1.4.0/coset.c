@@ -35,6 +35,10 @@
 
 #include "symm_mat.h"
 #include "matrix.h"
+#include "bcm.h"
+#include "cayley.h"
+#include "group_mask.h"
+#include "symm_group.h"
 #include "coset.h"
 
 #ifdef USE_ELEMENT_COMPARISON  /* normally not used, we compare Bit eCoded Matrcies (bcm) */
@@ -61,73 +65,129 @@ int is_equal_matrices( double m1[3][3], double m2[3][3], int (*compare)( double,
 }
 #endif /* end of USE_ELEMENT_COMPARISON conditional compilation directive */
 
+/* The decomposition engine: the state of a decomposition is kept as group
+ * masks (see group_mask.h) over the positions of G, so eliminating a whole
+ * coset from the remaining operators of G is a single mask operation.
+ * When G is one of the tabulated supergroups (see cayley.h) the cosets are
+ * read from the build time multiplication table.  Otherwise each encoded
+ * product is looked up in G's own BCM map.  The engine works on struct
+ * symm_group (see symm_group.h), of which it reads only the bcm array and
+ * the stored facts about the group.  It never writes to G, so G can be one
+ * of the shared supergroups: the operators of G taking part are passed in
+ * as a mask, and the representatives are returned as one.
+ */
+static group_mask index_bit( const struct symm_group *G, unsigned int bcm )
+{
+   int k;
+
+   k = symm_group_lookup( G, bcm );
+   return k < 0 ? EMPTY_MASK : mask_bit( k );
+}
+
+/* coset_mask(): the positions in G of the products G[i]*H[j] for
+ * 1 <= j < n_h ('h' is the mask of those H[j] which are in G) and, if
+ * 'with_negatives' is set, of -G[i]*H[j] too.  Products which are not
+ * in G are left out.  Since a tabulated G is closed, G[i]*H[j] can only
+ * be in G if H[j] itself is.  An H[j] which can't be encoded has a
+ * product with BCM_ERROR, which is never in G.
+ */
+static group_mask coset_mask( const struct symm_group *G, int i, const struct symm_group *H, int n_h,
+                              group_mask h, int with_negatives )
+{
+   group_mask coset = EMPTY_MASK;
+   unsigned int prod;
+   int j;
+
+   if( NULL != G->table ) {
+       coset = mask_left_coset( G->table, i, h );
+       if( with_negatives ) {
+           coset |= mask_left_coset( G->table, G->table->inversion, coset );
+       }
+       return coset;
+   }
+
+   for( j = 1; j < n_h; j++ ) {
+        prod = bcm_multiply( G->bcm[i], H->bcm[j] );
+        coset |= index_bit( G, prod );
+        if( with_negatives ) {
+            coset |= index_bit( G, bcm_negate(prod) );
+        }
+   }
+   return coset;
+}
+
+/* h_mask(): the mask of H[1]..H[n_h-1] in a tabulated G.  H[0] is the
+ * identity, which Flack's algorithms skip.
+ */
+static group_mask h_mask( const struct symm_group *G, const struct symm_group *H, int n_h )
+{
+   group_mask h = EMPTY_MASK;
+   int j, k;
+
+   if( NULL == G->table ) {
+       return EMPTY_MASK;  /* not used for untabulated groups */
+   }
+   for( j = 1; j < n_h; j++ ) {
+        k = cayley_index( G->table, H->bcm[j] );
+        if( k >= 0 ) {
+            h |= mask_bit( k );
+        }
+   }
+   return h;
+}
+
 /* Here is Flack's algorithm A
  */
-void coset_decomposition_A( struct symm_op *G, struct symm_op *H )
+group_mask coset_group_A( const struct symm_group *G, group_mask g, const struct symm_group *H )
 {
-   int i, j;
-   struct symm_op *G_k;
-
-   for( i = 0;  0 != G[i].bcm; i++ ) {
-        if( True == G[i].truefalse ) {
-            for( j = 1; 0 != H[j].bcm; j++ ) {
-                 struct symm_op prod =  {False,{{0.0}},0,0,0.0,0.0,{0.0,0.0,0.0}};
-                 matrix_multiply3x3( prod.mat, G[i].mat, H[j].mat ); 
-                 prod.bcm = encode_matrix( prod.mat );
-                 for( G_k = &G[i+1]; 0 != G_k->bcm; G_k++ ) {
-                      if( prod.bcm == G_k->bcm ) {  /* bit coded matricies compared */
-                          G_k->truefalse = False;
-                      }
-                 }
-            }
+   int i;
+   group_mask remaining, h;
+
+   h = h_mask( G, H, H->n );
+   remaining = g;
+
+/* each representative eliminates the rest of its coset from G; only
+ * the elements after G[i] are eliminated.
+ */
+   for( i = 0; i < G->n; i++ ) {
+        if( mask_has( remaining, i ) ) {
+            remaining = mask_difference( remaining,
+                                         coset_mask( G, i, H, H->n, h, 0 ) & ~mask_below( i + 1 ) );
         }
    }
-   return;
+
+   return remaining;
 
 }
 
 /* Here is Flack's algorithm B
  */
-void coset_decomposition_B( struct symm_op *G, struct symm_op *H )
+group_mask coset_group_B( const struct symm_group *G, group_mask g, const struct symm_group *H )
 {
-   int i, j,
+   int i,
        centric_flag = 0,
        G_count,
        H_count;
-   struct symm_op *G_k;
+   group_mask remaining, h, lower;
 
-   G_count = count_ops( G );
-   G_count /= 2;  /* we don't need to loop over the centrically related operations */
+   G_count = G->n / 2;  /* we don't need to loop over the centrically related operations */
 
-   H_count = count_ops( H );
-   centric_flag = is_centric( H );
+   H_count = H->n;
+   centric_flag = symm_group_is_centric( H );
    if( Centric  == centric_flag ) {
        H_count /= 2;
    }
 
 /* turn off the centrically related elements of G */
-   for( i = G_count; 0 != G[i].bcm; i++ ) {
-        G[i].truefalse = False;
-   }
+   lower = mask_below( G_count );
+   remaining = mask_intersection( g, lower );
+   h = h_mask( G, H, H_count );
 
 /* now do Algorithm B (Flack, p.567) */
    for( i = 0; i < G_count; i++ ) {
-        if( True == G[i].truefalse ) {
-            for( j = 1; j < H_count; j++ ) {
-                 struct symm_op prod_pos = {False,{ {0.0} }, 0,0,0.0,0.0,{0.0,0.0,0.0}};
-                 struct symm_op prod_neg = {False,{ {0.0} }, 0,0,0.0,0.0,{0.0,0.0,0.0}};
-                 matrix_multiply3x3( prod_pos.mat, G[i].mat, H[j].mat );
-                 prod_pos.bcm = encode_matrix( prod_pos.mat );
-                 negate_matrix( prod_neg.mat, prod_pos.mat );
-                 prod_neg.bcm = encode_matrix( prod_neg.mat );
-                 for( G_k = &G[i+1]; G_k < &G[G_count]; G_k++ ) {
-                      if( (prod_pos.bcm == G_k->bcm) ||
-                          (prod_neg.bcm == G_k->bcm) ) {
-                          G_k->truefalse = False;
-                      }
-                 }
-                     
-            }
+        if( mask_has( remaining, i ) ) {
+            remaining = mask_difference( remaining,
+                                         coset_mask( G, i, H, H_count, h, 1 ) & lower & ~mask_below( i + 1 ) );
         }
    } /* end of Flack algorithm B */
 #ifdef USE_EXTENDED_B_ALGORITHM
@@ -141,25 +201,169 @@ void coset_decomposition_B( struct symm_op *G, struct symm_op *H )
  * it's centrically related pair, and mark that one true too.
  */
    if( Acentric  == centric_flag ) {
-       for( i = 0; i < G_count; i++ ) {
-            if( True == G[i].truefalse ) {
-                double neg[3][3] = { {0.0} };
-                unsigned int bcm;
-                negate_matrix( neg, G[i].mat );
-                bcm = encode_matrix( neg );
-                for( j = G_count; 0 != G[j].bcm; j++ ) {
-                     if( bcm == G[j].bcm ) {
-                         G[j].truefalse = True;
-                     }
+       group_mask partners = EMPTY_MASK;
+
+       if( NULL != G->table ) {
+           partners = mask_left_coset( G->table, G->table->inversion, remaining );
+       }
+       else {
+           for( i = 0; i < G_count; i++ ) {
+                if( mask_has( remaining, i ) ) {
+                    partners |= index_bit( G, bcm_negate(G->bcm[i]) );
                 }
-            
-            }
+           }
        }
+       remaining = mask_union( remaining, mask_difference( partners, lower ) );
    }
 #endif  /* end of USE_EXTENDED_B_ALGORITHM conditional compilation directive */
 
+   return remaining;
+
+}
+
+/* The batch engine: Flack's algorithms for up to GROUP_MASK_BITS subgroups
+ * H of one tabulated G at once.  The masks are stored on their side, i.e.
+ * lanes[k] has bit L set if the operator at position k of G is in the
+ * mask of subgroup L, so each word operation does a step of the
+ * decomposition for every subgroup.  Eliminating the coset of G[i] needs
+ * no lookups per subgroup: G[p] is in G[i]*H exactly when G[i]^-1*G[p] is
+ * in H, which is one row of the multiplication table for all the lanes.
+ */
+static void add_lanes( group_mask *lanes, group_mask m, group_mask lane )
+{
+   for( ; EMPTY_MASK != m; m &= m - 1 ) {
+        lanes[mask_lowest( m )] |= lane;
+   }
+   return;
+}
+
+static void batch_lanes( const struct symm_group *G, int algorithm_B, const group_mask *g,
+                         const struct symm_group *const *H, int n, group_mask *reps )
+{
+   const struct cayley_table *t = G->table;
+   const unsigned char *row;
+   group_mask remaining[MAX_HOLOHEDRY_ORDER], in_h[MAX_HOLOHEDRY_ORDER];
+   group_mask acentric = EMPTY_MASK, active, cut, m;
+   int i, p, L, G_count, H_count;
+
+   G_count = algorithm_B ? t->order / 2 : t->order;
+   for( p = 0; p < t->order; p++ ) {
+        remaining[p] = EMPTY_MASK;
+        in_h[p] = EMPTY_MASK;
+   }
+   for( L = 0; L < n; L++ ) {
+        H_count = H[L]->n;
+        if( algorithm_B ) {
+            if( Centric == symm_group_is_centric( H[L] ) ) {
+                H_count /= 2;
+            }
+            else {
+                acentric |= mask_bit( L );
+            }
+        }
+        add_lanes( in_h, h_mask( G, H[L], H_count ), mask_bit( L ) );
+        add_lanes( remaining, g[L] & mask_below( G_count ), mask_bit( L ) );
+   }
+
+   for( i = 0; i < G_count; i++ ) {
+        active = remaining[i];
+        if( EMPTY_MASK == active ) {
+            continue;
+        }
+        row = &t->mult[t->inverse[i] * t->order];
+        for( p = i + 1; p < G_count; p++ ) {
+             cut = in_h[row[p]];
+             if( algorithm_B ) {  /* -G[i]*H as well */
+                 cut |= in_h[row[cayley_product( t, t->inversion, p )]];
+             }
+             remaining[p] &= ~(active & cut);
+        }
+   }
+#ifdef USE_EXTENDED_B_ALGORITHM
+/* the centrically related partners, as in coset_group_B() */
+   if( algorithm_B ) {
+       for( p = G_count; p < t->order; p++ ) {
+            i = cayley_product( t, t->inversion, p );
+            if( i < G_count ) {
+                remaining[p] = acentric & remaining[i];
+            }
+       }
+   }
+#endif
+
+   for( L = 0; L < n; L++ ) {
+        reps[L] = EMPTY_MASK;
+   }
+   for( p = 0; p < t->order; p++ ) {
+        for( m = remaining[p]; EMPTY_MASK != m; m &= m - 1 ) {
+             reps[mask_lowest( m )] |= mask_bit( p );
+        }
+   }
    return;
+}
+
+/* coset_batch(): reps[L] = engine( G, g[L], H[L] ) for 0 <= L < n.  An
+ * untabulated G is done one subgroup at a time.
+ */
+static void coset_batch( int algorithm_B, const struct symm_group *G, const group_mask *g,
+                         const struct symm_group *const *H, int n, group_mask *reps )
+{
+   int L, k;
 
+   if( NULL == G->table ) {
+       for( L = 0; L < n; L++ ) {
+            reps[L] = algorithm_B ? coset_group_B( G, g[L], H[L] ) : coset_group_A( G, g[L], H[L] );
+       }
+       return;
+   }
+   for( L = 0; L < n; L += k ) {
+        k = n - L < (int)GROUP_MASK_BITS ? n - L : (int)GROUP_MASK_BITS;
+        batch_lanes( G, algorithm_B, g + L, H + L, k, reps + L );
+   }
+   return;
+}
+
+void coset_batch_A( const struct symm_group *G, const group_mask *g,
+                    const struct symm_group *const *H, int n, group_mask *reps )
+{
+   coset_batch( 0, G, g, H, n, reps );
+   return;
+}
+
+void coset_batch_B( const struct symm_group *G, const group_mask *g,
+                    const struct symm_group *const *H, int n, group_mask *reps )
+{
+   coset_batch( 1, G, g, H, n, reps );
+   return;
+}
+
+/* coset_decomposition_A() and coset_decomposition_B() run the engine on
+ * arrays of struct symm_op.  Only the hot fields are gathered, and only
+ * the truth values are written back.
+ */
+static void decompose_ops( group_mask (*engine)(const struct symm_group *, group_mask, const struct symm_group *),
+                           struct symm_op *G, struct symm_op *H )
+{
+   static struct symm_group g, h;
+
+   if( (0 != symm_group_from_ops( &g, G, 0 )) || (0 != symm_group_from_ops( &h, H, 0 )) ) {
+       fprintf( stderr, "%s:%d: group too large for the decomposition engine\n", __FILE__, __LINE__ );
+       return;
+   }
+   mask_to_truth( engine( &g, g.truth, &h ), G );
+   return;
+}
+
+void coset_decomposition_A( struct symm_op *G, struct symm_op *H )
+{
+   decompose_ops( coset_group_A, G, H );
+   return;
+}
+
+void coset_decomposition_B( struct symm_op *G, struct symm_op *H )
+{
+   decompose_ops( coset_group_B, G, H );
+   return;
 }
 
 /* function for printing out the system of representatives.
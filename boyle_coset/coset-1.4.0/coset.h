@@ -32,8 +32,15 @@
 #include <stdio.h>
 
 #include "symm_mat.h"
+#include "symm_group.h"
 
 /* prototypes */
+group_mask coset_group_A( const struct symm_group *G, group_mask g, const struct symm_group *H );
+group_mask coset_group_B( const struct symm_group *G, group_mask g, const struct symm_group *H );
+void coset_batch_A( const struct symm_group *G, const group_mask *g,
+                    const struct symm_group *const *H, int n, group_mask *reps );
+void coset_batch_B( const struct symm_group *G, const group_mask *g,
+                    const struct symm_group *const *H, int n, group_mask *reps );
 void coset_decomposition_A( struct symm_op *G, struct symm_op *H );
 void coset_decomposition_B( struct symm_op *G, struct symm_op *H );
 void output_cosets( FILE *out, struct symm_op *s, int start );
@@ -78,3 +78,19 @@ char *duppsubstr( const char *s, char *start, size_t len )
    offset = start - s;
    return dupsubstr( s, offset, len );
 } /* end duppsubstr() */
+
+
+/* strhash() -- the 32 bit FNV-1a hash of a string.  The value doesn't
+ * depend on the width of unsigned long, so hash tables written at build
+ * time are valid on every platform.
+ */
+unsigned long strhash( const char *s )
+{
+    unsigned long h = 2166136261UL;
+
+    while( '\0' != *s ) {
+           h ^= (unsigned char)*s++;
+           h = (h * 16777619UL) & 0xffffffffUL;
+    }
+    return h;
+}  /* end strhash() */
@@ -49,4 +49,7 @@ char *dupsubstr( const char *s, size_t off_set, size_t len );
  */
 
 char *duppsubstr( const char *s, char *start, size_t len );
+
+/* strhash() -- hash value of a string (32 bit FNV-1a) */
+unsigned long strhash( const char *s );
 #endif
@@ -0,0 +1,354 @@
+/* contains implementation for COSET's eigen interface (eigen.h) which is
+ * common to the eigen codes: the functions which don't depend on the
+ * numerical library, and the table of the eigen codes built into the
+ * program, one of which is chosen at run time.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#define _ISOC99_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <complex.h>
+
+#ifdef EIGEN_DLOPEN
+#include <dlfcn.h>
+#endif
+
+#ifdef NEED_C89_COMPATIBILITY
+#include "c89_util.h"
+#endif
+
+#include "eigen.h"
+#include "float_util.h"
+#include "version.h"
+
+#ifndef EIGEN_MODULE_DIR
+#define EIGEN_MODULE_DIR "/usr/local/lib/coset"
+#endif
+
+/* solve_symm_batch() and solve_non_symm_batch(): the batch solvers of the
+ * eigen code 'b', or its single matrix solvers called for each matrix if it
+ * has none.  Return 0, or the error of the first solve which failed.
+ */
+static int solve_symm_batch( const struct eigen_backend *b, double (*mat)[3][3], int n,
+                             struct real_eigen_data (*ret)[3] )
+{
+    int i, err;
+
+    if( NULL != b->symm_solve_batch ) {
+        return b->symm_solve_batch( mat, n, ret );
+    }
+    for( i = 0; i < n; i++ ) {
+         err = b->symm_solve( mat[i], ret[i] );
+         if( 0 != err ) {
+             return err;
+         }
+    }
+    return 0;
+}
+
+static int solve_non_symm_batch( const struct eigen_backend *b, double (*mat)[3][3], int n,
+                                 struct complex_eigen_data (*ret)[3] )
+{
+    int i, err;
+
+    if( NULL != b->non_symm_solve_batch ) {
+        return b->non_symm_solve_batch( mat, n, ret );
+    }
+    for( i = 0; i < n; i++ ) {
+         err = b->non_symm_solve( mat[i], ret[i] );
+         if( 0 != err ) {
+             return err;
+         }
+    }
+    return 0;
+}
+
+#ifdef EIGEN_DLOPEN
+/* with 'make EIGEN_LOAD=dlopen' the LAPACKE and GSL eigen codes are not
+ * linked into the program.  Each is built as a shared module,
+ * coset_eigen_<name>.so, linked with its numerical library, and the table
+ * below holds a stand-in for it whose solvers load the module by the first
+ * solve.  So a run which never needs a solve from them starts without
+ * loading the libraries at all.  The modules are looked for in the
+ * directory named by the EIGEN_MODULE_DIR_ENV environment variable, or
+ * else in EIGEN_MODULE_DIR.
+ */
+struct eigen_module {
+       const char *name;
+       const struct eigen_backend *backend;  /* the module's eigen code, NULL until loaded */
+       };
+
+static const struct eigen_backend *load_module( struct eigen_module *m )
+{
+    char path[FILENAME_MAX], symbol[64];
+    const char *dir;
+    void *handle;
+
+    if( NULL != m->backend ) {
+        return m->backend;
+    }
+    dir = getenv( EIGEN_MODULE_DIR_ENV );
+    if( (NULL == dir) || ('\0' == *dir) ) {
+        dir = EIGEN_MODULE_DIR;
+    }
+    snprintf( path, sizeof(path), "%s/coset_eigen_%s.so", dir, m->name );
+    snprintf( symbol, sizeof(symbol), "%s_eigen_backend", m->name );
+    handle = dlopen( path, RTLD_NOW | RTLD_LOCAL );
+    if( NULL != handle ) {
+        m->backend = (const struct eigen_backend *)dlsym( handle, symbol );
+    }
+    if( NULL == m->backend ) {
+        fprintf( stderr, "Can't load the %s eigen code: %s\n", m->name, dlerror() );
+        exit( EXIT_FAILURE );
+    }
+    return m->backend;
+}
+
+/* LAZY_EIGEN_BACKEND(): defines the stand-in NAME_eigen_backend for the
+ * eigen code in coset_eigen_NAME.so.
+ */
+#define LAZY_EIGEN_BACKEND(NAME) \
+static struct eigen_module NAME##_module = { #NAME, NULL }; \
+static int lazy_##NAME##_symm_solve( double mat[][3], struct real_eigen_data *ret ) \
+{ \
+    return load_module( &NAME##_module )->symm_solve( mat, ret ); \
+} \
+static int lazy_##NAME##_non_symm_solve( double mat[][3], struct complex_eigen_data *ret ) \
+{ \
+    return load_module( &NAME##_module )->non_symm_solve( mat, ret ); \
+} \
+static int lazy_##NAME##_symm_solve_batch( double (*mat)[3][3], int n, struct real_eigen_data (*ret)[3] ) \
+{ \
+    return solve_symm_batch( load_module( &NAME##_module ), mat, n, ret ); \
+} \
+static int lazy_##NAME##_non_symm_solve_batch( double (*mat)[3][3], int n, struct complex_eigen_data (*ret)[3] ) \
+{ \
+    return solve_non_symm_batch( load_module( &NAME##_module ), mat, n, ret ); \
+} \
+const struct eigen_backend NAME##_eigen_backend = { #NAME, lazy_##NAME##_symm_solve, \
+                                                   lazy_##NAME##_non_symm_solve, \
+                                                   lazy_##NAME##_symm_solve_batch, \
+                                                   lazy_##NAME##_non_symm_solve_batch }
+
+#ifdef HAVE_EIGEN_LAPACKE
+LAZY_EIGEN_BACKEND(lapacke);
+#endif
+#ifdef HAVE_EIGEN_GSL
+LAZY_EIGEN_BACKEND(gsl);
+#endif
+#endif  /* EIGEN_DLOPEN */
+
+/* the eigen codes built into the program.  The analytic code needs no
+ * library and is always there; the Makefile defines HAVE_EIGEN_LAPACKE and
+ * HAVE_EIGEN_GSL for the others which are built in (see EIGEN_BACKENDS),
+ * and EIGEN_DLOPEN if they are loaded on first use (see EIGEN_LOAD).
+ */
+static const struct eigen_backend *const backend_table[] = {
+       &analytic_eigen_backend,
+#ifdef HAVE_EIGEN_LAPACKE
+       &lapacke_eigen_backend,
+#endif
+#ifdef HAVE_EIGEN_GSL
+       &gsl_eigen_backend,
+#endif
+       };
+
+#define N_BACKENDS ((int)(sizeof(backend_table) / sizeof(backend_table[0])))
+
+static const struct eigen_backend *backend = NULL;
+
+static const struct eigen_backend *find_backend( const char *name )
+{
+    int i;
+
+    for( i = 0; i < N_BACKENDS; i++ ) {
+         if( 0 == strcmp( name, backend_table[i]->name ) ) {
+             return backend_table[i];
+         }
+    }
+    return NULL;
+}
+
+/* select_backend(): the eigen code named by the EIGEN_BACKEND_ENV
+ * environment variable, or else EIGEN_CODE (see version.h), or else the
+ * first one built in.  It is chosen when a solver is first called, unless
+ * set_eigen_backend() was called before.
+ */
+static const struct eigen_backend *select_backend( void )
+{
+    const char *env;
+
+    if( NULL == backend ) {
+        env = getenv( EIGEN_BACKEND_ENV );
+        if( (NULL != env) && ('\0' != *env) ) {
+            backend = find_backend( env );
+            if( NULL == backend ) {
+                fprintf( stderr, "Warning: %s=%s is not an eigen code of this program, which has:",
+                         EIGEN_BACKEND_ENV, env );
+                print_eigen_backends( stderr );
+            }
+        }
+        if( NULL == backend ) {
+            backend = find_backend( EIGEN_CODE );
+        }
+        if( NULL == backend ) {
+            backend = backend_table[0];
+        }
+    }
+    return backend;
+}
+
+/* eigen_backend(): the eigen code the solvers below use */
+const struct eigen_backend *eigen_backend( void )
+{
+    return select_backend();
+}
+
+/* eigen_backend_at(): the i'th eigen code built into the program, or NULL
+ * if there are no more.
+ */
+const struct eigen_backend *eigen_backend_at( int i )
+{
+    return (i >= 0) && (i < N_BACKENDS) ? backend_table[i] : NULL;
+}
+
+const char *eigen_backend_name( void )
+{
+    return select_backend()->name;
+}
+
+/* set_eigen_backend(): makes the solvers use the named eigen code.
+ * Returns 0, or -1 if it isn't built into the program.
+ */
+int set_eigen_backend( const char *name )
+{
+    const struct eigen_backend *b;
+
+    b = find_backend( name );
+    if( NULL == b ) {
+        return -1;
+    }
+    backend = b;
+    return 0;
+}
+
+/* print_eigen_backends(): the names of the eigen codes built in, on one line */
+void print_eigen_backends( FILE *out )
+{
+    int i;
+
+    for( i = 0; i < N_BACKENDS; i++ ) {
+         fprintf( out, " %s", backend_table[i]->name );
+    }
+    fprintf( out, "\n" );
+    return;
+}
+
+/* symm_eigen_solve():  function used for determining the eigenvalues and eigenvectors
+ * of symmetric matrices, with the selected eigen code.
+ */
+int symm_eigen_solve( double mat[][3], struct real_eigen_data *ret )
+{
+    return select_backend()->symm_solve( mat, ret );
+}
+
+/* non_symm_eigen_solve(): function used for determining the eigenvalues and eigenvectors
+ * of nonsymmetric matrices, with the selected eigen code.
+ */
+int non_symm_eigen_solve( double mat[][3], struct complex_eigen_data *ret )
+{
+    return select_backend()->non_symm_solve( mat, ret );
+}
+
+/* symm_eigen_solve_batch():  symm_eigen_solve() for the 'n' matrices
+ * mat[0..n-1].  Returns 0, or the error of the first solve which failed.
+ */
+int symm_eigen_solve_batch( double (*mat)[3][3], int n, struct real_eigen_data (*ret)[3] )
+{
+    return solve_symm_batch( select_backend(), mat, n, ret );
+}
+
+/* non_symm_eigen_solve_batch(): non_symm_eigen_solve() for the 'n'
+ * matrices mat[0..n-1].  Returns 0, or the error of the first solve which
+ * failed.
+ */
+int non_symm_eigen_solve_batch( double (*mat)[3][3], int n, struct complex_eigen_data (*ret)[3] )
+{
+    return solve_non_symm_batch( select_backend(), mat, n, ret );
+}
+
+/* is_real_eigen_value(): returns 1 if eigenvalue has no imaginary component or 0 if it does */
+int is_real_eigen_value( struct complex_eigen_data *d )
+{
+    return is_zero( (double)cimag(d->eig_value) );
+}
+
+/* convert_complex_eig_to_real_eig():  this function is a convenience function to bring complex eigen values
+ * which happen to have all zeros for the imaginary components into a struct real_eigen_data structure.
+ */
+int convert_complex_eig_to_real_eig( struct complex_eigen_data *in, struct real_eigen_data *out )
+{
+    int i;
+    int err_code = 0;
+
+    if( is_real_eigen_value( in ) ) {
+        out->eig_value = (double)creal(in->eig_value);
+    }
+    else {
+         err_code  = -1;
+    }
+    for( i = 0; i < 3; i++ ) {
+         if( is_zero( cimag( in->eig_vector[i] ) ) ) {
+             out->eig_vector[i] = (double)creal(in->eig_vector[i]);
+         }
+         else {
+             err_code--;  /* decrement the err_code when non-zero imaginary components are encountered */
+         }
+    }
+
+    return err_code; /* valid conversions return 0. Anything else is an error */
+}
+
+/* a macro for printing complex numbers see:
+ * stackoverflow.com/questions/4099433/c-complex-number-and-printf
+ *  used in the print_eigen_results() function below.
+ */
+#define printfc(f,c) (fprintf(f, "%6.2f%+6.2fi ",creal(c),cimag(c)))
+
+/* print_eigen_results() included for debugging */
+
+void print_eigen_results( FILE *out, char *desc, struct complex_eigen_data *eig, int n_dim )
+{
+    int i, j;
+    printf( "%s\n", desc );
+
+    fprintf( out, "\tEigenvalue\t\tEigenvector Components\n" );
+    for( i = 0; i < n_dim; i++ ) {
+         fprintf( out, "[%d]  %6.2f%+6.2fi: ", i, creal(eig[i].eig_value),cimag(eig[i].eig_value) );
+         for( j = 0; j < 3; j++ ) {
+              printfc(out, eig[i].eig_vector[j]);
+         }
+         fprintf( out, "\n" );
+    }
+    return;
+}
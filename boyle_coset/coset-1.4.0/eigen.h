@@ -32,7 +32,7 @@
 #include <complex.h>
 
 /* the two structs below are for storing the eigenvalues and eigenvectors
- * calculated by the third party linear algebra libraries.
+ * calculated by the eigen codes.
  */
 
 struct real_eigen_data {
@@ -65,9 +65,51 @@ int symm_eigen_solve( double mat[][3], struct real_eigen_data *ret );
  */
 int non_symm_eigen_solve( double mat[][3], struct complex_eigen_data *ret );
 
+/* symm_eigen_solve_batch() and non_symm_eigen_solve_batch(): the same for
+ * the 'n' matrices mat[0..n-1], whose results go to ret[0..n-1].
+ */
+int symm_eigen_solve_batch( double (*mat)[3][3], int n, struct real_eigen_data (*ret)[3] );
+int non_symm_eigen_solve_batch( double (*mat)[3][3], int n, struct complex_eigen_data (*ret)[3] );
+
 
 /* for printing out the raw eigenvalues and eigenvectors.  Mostly useful for debugging */
 void print_eigen_results( FILE *out, char *desc, struct complex_eigen_data *eig, int n_dim );
 
+/* an eigen code: the solvers of one numerical library.  The codes built
+ * into the program are listed in eigen.c, and the solvers above call those
+ * of the one selected.  The batch solvers may be NULL, in which case the
+ * single matrix solvers are called for each matrix.
+ */
+struct eigen_backend {
+       const char *name;
+       int (*symm_solve)( double mat[][3], struct real_eigen_data *ret );
+       int (*non_symm_solve)( double mat[][3], struct complex_eigen_data *ret );
+       int (*symm_solve_batch)( double (*mat)[3][3], int n, struct real_eigen_data (*ret)[3] );
+       int (*non_symm_solve_batch)( double (*mat)[3][3], int n, struct complex_eigen_data (*ret)[3] );
+       };
+
+/* defined in eigen_analytic.c, eigen_lapacke.c and eigen_gsl.c, or for
+ * the last two by stand-ins in eigen.c when they are loaded on first use
+ */
+extern const struct eigen_backend analytic_eigen_backend;
+extern const struct eigen_backend lapacke_eigen_backend;
+extern const struct eigen_backend gsl_eigen_backend;
+
+/* the environment variable which names the eigen code to use, unless the
+ * program sets one itself (e.g. from its command line)
+ */
+#define EIGEN_BACKEND_ENV "COSET_EIGEN"
+
+/* the environment variable which names the directory of the eigen code
+ * modules, when they are loaded on first use (see eigen.c)
+ */
+#define EIGEN_MODULE_DIR_ENV "COSET_EIGEN_DIR"
+
+const struct eigen_backend *eigen_backend( void );
+const struct eigen_backend *eigen_backend_at( int i );
+const char *eigen_backend_name( void );
+int set_eigen_backend( const char *name );
+void print_eigen_backends( FILE *out );
+
 
 #endif
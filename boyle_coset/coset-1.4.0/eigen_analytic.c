@@ -0,0 +1,232 @@
+/* contains implementation for COSET's eigen interface (eigen.h) which
+ * needs no linear algebra library.
+ *
+ * The only matrices COSET hands to the eigen solvers are those of
+ * crystallographic point symmetry operations.  Such a matrix is R = d*P,
+ * where d = det(R) is +1 or -1 and P is a proper rotation of order 1, 2,
+ * 3, 4 or 6 (in a basis which need not be orthonormal).  The eigenvalues
+ * of P are 1 and exp(+i*phi), exp(-i*phi) with cos(phi) = (tr(P) - 1)/2,
+ * and the eigenvector for each of them is a null vector of P - lambda*I,
+ * i.e. the cross product of two of its rows.  For an integral matrix the
+ * rotation axis therefore comes out as an exact integer vector.
+ *
+ * The direction of an eigenvector is only defined up to its sign.  Here
+ * the last non-zero component of the rotation axis is made positive; the
+ * LAPACK and GSL solvers give whichever sign their iterations end on.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#define _ISOC99_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <complex.h>
+
+#include "matrix.h"
+#include "eigen.h"
+#include "float_util.h"
+
+/* a matrix transformed with a fractional TRANS is only integral to within
+ * rounding, so components this much smaller than the largest one of a
+ * null vector are taken to be zero.
+ */
+#define NULL_TOLERANCE 1.0e-9
+
+static void cross( double complex c[N_DIM], const double complex a[N_DIM], const double complex b[N_DIM] )
+{
+    c[0] = a[1] * b[2] - a[2] * b[1];
+    c[1] = a[2] * b[0] - a[0] * b[2];
+    c[2] = a[0] * b[1] - a[1] * b[0];
+    return;
+}
+
+static double largest_component( const double complex v[N_DIM] )
+{
+    return MAX( cabs( v[0] ), MAX( cabs( v[1] ), cabs( v[2] ) ) );
+}
+
+/* clean_vector(): zeroes the components of 'v' which are rounding errors */
+static void clean_vector( double complex v[N_DIM] )
+{
+    double big;
+    int k;
+
+    big = largest_component( v );
+    for( k = 0; k < N_DIM; k++ ) {
+         if( fabs( creal( v[k] ) ) <= NULL_TOLERANCE * big ) {
+             v[k] = 0.0 + cimag( v[k] ) * I;
+         }
+         if( fabs( cimag( v[k] ) ) <= NULL_TOLERANCE * big ) {
+             v[k] = creal( v[k] ) + 0.0 * I;
+         }
+    }
+    return;
+}
+
+/* null_vectors(): 'dim' independent null vectors of 'a', whose null space
+ * is known to have dimension 'dim'.  With dim = 1 the rank is 2 and the
+ * largest cross product of two rows is the null vector.  With dim = 2 all
+ * rows are multiples of the largest one, r, and the null space is spanned
+ * by r x e and r x (r x e) for the unit vector e least parallel to r.
+ * With dim = 3, 'a' is zero and the unit vectors are returned.
+ */
+static void null_vectors( double complex a[N_DIM][N_DIM], int dim, double complex v[N_DIM][N_DIM] )
+{
+    static const int pairs[N_DIM][2] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+    double complex c[N_DIM], e[N_DIM] = { 0.0, 0.0, 0.0 };
+    const double complex *r;
+    int i, k;
+
+    if( 1 == dim ) {
+        for( i = 0; i < N_DIM; i++ ) {
+             cross( c, a[pairs[i][0]], a[pairs[i][1]] );
+             if( (0 == i) || (largest_component( c ) > largest_component( v[0] )) ) {
+                 for( k = 0; k < N_DIM; k++ ) {
+                      v[0][k] = c[k];
+                 }
+             }
+        }
+    }
+    else if( 2 == dim ) {
+        r = a[0];
+        for( i = 1; i < N_DIM; i++ ) {
+             if( largest_component( a[i] ) > largest_component( r ) ) {
+                 r = a[i];
+             }
+        }
+        k = 0;
+        for( i = 1; i < N_DIM; i++ ) {
+             if( cabs( r[i] ) < cabs( r[k] ) ) {
+                 k = i;
+             }
+        }
+        e[k] = 1.0;
+        cross( v[0], r, e );
+        cross( v[1], r, v[0] );
+    }
+    else {
+        for( i = 0; i < N_DIM; i++ ) {
+             for( k = 0; k < N_DIM; k++ ) {
+                  v[i][k] = i == k ? 1.0 : 0.0;
+             }
+        }
+    }
+    for( i = 0; i < dim; i++ ) {
+         clean_vector( v[i] );
+    }
+    return;
+}
+
+/* rotation_eigen(): the eigenvalues and eigenvectors of the symmetry
+ * matrix 'mat'.  The rotation axis, whose eigenvalue is det(mat), comes
+ * first.  Returns 0, or -1 if 'mat' is singular.
+ */
+static int rotation_eigen( double mat[][N_DIM], struct complex_eigen_data *ret )
+{
+    double complex a[N_DIM][N_DIM], v[N_DIM][N_DIM], lambda[N_DIM];
+    double d, c, s;
+    int i, j, k, n, dim;
+
+    d = determinant( mat );
+    if( 0.0 == d ) {
+        return -1;
+    }
+    d = d > 0.0 ? 1.0 : -1.0;
+
+/* cos(phi) of the proper rotation d*mat; it is exact for integral matrices */
+    c = (d * trace( mat ) - 1.0) / 2.0;
+    c = MAX( -1.0, c < 1.0 ? c : 1.0 );
+    s = sqrt( 1.0 - c * c );
+    lambda[0] = 1.0;
+    lambda[1] = c + s * I;
+    lambda[2] = c - s * I;
+
+/* repeated eigenvalues: the identity (phi = 0) and the 2-folds (phi = 180) */
+    for( n = 0; n < N_DIM; n += dim ) {
+         if( (0.0 == s) && (0 == n) && (1.0 == c) ) {
+             dim = 3;
+         }
+         else if( (0.0 == s) && (1 == n) ) {
+             dim = 2;
+         }
+         else {
+             dim = 1;
+         }
+         for( i = 0; i < N_DIM; i++ ) {
+              for( j = 0; j < N_DIM; j++ ) {
+                   a[i][j] = d * mat[i][j] - (i == j ? lambda[n] : 0.0);
+              }
+         }
+         null_vectors( a, dim, v );
+         for( i = 0; i < dim; i++ ) {
+              ret[n + i].eig_value = d * lambda[n + i];
+              for( k = 0; k < N_DIM; k++ ) {
+                   ret[n + i].eig_vector[k] = v[i][k];
+              }
+         }
+    }
+
+/* the last non-zero component of the axis is made positive.  The zero
+ * components are left alone so that they do not print as -0.00.
+ */
+    for( k = N_DIM - 1; (k > 0) && (0.0 == creal( ret[0].eig_vector[k] )); k-- )
+         ;
+    if( creal( ret[0].eig_vector[k] ) < 0.0 ) {
+        for( i = 0; i < N_DIM; i++ ) {
+             if( 0.0 != creal( ret[0].eig_vector[i] ) ) {
+                 ret[0].eig_vector[i] = -ret[0].eig_vector[i];
+             }
+        }
+    }
+    return 0;
+}
+
+
+/* analytic_symm_solve():  function used for determining the eigenvalues and eigenvectors
+ * of symmetric matrices.  A symmetric symmetry matrix is the identity, the
+ * inversion, a 2-fold axis or a mirror, so all of its eigenvalues are real.
+ * Returns 0, or -1 if 'mat' is not a symmetry matrix.
+ */
+static int analytic_symm_solve( double mat[][3], struct real_eigen_data *ret )
+{
+    struct complex_eigen_data eig[N_DIM];
+    int i;
+
+    if( 0 != rotation_eigen( mat, eig ) ) {
+        return -1;
+    }
+    for( i = 0; i < N_DIM; i++ ) {
+         if( 0 != convert_complex_eig_to_real_eig( &eig[i], &ret[i] ) ) {
+             return -1;
+         }
+    }
+    return 0;
+}
+
+/* analytic_non_symm_solve(): function used for determining the eigenvalues and eigenvectors
+ * of nonsymmetric matrices.  Returns 0, or -1 if 'mat' is singular.
+ */
+static int analytic_non_symm_solve( double mat[][3], struct complex_eigen_data *ret )
+{
+    return rotation_eigen( mat, ret );
+}
+
+const struct eigen_backend analytic_eigen_backend = { "analytic", analytic_symm_solve, analytic_non_symm_solve, NULL, NULL };
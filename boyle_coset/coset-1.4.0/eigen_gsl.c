@@ -74,72 +74,12 @@ static gsl_matrix *reform_matrix( double m[][3] )
 }
 
 
-/* *** Public Functions *** */
-
-/* a macro for printing complex numbers see:
- * stackoverflow.com/questions/4099433/c-complex-number-and-printf
- * used in the print_eigen_results() function below.
- */
-#define printfc(f,c) (fprintf(f, "%6.2f%+6.2fi ",creal(c),cimag(c)))
-
-/* print_eigen_results() included for debugging */
-
-void print_eigen_results( FILE *out, char *desc, struct complex_eigen_data *eig, int n_dim )
-{
-    int i, j;
-    printf( "%s\n", desc );
-
-    fprintf( out, "\tEigenvalue\t\tEigenvector Components\n" );
-    for( i = 0; i < n_dim; i++ ) {
-         fprintf( out, "[%d]  %6.2f%+6.2fi: ", i, creal(eig[i].eig_value),cimag(eig[i].eig_value) );
-         for( j = 0; j < 3; j++ ) {
-              printfc(out, eig[i].eig_vector[j]);
-         }
-         fprintf( out, "\n" );
-    }
-    return;
-}
-
-/* is_real_eigen_value(): returns 1 if eigenvalue has no imaginary component or 0 if it does */
-int is_real_eigen_value( struct complex_eigen_data *d )
-{   
-    return is_zero( (double)cimag(d->eig_value) );
-}
-
-/* convert_complex_eig_to_real_eig():  this function is a convenience function to bring complex eigen values
- * which happen to have all zeros for the imaginary components into a struct real_eigen_data structure.
- */
-int convert_complex_eig_to_real_eig( struct complex_eigen_data *in, struct real_eigen_data *out )
-{
-    int i;
-    int err_code = 0;
-
-    if( is_real_eigen_value( in ) ) {
-        out->eig_value = (double)creal(in->eig_value);
-    }
-    else {
-         err_code  = -1;
-    }
-    for( i = 0; i < 3; i++ ) {
-         if( is_zero( cimag( in->eig_vector[i] ) ) ) {
-             out->eig_vector[i] = (double)creal(in->eig_vector[i]);
-         }
-         else {
-             err_code--;  /* decrement the err_code when non-zero imaginary components are encountered */
-         }
-    }
-
-    return err_code; /* valid conversions return 0. Anything else is an error */
-}
-
-
-
-/* symm_eigen_solve():  function used for determining the eigen values and eigen vectors
+/* gsl_symm_solve():  function used for determining the eigen values and eigen vectors
  * of symmetric matrices.
  */
 
 
-int symm_eigen_solve( double mat[][3], struct real_eigen_data *ret )
+static int gsl_symm_solve( double mat[][3], struct real_eigen_data *ret )
 {
     int i, j;
     int gsl_status = GSL_SUCCESS;
@@ -194,10 +134,10 @@ int symm_eigen_solve( double mat[][3], struct real_eigen_data *ret )
 }
 
 
-/* non_symm_eigen_solve(): function used for determining the eigenvalues and eigenvectors
+/* gsl_non_symm_solve(): function used for determining the eigenvalues and eigenvectors
  * of nonsymmetric matrices.
  */
-int non_symm_eigen_solve( double mat[][3], struct complex_eigen_data *ret )
+static int gsl_non_symm_solve( double mat[][3], struct complex_eigen_data *ret )
 {
     int i, j;
     int gsl_status = GSL_SUCCESS;
@@ -253,3 +193,5 @@ int non_symm_eigen_solve( double mat[][3], struct complex_eigen_data *ret )
 
     return 0;
 }
+
+const struct eigen_backend gsl_eigen_backend = { "gsl", gsl_symm_solve, gsl_non_symm_solve, NULL, NULL };
@@ -37,155 +37,77 @@
 #include "eigen.h"
 #include "float_util.h"
 
-#define STORE_FULL_MATRIX             0
-#define STORE_UPPER_TRIANGULAR_MATRIX 1
-#define STORE_LOWER_TRIANGULAR_MATRIX 2
-
-#define N_DIM 3 
 #define LDA N_DIM
 #define LDVR N_DIM
 
-/* start with some routines which will bring the matrix forms used by COSET into a
- * form usable by LAPACKE.
- */
-
-/* fill_full_matrix(): duplicates a matrix in its entirety and returns a dynamically
- * allocated array containing the matrix's contents.
- *
- * Called by convert_3x3_matrix()
+/* The solvers call the Fortran routines dsyev_() and dgeev_() directly
+ * (through the LAPACK_dsyev() and LAPACK_dgeev() macros of lapacke.h),
+ * rather than LAPACKE_dsyev() and LAPACKE_dgeev().  In row major mode
+ * those allocate and transpose a copy of every matrix, and allocate a new
+ * work array each time.  Here the matrices are copied into one column
+ * major array, and the work array is sized by a workspace query the first
+ * time a solver is called and then kept for the rest of the run.
  */
-static double *fill_full_matrix( double mt[][N_DIM] )
-{
-    int i, j;
-    int n_row = 3;
-    int n_elements = 0;
-    double *mp = NULL;
-
-    errno = 0;
-    mp = malloc( (n_row * N_DIM) * sizeof(*mp) );
-    if( NULL == mp )
-        return NULL;
+struct lapack_workspace {
+       double a[N_DIM * LDA];      /* the matrix, column major; dsyev_() leaves the eigenvectors here */
+       double vr[N_DIM * LDVR];    /* right eigenvectors from dgeev_(), column major */
+       double *work;
+       lapack_int lwork;
+       };
 
-    n_elements = n_row * N_DIM;
-
-    /* initialize array to all 0.0 */
-    for( i = 0; i < n_elements; i++ )
-         mp[i] = 0.0;
-
-    for( i = 0; i < n_row; i++ ) {
-         for( j = 0; j < n_row; j++ ) {
-              mp[i * n_row + j] = mt[i][j];
-         }
-    }
-
-    return mp;
-}
+static struct lapack_workspace ws = { { 0.0 }, { 0.0 }, NULL, 0 };
 
-/* fill_upper_matrix(): duplicates the upper triangular part of a symmetric matrix
- * and returns a dynamically allocated array containing the matrix's contents.
- *
- * Should only be used for symmetric matrices
- *
- * Called by convert_3x3_matrix()
+/* workspace_query(): the optimal size of the work array for dsyev_() and
+ * dgeev_() on a 3x3 matrix, as LAPACKE_dsyev() and LAPACKE_dgeev() would
+ * use, or 0 if a query fails.
  */
-static double *fill_upper_matrix( double mt[][N_DIM] )
+static lapack_int workspace_query( void )
 {
-    int i, j;
-    int n_row = 3;
-    int n_elements = 0;
-    double *mp = NULL;
-
-    errno = 0;
-    mp = malloc( (n_row * N_DIM) * sizeof(*mp) );
-    if( NULL == mp )
-        return NULL;
-
-    n_elements = n_row * N_DIM;
-
-    /* initialize array to all 0.0 */
-    for( i = 0; i < n_elements; i++ )
-         mp[i] = 0.0;
-
-    for( i = 0; i < n_row; i++ ) {
-         for( j = i; j < n_row; j++ ) {
-              mp[i * n_row + j] = mt[i][j];
-         }
-    }
-
-    return mp;
+    char jobz = 'V', uplo = 'U', jobvl = 'N', jobvr = 'V';
+    lapack_int n = N_DIM, lda = LDA, ldvl = 1, ldvr = LDVR, lwork = -1, info = 0;
+    lapack_int syev_lwork, geev_lwork;
+    double w[N_DIM], wi[N_DIM], vl[1], query;
+
+    LAPACK_dsyev( &jobz, &uplo, &n, ws.a, &lda, w, &query, &lwork, &info );
+    if( 0 != info ) {
+        return 0;
+    }
+    syev_lwork = (lapack_int)query;
+    LAPACK_dgeev( &jobvl, &jobvr, &n, ws.a, &lda, w, wi, vl, &ldvl, ws.vr, &ldvr, &query, &lwork, &info );
+    if( 0 != info ) {
+        return 0;
+    }
+    geev_lwork = (lapack_int)query;
+    return syev_lwork > geev_lwork ? syev_lwork : geev_lwork;
 }
 
-/* fill_lower_matrix(): duplicates the lower triangular part of a symmetric matrix
- * and returns a dynamically allocated array containing the matrix's contents.
- *
- * Should only be used for symmetric matrices
- *
- * Called by convert_3x3_matrix()
- */
-static double *fill_lower_matrix( double mt[][N_DIM] )
-{
-    int i, j;
-    int n_row = 3;
-    int n_elements = 0;
-    double *mp = NULL;
-
-    errno = 0;
-    mp = malloc( (n_row * N_DIM) * sizeof(*mp) );
-    if( NULL == mp )
-        return NULL;
-
-    n_elements = n_row * N_DIM;
-
-    /* initialize array to all 0.0 */
-    for( i = 0; i < n_elements; i++ )
-         mp[i] = 0.0;
-
-    for( i = 0; i < n_row; i++ ) {
-         for( j = 0; j <= i ; j++ ) {
-              mp[i * n_row + j] = mt[i][j];
-         }
-    }
-
-    return mp;
-}
-/* convert_3x3_matrix():  takes a statically allocated 3x3 matrix and creates a
- * dynamically allocated array suitable for input into LAPACKE functions.  Allowed
- * values of 'flag' are specified above.
- *
- *  ** Caller should free() returned pointer **
+/* init_workspace(): allocates the work array the first time it is called.
+ * Returns 0, or -1 if it can't.
  */
-static double *convert_3x3_matrix( double m[N_DIM][N_DIM], int flag )
+static int init_workspace( void )
 {
-    double *(*f)( double [N_DIM][N_DIM] );
-
-    switch( flag ) {
-       case STORE_FULL_MATRIX:
-          f = fill_full_matrix;
-          break;
-       case STORE_UPPER_TRIANGULAR_MATRIX:
-          f = fill_upper_matrix;
-          break;
-       case STORE_LOWER_TRIANGULAR_MATRIX:
-          f = fill_lower_matrix;
-          break;
-       default:
-          fprintf( stderr, "Unrecognized switch() option: %s: %d\n", __FILE__, __LINE__ );
-          exit( EXIT_FAILURE );
-          break;
+    if( NULL == ws.work ) {
+        ws.lwork = workspace_query();
+        if( ws.lwork < 1 ) {
+            return -1;
+        }
+        errno = 0;
+        ws.work = malloc( ws.lwork * sizeof(*ws.work) );
+        if( NULL == ws.work ) {
+            return -1;
+        }
     }
-
-    return f(m);
+    return 0;
 }
-/* reform_3x3_matrix(): takes dynamically allocated array and fills a statically
- * allocated 3x3 matrix with its contents.
- */
 
-static void reform_3x3_matrix( double *arr, double m[N_DIM][N_DIM] )
+/* load_matrix(): copies a symmetry matrix into the workspace, column major */
+static void load_matrix( double m[N_DIM][N_DIM] )
 {
     int i, j;
+
     for( i = 0; i < N_DIM; i++ ) {
          for( j = 0; j < N_DIM; j++ ) {
-              m[i][j] = arr[ i * N_DIM + j];
+              ws.a[j * LDA + i] = m[i][j];
          }
     }
     return;
@@ -235,181 +157,95 @@ static void marshal_eigen_results( struct complex_eigen_data *eig, int n_dim, do
 }
 
 
-/* below are the implementations for the public functions. */
-
-/* is_real_eigen_value(): returns 1 if eigenvalue has no imaginary component or 0 if it does */
-int is_real_eigen_value( struct complex_eigen_data *d )
-{
-    return is_zero( (double)cimag(d->eig_value) );
-}
-
-/* convert_complex_eig_to_real_eig():  this function is a convenience function to bring complex eigen values
- * which happen to have all zeros for the imaginary components into a struct real_eigen_data structure.
+/* lapacke_symm_solve_batch():  function used for determining the eigenvalues and eigenvectors
+ * of 'n' symmetric matrices.  Only the upper triangle is used.
  */
-int convert_complex_eig_to_real_eig( struct complex_eigen_data *in, struct real_eigen_data *out )
+static int lapacke_symm_solve_batch( double (*mat)[N_DIM][N_DIM], int n, struct real_eigen_data (*ret)[N_DIM] )
 {
-    int i;
-    int err_code = 0;
-
-    if( is_real_eigen_value( in ) ) {
-        out->eig_value = (double)creal(in->eig_value);
-    }
-    else {
-         err_code  = -1;
-    }
-    for( i = 0; i < 3; i++ ) {
-         if( is_zero( cimag( in->eig_vector[i] ) ) ) {
-             out->eig_vector[i] = (double)creal(in->eig_vector[i]);
+    char jobz = 'V', uplo = 'U';
+    lapack_int n_dim = N_DIM, lda = LDA, info = 0;
+    double eig_values[N_DIM];
+    int k, i, j;
+
+    if( 0 != init_workspace() ) {
+        return 0 != errno ? errno : -1;
+    }
+    for( k = 0; k < n; k++ ) {
+         load_matrix( mat[k] );
+
+         /* OK, we solve for the eigenvalues and eigenvectors! */
+         LAPACK_dsyev( &jobz, &uplo, &n_dim, ws.a, &lda, eig_values, ws.work, &ws.lwork, &info );
+
+         /* if 'info' is greater than zero, then the eigen solver didn't work correctly.
+          * We crash hard if this doesn't work.
+          */
+         if( info > 0 ) {
+             fprintf( stderr, "dsyev_() failed to compute eigenvalues\n" );
+             exit( EXIT_FAILURE );
          }
-         else {
-             err_code--;  /* decrement the err_code when non-zero imaginary components are encountered */
+
+         /* the eigenvectors are the columns of 'a' */
+         for( i = 0; i < N_DIM; i++ ) {
+              ret[k][i].eig_value = eig_values[i];
+              for( j = 0; j < N_DIM; j++ ) {
+                   ret[k][i].eig_vector[j] = ws.a[i * LDA + j];
+              }
          }
     }
-
-    return err_code; /* valid conversions return 0. Anything else is an error */
+    return 0;
 }
 
-/* a macro for printing complex numbers see:
- * stackoverflow.com/questions/4099433/c-complex-number-and-printf
- *  used in the print_eigen_results() function below.
+/* lapacke_non_symm_solve_batch(): function used for determining the eigenvalues and eigenvectors
+ * of 'n' nonsymmetric matrices.  Only the right eigenvectors are calculated.
  */
-#define printfc(f,c) (fprintf(f, "%6.2f%+6.2fi ",creal(c),cimag(c)))
-
-/* print_eigen_results() included for debugging */
-
-void print_eigen_results( FILE *out, char *desc, struct complex_eigen_data *eig, int n_dim )
+static int lapacke_non_symm_solve_batch( double (*mat)[N_DIM][N_DIM], int n, struct complex_eigen_data (*ret)[N_DIM] )
 {
-    int i, j;
-    printf( "%s\n", desc );
+    char jobvl = 'N', jobvr = 'V';
+    lapack_int n_dim = N_DIM, lda = LDA, ldvl = 1, ldvr = LDVR, info = 0;
+    double wr[N_DIM], wi[N_DIM]; /* real and imaginary components of the eigenvalues */
+    double vl[1];
+    double vr[N_DIM * LDVR];     /* 'ws.vr' row major, for marshal_eigen_results() */
+    int k, i, j;
+
+    if( 0 != init_workspace() ) {
+        fprintf( stderr, "%s: %d: %s\n", __FILE__, __LINE__, errno != 0 ? strerror(errno) : "LAPACK workspace query failed." );
+        exit( EXIT_FAILURE );
+    }
+    for( k = 0; k < n; k++ ) {
+         load_matrix( mat[k] );
+         LAPACK_dgeev( &jobvl, &jobvr, &n_dim, ws.a, &lda, wr, wi, vl, &ldvl, ws.vr, &ldvr, ws.work, &ws.lwork, &info );
 
-    fprintf( out, "\tEigenvalue\t\tEigenvector Components\n" );
-    for( i = 0; i < n_dim; i++ ) {
-         fprintf( out, "[%d]  %6.2f%+6.2fi: ", i, creal(eig[i].eig_value),cimag(eig[i].eig_value) );
-         for( j = 0; j < 3; j++ ) {
-              printfc(out, eig[i].eig_vector[j]);
+         /* we crash hard if this function gives erroneous results (i.e info > 0 ) */
+         if( info > 0 ) {
+             fprintf( stderr, "dgeev_() failed to compute eigenvalues\n" );
+             exit( EXIT_FAILURE );
          }
-         fprintf( out, "\n" );
+
+         for( i = 0; i < N_DIM; i++ ) {
+              for( j = 0; j < N_DIM; j++ ) {
+                   vr[i * LDVR + j] = ws.vr[j * LDVR + i];
+              }
+         }
+         marshal_eigen_results( ret[k], N_DIM, wr, wi, vr, LDVR );
     }
-    return;
+    return 0;
 }
 
-/* symm_eigen_solve():  function used for determining the eigenvalues and eigenvectors
+/* lapacke_symm_solve():  function used for determining the eigenvalues and eigenvectors
  * of symmetric matrices.
  */
-int symm_eigen_solve( double mat[][3], struct real_eigen_data *ret )
+static int lapacke_symm_solve( double mat[][3], struct real_eigen_data *ret )
 {
-    int i, j;
-    int n = N_DIM, lda = LDA, info;
-
-    int storage_flag = STORE_UPPER_TRIANGULAR_MATRIX;
-    char lapacke_storage_flag;
-
-    double eig_values[N_DIM] = {0.0};
-    double eig_vectors[N_DIM][N_DIM] = {{0.0}};
-
-    double *a= NULL;
-
-/*  Convert the 3x3 matrix form used by COSET into a form usable
- *  by the LAPACKE functions.  Either of the macros (see above):
- *  STORE_UPPER_TRIANGULAR_MATRIX  -or-
- *  STORE_LOWER_TRIANGULAR_MATRIX
- *
- *  may be used. We choose to use the upper triangular matrix form.
- */
-    errno = 0;
-    a = convert_3x3_matrix( mat, storage_flag );
-    if( NULL == a ) {
-        return errno;
-    }
-/*  LAPACKE specific code used to solve for eigenvalues and eigenvectors
- */
-    if( STORE_UPPER_TRIANGULAR_MATRIX == storage_flag ) {
-        lapacke_storage_flag = 'U';
-    }
-    else {
-        lapacke_storage_flag = 'L';
-    }
-
-    /* OK, we solve for the eigenvalues and eigenvectors! */
-    info = LAPACKE_dsyev( LAPACK_ROW_MAJOR, 'V', lapacke_storage_flag, n, a, lda, eig_values );
-
-    /* if 'info' is greater than zero, then the eigen solver didn't work correctly.
-     * We crash hard if this doesn't work.
-     */
-    if( info > 0 ) {
-        fprintf( stderr, "LAPACKE_dsyev() failed to compute eigenvalues\n" );
-        exit( EXIT_FAILURE );
-    }    
-
-
-/*  After solution of the eigen problem, we now bring the eigenvalues and
- *  eigenvectors into a form usable by the COSET program.
- *
- *  In 'a', the eigenvectors are stored as columns.  We bring into the 
- *  static 'eig_vector' matrix and then transpose it. Only then do we
- *  copy the data into the 'ret' struct.
- */
-    reform_3x3_matrix( a, eig_vectors );
-    transpose_matrix( eig_vectors );
-
-    for( i = 0; i < 3; i++ ) {
-         ret[i].eig_value = eig_values[i];
-         for( j = 0; j < 3; j++ )
-              ret[i].eig_vector[j] = eig_vectors[i][j];
-    }
-
-/* Deallocate the dynamically allocated memory used.
- */
-    free( a );
-
-    return 0;
+    return lapacke_symm_solve_batch( (double (*)[N_DIM][N_DIM])mat, 1, (struct real_eigen_data (*)[N_DIM])ret );
 }
 
-
-/* non_symm_eigen_solve(): function used for determining the eigenvalues and eigenvectors
+/* lapacke_non_symm_solve(): function used for determining the eigenvalues and eigenvectors
  * of nonsymmetric matrices.
  */
-int non_symm_eigen_solve( double mat[][3], struct complex_eigen_data *ret )
+static int lapacke_non_symm_solve( double mat[][3], struct complex_eigen_data *ret )
 {
-    int n = N_DIM, lda = LDA, ldvr = LDVR, info = 0;
-    double wr[N_DIM] = {0.0}, /* wr, wi used for storing the real and imaginary components */
-           wi[N_DIM] = {0.0}; /* of the eigenvalues produced by dgeev() */
-    double vr[N_DIM * LDVR] = {0.0}; /* vr used for storing right eigenvectors produced by dgeev() */
-    double *a = NULL; /* the dynamically allocated array used by LAPACKE */
-
-   
-    errno = 0;
-/*  Convert the 3x3 matrix form used by COSET into a form usable
- *  by the LAPACKE function.
- */
-
-    a = convert_3x3_matrix( mat, STORE_FULL_MATRIX );
-    if( NULL == a ) {
-        fprintf( stderr, "%s: %d: %s\n", __FILE__, __LINE__, errno != 0 ? strerror(errno) : "memory allocation error." );
-        exit( EXIT_FAILURE );
-    }
-
-/*  LAPACKE specific code used to solve for eigenvalues and eigenvectors.
- *  Use LAPACKE_dgeev() function.
- * calculate only right eigenvectors
- */
-    info = LAPACKE_dgeev( LAPACK_ROW_MAJOR, 'N', 'V', n, a, lda, wr, wi, NULL, 3, vr, ldvr  );
-
-    /* we crash hard if this function gives erroneous results (i.e info > 0 ) */
-    if( info > 0 ) {
-        fprintf( stderr, "LAPACKE_dgeev() failed to compute eigenvalues\n" );
-        exit( EXIT_FAILURE );
-    }
-
-    /* marshal the eigenvalues and eigenvectors returned by dgeev() and bring them into a form usable by the 
-     * COSET program. The 'ret' variable are where the eigenvalues and eigenvectors are returned
-     * back to the calling function.
-     */
-    marshal_eigen_results( ret, n, wr, wi,  vr, ldvr );
-
-/* Deallocate the dynamically allocated memory used.
- */
-    free( a );
-
-    return 0;
+    return lapacke_non_symm_solve_batch( (double (*)[N_DIM][N_DIM])mat, 1, (struct complex_eigen_data (*)[N_DIM])ret );
 }
+
+const struct eigen_backend lapacke_eigen_backend = { "lapacke", lapacke_symm_solve, lapacke_non_symm_solve,
+                                                     lapacke_symm_solve_batch, lapacke_non_symm_solve_batch };
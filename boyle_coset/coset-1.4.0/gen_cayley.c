@@ -0,0 +1,529 @@
+/* gen_cayley.c: build time generator of the supergroup multiplication
+ * (Cayley) tables used by the Flack left coset decomposition program
+ * which uses alogorithms outlined in Acta Cryst. (1987), A43, 564-568,
+ * by H. D. Flack.
+ *
+ * The program writes the C source for the tables declared in cayley.h to
+ * stdout.  It is run by the Makefile:
+ *
+ * ./gen_cayley > cayley_tables.c
+ *
+ * For every supergroup it builds the operators in the order that
+ * select_symm_ops() has always used, then checks that they form a group
+ * (identity, closure, inverses) and that the BCM -> position map has no
+ * collisions.  If any check fails the program exits with a failure status
+ * and the build stops.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#define _ISOC99_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "symm_mat.h"
+#include "bcm.h"
+#include "cayley.h"
+#include "point_group.h"
+#include "dupstr.h"
+
+#define MAX_HASH_SIZE 8192
+#define MAX_GENERATORS 3
+
+/*** Symmetry matricies for the supergroups ***/
+
+/* numbers in comments refer to the symmetry operation list order given
+ * Flack's paper p. 567 for spacegroup P 432 (#207)
+ */
+static const int ops_432[N_SYMM_OPS_432][9] = {
+              { 1, 0, 0,   0, 1, 0,   0, 0, 1 },  /* 1 */
+              {-1, 0, 0,   0, 1, 0,   0, 0,-1 },  /* 3 */
+              {-1, 0, 0,   0,-1, 0,   0, 0, 1 },  /* 2 */
+              { 1, 0, 0,   0,-1, 0,   0, 0,-1 },  /* 4 */
+              { 0, 1, 0,   1, 0, 0,   0, 0,-1 },  /* 13 */
+              { 0,-1, 0,  -1, 0, 0,   0, 0,-1 },  /* 14 */
+              {-1, 0, 0,   0, 0, 1,   0, 1, 0 },  /* 18 */
+              {-1, 0, 0,   0, 0,-1,   0,-1, 0 },  /* 19 */
+              { 0, 0, 1,   0,-1, 0,   1, 0, 0 },  /* 22 */
+              { 0, 0,-1,   0,-1, 0,  -1, 0, 0 },  /* 24 */
+              { 0,-1, 0,   1, 0, 0,   0, 0, 1 },  /* 16 */
+              { 0, 1, 0,  -1, 0, 0,   0, 0, 1 },  /* 15 */
+              { 0, 0, 1,   1, 0, 0,   0, 1, 0 },  /* 5 */
+              { 0, 0, 1,  -1, 0, 0,   0,-1, 0 },  /* 6 */
+              { 0, 0,-1,  -1, 0, 0,   0, 1, 0 },  /* 7 */
+              { 0, 0,-1,   1, 0, 0,   0,-1, 0 },  /* 8 */
+              { 0, 1, 0,   0, 0, 1,   1, 0, 0 },  /* 9 */
+              { 0,-1, 0,   0, 0, 1,  -1, 0, 0 },  /* 10 */
+              { 0, 1, 0,   0, 0,-1,  -1, 0, 0 },  /* 11 */
+              { 0,-1, 0,   0, 0,-1,   1, 0, 0 },  /* 12 */
+              { 1, 0, 0,   0, 0, 1,   0,-1, 0 },  /* 17 */
+              { 1, 0, 0,   0, 0,-1,   0, 1, 0 },  /* 20 */
+              { 0, 0, 1,   0, 1, 0,  -1, 0, 0 },  /* 21 */
+              { 0, 0,-1,   0, 1, 0,   1, 0, 0 }   /* 23 */
+              };
+
+/* numbers in comments refer to the symmetry operation list order given
+ * Flack's paper p. 567 for spacegroup P 622 (#177)
+ */
+static const int ops_622[N_SYMM_OPS_622][9] = {
+              { 1, 0, 0,   0, 1, 0,   0, 0, 1 },  /* 1 */
+              { 0, 1, 0,   1, 0, 0,   0, 0,-1 },  /* 7 */
+              { 1, 0, 0,  -1,-1, 0,   0, 0,-1 },  /* 8 */
+              {-1,-1, 0,   0, 1, 0,   0, 0,-1 },  /* 9 */
+              {-1, 0, 0,   0,-1, 0,   0, 0, 1 },  /* 4 */
+              { 0,-1, 0,  -1, 0, 0,   0, 0,-1 },  /* 10 */
+              {-1, 0, 0,   1, 1, 0,   0, 0,-1 },  /* 11 */
+              { 1, 1, 0,   0,-1, 0,   0, 0,-1 },  /* 12 */
+              {-1,-1, 0,   1, 0, 0,   0, 0, 1 },  /* 2 */
+              { 0, 1, 0,  -1,-1, 0,   0, 0, 1 },  /* 3 */
+              { 1, 1, 0,  -1, 0, 0,   0, 0, 1 },  /* 5 */
+              { 0,-1, 0,   1, 1, 0,   0, 0, 1 }   /* 6 */
+              };
+
+/* The holoaxial point groups used for the G (super) group symmetry are
+ * given as indicies into the parent operator lists above.  The holohedry
+ * is the holoaxial group followed by the inversion related partners.
+ */
+static const int m432[N_SYMM_OPS_432] = {0,1,2,3,4,5,6,7,8,9,10,
+                                         11,12,13,14,15,16,17,18,19,20,
+                                         21,22,23};
+static const int m422[N_SYMM_OPS_422] = {0,1,2,3,4,5,10,11};
+static const int m222[N_SYMM_OPS_222] = {0,1,2,3};
+static const int m2[N_SYMM_OPS_2] = {0,1};
+static const int m1[N_SYMM_OPS_1] = {0};
+static const int m622[N_SYMM_OPS_622] = {0,1,2,3,4,5,6,7,8,9,10,11};
+static const int m32[N_SYMM_OPS_32] = {0,1,2,3,8,9};
+
+/*** Generators of the 32 point groups in their standard settings ***/
+
+/* direct space matrices as in the International Tables, i.e. the rows give
+ * x', y' and z'.  The operators with hexagonal axes are marked (hex).
+ */
+#define G_1BAR   {-1, 0, 0,   0,-1, 0,   0, 0,-1}   /* -x,-y,-z */
+#define G_2X     { 1, 0, 0,   0,-1, 0,   0, 0,-1}   /* x,-y,-z */
+#define G_2Y     {-1, 0, 0,   0, 1, 0,   0, 0,-1}   /* -x,y,-z */
+#define G_2Z     {-1, 0, 0,   0,-1, 0,   0, 0, 1}   /* -x,-y,z */
+#define G_MX     {-1, 0, 0,   0, 1, 0,   0, 0, 1}   /* -x,y,z */
+#define G_MY     { 1, 0, 0,   0,-1, 0,   0, 0, 1}   /* x,-y,z */
+#define G_MZ     { 1, 0, 0,   0, 1, 0,   0, 0,-1}   /* x,y,-z */
+#define G_4Z     { 0,-1, 0,   1, 0, 0,   0, 0, 1}   /* -y,x,z */
+#define G_4BARZ  { 0, 1, 0,  -1, 0, 0,   0, 0,-1}   /* y,-x,-z */
+#define G_3XYZ   { 0, 0, 1,   1, 0, 0,   0, 1, 0}   /* z,x,y */
+#define G_3Z     { 0,-1, 0,   1,-1, 0,   0, 0, 1}   /* -y,x-y,z (hex) */
+#define G_6Z     { 1,-1, 0,   1, 0, 0,   0, 0, 1}   /* x-y,x,z (hex) */
+#define G_2YXZ   { 0, 1, 0,   1, 0, 0,   0, 0,-1}   /* y,x,-z (hex) */
+#define G_2MYXZ  { 0,-1, 0,  -1, 0, 0,   0, 0,-1}   /* -y,-x,-z (hex) */
+#define G_MMYX   { 0,-1, 0,  -1, 0, 0,   0, 0, 1}   /* -y,-x,z (hex) */
+#define G_MYX    { 0, 1, 0,   1, 0, 0,   0, 0, 1}   /* y,x,z (hex) */
+
+struct point_group_spec {
+       const char *key;       /* see struct group_name in point_group.h */
+       const char *symbol;
+       int order;
+       const char *holohedry; /* supergroup which must contain the point group */
+       int n_gen;
+       int gen[MAX_GENERATORS][9];
+       };
+
+static const struct point_group_spec point_group_specs[] = {
+       { "1",      "1",      1,  "m-3m",  0, { {0} } },
+       { "-1",     "-1",     2,  "m-3m",  1, { G_1BAR } },
+       { "2",      "121",    2,  "m-3m",  1, { G_2Y } },
+       { "2 a",    "211",    2,  "m-3m",  1, { G_2X } },
+       { "2 b",    "121",    2,  "m-3m",  1, { G_2Y } },
+       { "2 c",    "112",    2,  "m-3m",  1, { G_2Z } },
+       { "m",      "1m1",    2,  "m-3m",  1, { G_MY } },
+       { "m a",    "m11",    2,  "m-3m",  1, { G_MX } },
+       { "m b",    "1m1",    2,  "m-3m",  1, { G_MY } },
+       { "m c",    "11m",    2,  "m-3m",  1, { G_MZ } },
+       { "2/m",    "12/m1",  4,  "m-3m",  2, { G_2Y, G_1BAR } },
+       { "2/m a",  "2/m11",  4,  "m-3m",  2, { G_2X, G_1BAR } },
+       { "2/m b",  "12/m1",  4,  "m-3m",  2, { G_2Y, G_1BAR } },
+       { "2/m c",  "112/m",  4,  "m-3m",  2, { G_2Z, G_1BAR } },
+       { "222",    "222",    4,  "m-3m",  2, { G_2Z, G_2Y } },
+       { "mm2",    "mm2",    4,  "m-3m",  2, { G_2Z, G_MX } },
+       { "2mm",    "2mm",    4,  "m-3m",  2, { G_2X, G_MY } },
+       { "m2m",    "m2m",    4,  "m-3m",  2, { G_2Y, G_MX } },
+       { "mmm",    "mmm",    8,  "m-3m",  3, { G_2Z, G_2Y, G_1BAR } },
+       { "4",      "4",      4,  "m-3m",  1, { G_4Z } },
+       { "-4",     "-4",     4,  "m-3m",  1, { G_4BARZ } },
+       { "4/m",    "4/m",    8,  "m-3m",  2, { G_4Z, G_1BAR } },
+       { "422",    "422",    8,  "m-3m",  2, { G_4Z, G_2X } },
+       { "4mm",    "4mm",    8,  "m-3m",  2, { G_4Z, G_MX } },
+       { "-42m",   "-42m",   8,  "m-3m",  2, { G_4BARZ, G_2X } },
+       { "-4m2",   "-4m2",   8,  "m-3m",  2, { G_4BARZ, G_MX } },
+       { "4/mmm",  "4/mmm",  16, "m-3m",  3, { G_4Z, G_2X, G_1BAR } },
+       { "3",      "3",      3,  "6/mmm", 1, { G_3Z } },
+       { "-3",     "-3",     6,  "6/mmm", 2, { G_3Z, G_1BAR } },
+       { "32",     "321",    6,  "6/mmm", 2, { G_3Z, G_2YXZ } },
+       { "321",    "321",    6,  "6/mmm", 2, { G_3Z, G_2YXZ } },
+       { "312",    "312",    6,  "6/mmm", 2, { G_3Z, G_2MYXZ } },
+       { "3m",     "3m1",    6,  "6/mmm", 2, { G_3Z, G_MMYX } },
+       { "3m1",    "3m1",    6,  "6/mmm", 2, { G_3Z, G_MMYX } },
+       { "31m",    "31m",    6,  "6/mmm", 2, { G_3Z, G_MYX } },
+       { "-3m",    "-3m1",   12, "6/mmm", 3, { G_3Z, G_2YXZ, G_1BAR } },
+       { "-3m1",   "-3m1",   12, "6/mmm", 3, { G_3Z, G_2YXZ, G_1BAR } },
+       { "-31m",   "-31m",   12, "6/mmm", 3, { G_3Z, G_2MYXZ, G_1BAR } },
+       { "6",      "6",      6,  "6/mmm", 1, { G_6Z } },
+       { "-6",     "-6",     6,  "6/mmm", 2, { G_3Z, G_MZ } },
+       { "6/m",    "6/m",    12, "6/mmm", 2, { G_6Z, G_1BAR } },
+       { "622",    "622",    12, "6/mmm", 2, { G_6Z, G_2YXZ } },
+       { "6mm",    "6mm",    12, "6/mmm", 2, { G_6Z, G_MMYX } },
+       { "-6m2",   "-6m2",   12, "6/mmm", 3, { G_3Z, G_MZ, G_MMYX } },
+       { "-62m",   "-62m",   12, "6/mmm", 3, { G_3Z, G_MZ, G_MYX } },
+       { "6/mmm",  "6/mmm",  24, "6/mmm", 3, { G_6Z, G_2YXZ, G_1BAR } },
+       { "23",     "23",     12, "m-3m",  3, { G_2Z, G_2Y, G_3XYZ } },
+       { "m-3",    "m-3",    24, "m-3m",  3, { G_2Z, G_3XYZ, G_1BAR } },
+       { "432",    "432",    24, "m-3m",  2, { G_4Z, G_3XYZ } },
+       { "-43m",   "-43m",   24, "m-3m",  2, { G_4BARZ, G_3XYZ } },
+       { "m-3m",   "m-3m",   48, "m-3m",  3, { G_4Z, G_3XYZ, G_1BAR } }
+       };
+
+#define N_POINT_GROUPS ((int)(sizeof(point_group_specs) / sizeof(point_group_specs[0])))
+
+struct holohedry {
+       const char *name;
+       const char *ident;   /* used to make C identifiers */
+       int point_group;
+       const int (*parent)[9];
+       const int *idx;
+       int n_idx;
+       };
+
+/* same order as the table searched by lookup_supergroup() */
+static const struct holohedry holohedries[] = {
+       { "-1",    "pg1",   1,   ops_432, m1,   N_SYMM_OPS_1 },
+       { "2/m",   "pg2",   2,   ops_432, m2,   N_SYMM_OPS_2 },
+       { "mmm",   "pg222", 222, ops_432, m222, N_SYMM_OPS_222 },
+       { "4/mmm", "pg422", 422, ops_432, m422, N_SYMM_OPS_422 },
+       { "-3m",   "pg32",  32,  ops_622, m32,  N_SYMM_OPS_32 },
+       { "6/mmm", "pg622", 622, ops_622, m622, N_SYMM_OPS_622 },
+       { "m-3m",  "pg432", 432, ops_432, m432, N_SYMM_OPS_432 }
+       };
+
+#define N_HOLOHEDRIES ((int)(sizeof(holohedries) / sizeof(holohedries[0])))
+
+/* the operators of each holohedry, kept to check the point groups against */
+static unsigned int holohedry_ops[N_HOLOHEDRIES][MAX_HOLOHEDRY_ORDER];
+static int holohedry_order[N_HOLOHEDRIES];
+
+static void fail( const struct holohedry *h, const char *msg )
+{
+    fprintf( stderr, "gen_cayley: %s: %s\n", h->name, msg );
+    exit( EXIT_FAILURE );
+}
+
+/* position of 'bcm' in 'ops', -1 if it is not there */
+static int find_op( const unsigned int *ops, int n, unsigned int bcm )
+{
+    int i;
+    for( i = 0; i < n; i++ ) {
+         if( ops[i] == bcm )
+             return i;
+    }
+    return -1;
+}
+
+/* centric_layout(): 1 if the identity is first and, if the group is
+ * centric, the first half are its proper operators and the second half
+ * their inversion related partners in the same order, which is what
+ * Flack's algorithm B expects (see coset_group_B()).  0 otherwise.
+ */
+static int centric_layout( const unsigned int *ops, int n )
+{
+    int i;
+
+    if( (n < 1) || (IDENTITY_BCM != ops[0]) )
+        return 0;
+    if( find_op( ops, n, INVERSION_BCM ) < 0 )
+        return 1;
+    if( 0 != n % 2 )
+        return 0;
+    for( i = 0; i < n / 2; i++ ) {
+         if( (bcm_determinant( ops[i] ) <= 0) || (ops[n/2 + i] != bcm_negate( ops[i] )) )
+             return 0;
+    }
+    return 1;
+}
+
+/* emit_holohedry(): builds, verifies and writes out the tables of one group.
+ * The operators are returned in 'ops'.  The size of the BCM -> position map and the position of the inversion
+ * operator are returned through 'hash_size_ret' and 'inversion_ret'.
+ */
+static void emit_holohedry( FILE *out, const struct holohedry *h, unsigned int *ops,
+                            unsigned int *hash_size_ret, int *inversion_ret )
+{
+    unsigned char mult[MAX_HOLOHEDRY_ORDER][MAX_HOLOHEDRY_ORDER];
+    unsigned char inverse[MAX_HOLOHEDRY_ORDER];
+    signed char hash[MAX_HASH_SIZE];
+    unsigned int hash_size;
+    int order, i, j, k;
+
+    order = 2 * h->n_idx;
+    if( order > MAX_HOLOHEDRY_ORDER )
+        fail( h, "too many operators" );
+
+/* the holoaxial operators followed by their inversion related partners */
+    for( i = 0; i < h->n_idx; i++ ) {
+         ops[i] = bcm_pack( h->parent[h->idx[i]] );
+         ops[h->n_idx + i] = bcm_negate( ops[i] );
+         if( !bcm_is_valid(ops[i]) || !bcm_is_valid(ops[h->n_idx + i]) )
+             fail( h, "operator cannot be encoded" );
+    }
+    for( i = 0; i < order; i++ ) {
+         if( find_op( ops, i, ops[i] ) >= 0 )
+             fail( h, "duplicated operator" );
+    }
+    if( 0 != find_op(ops, 1, IDENTITY_BCM) )
+        fail( h, "first operator is not the identity" );
+    *inversion_ret = find_op( ops, order, INVERSION_BCM );
+    if( *inversion_ret < 0 )
+        fail( h, "no inversion center" );
+    if( !centric_layout( ops, order ) )
+        fail( h, "proper operators are not followed by their inversion partners" );
+
+/* closure and inverses */
+    for( i = 0; i < order; i++ ) {
+         int inv = -1;
+         for( j = 0; j < order; j++ ) {
+              k = find_op( ops, order, bcm_multiply(ops[i], ops[j]) );
+              if( k < 0 )
+                  fail( h, "operators are not closed under multiplication" );
+              mult[i][j] = (unsigned char)k;
+              if( 0 == k )
+                  inv = j;
+         }
+         if( (inv < 0) || (ops[inv] != bcm_inverse(ops[i])) )
+             fail( h, "operator has no inverse in the group" );
+         inverse[i] = (unsigned char)inv;
+    }
+
+/* smallest modulus which maps every operator to a distinct slot */
+    for( hash_size = (unsigned int)order; hash_size < MAX_HASH_SIZE; hash_size++ ) {
+         memset( hash, -1, sizeof(hash) );
+         for( i = 0; i < order; i++ ) {
+              if( hash[ops[i] % hash_size] >= 0 )
+                  break;
+              hash[ops[i] % hash_size] = (signed char)i;
+         }
+         if( i == order )
+             break;
+    }
+    if( MAX_HASH_SIZE == hash_size )
+        fail( h, "no collision free hash size found" );
+    *hash_size_ret = hash_size;
+
+    fprintf( out, "/* %s: %d operators */\n", h->name, order );
+    fprintf( out, "static const unsigned int %s_bcm[%d] = {", h->ident, order );
+    for( i = 0; i < order; i++ )
+         fprintf( out, "%s%#07x%s", 0 == i % 8 ? "\n       " : "", ops[i], i < order - 1 ? ", " : "" );
+    fprintf( out, "\n       };\n\n" );
+
+    fprintf( out, "static const unsigned char %s_mult[%d] = {", h->ident, order * order );
+    for( i = 0; i < order; i++ ) {
+         fprintf( out, "\n       /* %2d */", i );
+         for( j = 0; j < order; j++ )
+              fprintf( out, "%s%2d%s", (j > 0 && 0 == j % 16) ? "\n              " : " ",
+                       mult[i][j], (i < order - 1 || j < order - 1) ? "," : "" );
+    }
+    fprintf( out, "\n       };\n\n" );
+
+    fprintf( out, "static const unsigned char %s_inverse[%d] = {", h->ident, order );
+    for( i = 0; i < order; i++ )
+         fprintf( out, "%s%2d%s", 0 == i % 16 ? "\n       " : " ", inverse[i], i < order - 1 ? "," : "" );
+    fprintf( out, "\n       };\n\n" );
+
+    fprintf( out, "static const signed char %s_hash[%u] = {", h->ident, hash_size );
+    for( i = 0; i < (int)hash_size; i++ )
+         fprintf( out, "%s%2d%s", 0 == i % 16 ? "\n       " : " ", hash[i], i < (int)hash_size - 1 ? "," : "" );
+    fprintf( out, "\n       };\n\n" );
+    return;
+}
+
+static void fail_point_group( const struct point_group_spec *p, const char *msg )
+{
+    fprintf( stderr, "gen_cayley: point group %s: %s\n", p->key, msg );
+    exit( EXIT_FAILURE );
+}
+
+static int find_holohedry( const char *name )
+{
+    int i;
+    for( i = 0; i < N_HOLOHEDRIES; i++ ) {
+         if( 0 == strcmp( name, holohedries[i].name ) )
+             return i;
+    }
+    return -1;
+}
+
+/* emit_point_group(): generates one point group of the catalogue from its
+ * generators and checks its order, that it is a subgroup of its holohedry
+ * and, if it is itself one of the supergroups, that it has exactly the
+ * supergroup's operators.  The operators are stored the way rmat() stores
+ * a subgroup, as the inverse transpose of the direct space matrices, and
+ * a centric group has its proper operators first (see bcm_centric_order()).
+ */
+static void emit_point_group( FILE *out, int idx )
+{
+    const struct point_group_spec *p = &point_group_specs[idx];
+    unsigned int gens[MAX_GENERATORS],
+                 ops[MAX_HOLOHEDRY_ORDER];
+    int i, n, h;
+
+    for( i = 0; i < p->n_gen; i++ ) {
+         gens[i] = bcm_transpose( bcm_inverse( bcm_pack( p->gen[i] ) ) );
+    }
+    n = bcm_closure( gens, p->n_gen, ops, MAX_HOLOHEDRY_ORDER );
+    if( n < 0 )
+        fail_point_group( p, "generators don't close" );
+    if( n != p->order )
+        fail_point_group( p, "wrong order" );
+    if( (0 != bcm_centric_order( ops, n )) || !centric_layout( ops, n ) )
+        fail_point_group( p, "proper operators are not followed by their inversion partners" );
+
+    h = find_holohedry( p->holohedry );
+    if( h < 0 )
+        fail_point_group( p, "unknown holohedry" );
+    for( i = 0; i < n; i++ ) {
+         if( find_op( holohedry_ops[h], holohedry_order[h], ops[i] ) < 0 )
+             fail_point_group( p, "not a subgroup of its holohedry" );
+    }
+    h = find_holohedry( p->key );
+    if( h >= 0 ) {
+        for( i = 0; i < n; i++ ) {
+             if( (n != holohedry_order[h]) || (find_op( holohedry_ops[h], n, ops[i] ) < 0) )
+                 fail_point_group( p, "differs from the supergroup of the same name" );
+        }
+    }
+
+    fprintf( out, "static const unsigned int point_group_%d_bcm[%d] = {", idx, n );
+    for( i = 0; i < n; i++ )
+         fprintf( out, "%s%#07x%s", 0 == i % 8 ? "\n       " : "", ops[i], i < n - 1 ? ", " : "" );
+    fprintf( out, "\n       };  /* %s */\n\n", p->key );
+    return;
+}
+
+/* emit_group_names(): writes the group name table and a collision free
+ * hash table for it.  Every point group key and every supergroup name is
+ * in the table.
+ */
+static void emit_group_names( FILE *out )
+{
+    signed char hash[MAX_HASH_SIZE];
+    unsigned int hash_size;
+    int i, h;
+
+    if( N_POINT_GROUPS > 127 ) {
+        fputs( "gen_cayley: too many group names for the hash table\n", stderr );
+        exit( EXIT_FAILURE );
+    }
+    for( i = 0; i < N_HOLOHEDRIES; i++ ) {
+         for( h = 0; (h < N_POINT_GROUPS) && (0 != strcmp( holohedries[i].name, point_group_specs[h].key )); h++ )
+              ;
+         if( h == N_POINT_GROUPS ) {
+             fprintf( stderr, "gen_cayley: supergroup %s is not in the catalogue\n", holohedries[i].name );
+             exit( EXIT_FAILURE );
+         }
+    }
+
+    for( hash_size = (unsigned int)N_POINT_GROUPS; hash_size < MAX_HASH_SIZE; hash_size++ ) {
+         memset( hash, -1, sizeof(hash) );
+         for( i = 0; i < N_POINT_GROUPS; i++ ) {
+              unsigned long slot = strhash( point_group_specs[i].key ) % hash_size;
+              if( hash[slot] >= 0 )
+                  break;
+              hash[slot] = (signed char)i;
+         }
+         if( i == N_POINT_GROUPS )
+             break;
+    }
+    if( MAX_HASH_SIZE == hash_size ) {
+        fputs( "gen_cayley: no collision free hash size found for the group names\n", stderr );
+        exit( EXIT_FAILURE );
+    }
+
+    fprintf( out, "const struct point_group point_groups[] = {\n" );
+    for( i = 0; i < N_POINT_GROUPS; i++ ) {
+         const struct point_group_spec *p = &point_group_specs[i];
+         fprintf( out, "       { \"%s\", \"%s\", %d, point_group_%d_bcm }%s\n", p->key, p->symbol,
+                  p->order, i, i < N_POINT_GROUPS - 1 ? "," : "" );
+    }
+    fprintf( out, "       };\n\n" );
+    fprintf( out, "const int n_point_groups = %d;\n\n", N_POINT_GROUPS );
+
+    fprintf( out, "const struct group_name group_names[] = {\n" );
+    for( i = 0; i < N_POINT_GROUPS; i++ ) {
+         h = find_holohedry( point_group_specs[i].key );
+         fprintf( out, "       { \"%s\", %d, %d }%s\n", point_group_specs[i].key,
+                  h >= 0 ? holohedries[h].point_group : -1, i, i < N_POINT_GROUPS - 1 ? "," : "" );
+    }
+    fprintf( out, "       };\n\n" );
+
+    fprintf( out, "const signed char group_name_hash[%u] = {", hash_size );
+    for( i = 0; i < (int)hash_size; i++ )
+         fprintf( out, "%s%2d%s", 0 == i % 16 ? "\n       " : " ", hash[i], i < (int)hash_size - 1 ? "," : "" );
+    fprintf( out, "\n       };\n\n" );
+    fprintf( out, "const unsigned int group_name_hash_size = %u;\n", hash_size );
+    return;
+}
+
+int main( void )
+{
+    FILE *out = stdout;
+    unsigned int hash_size[N_HOLOHEDRIES];
+    int inversion[N_HOLOHEDRIES];
+    int i;
+
+    fprintf( out, "/* cayley_tables.c: supergroup multiplication tables and the point group\n" );
+    fprintf( out, " * catalogue for COSET.\n" );
+    fprintf( out, " * This file was written by gen_cayley.  Do not edit it, edit gen_cayley.c\n" );
+    fprintf( out, " * instead.\n" );
+    fprintf( out, " */\n\n" );
+    fprintf( out, "#include \"cayley.h\"\n" );
+    fprintf( out, "#include \"point_group.h\"\n\n" );
+
+    for( i = 0; i < N_HOLOHEDRIES; i++ ) {
+         emit_holohedry( out, &holohedries[i], holohedry_ops[i], &hash_size[i], &inversion[i] );
+         holohedry_order[i] = 2 * holohedries[i].n_idx;
+    }
+
+    fprintf( out, "const struct cayley_table cayley_tables[] = {\n" );
+    for( i = 0; i < N_HOLOHEDRIES; i++ ) {
+         const struct holohedry *h = &holohedries[i];
+         fprintf( out, "       { \"%s\", %d, %d, 0, %d, %s_bcm, %s_mult, %s_inverse, %u, %s_hash }%s\n",
+                  h->name, h->point_group, 2 * h->n_idx, inversion[i], h->ident, h->ident, h->ident,
+                  hash_size[i], h->ident, i < N_HOLOHEDRIES - 1 ? "," : "" );
+    }
+    fprintf( out, "       };\n\n" );
+    fprintf( out, "const int n_cayley_tables = %d;\n\n", N_HOLOHEDRIES );
+
+    for( i = 0; i < N_POINT_GROUPS; i++ ) {
+         emit_point_group( out, i );
+    }
+    emit_group_names( out );
+
+    if( ferror(out) ) {
+        perror( "gen_cayley" );
+        exit( EXIT_FAILURE );
+    }
+    exit( EXIT_SUCCESS );
+}
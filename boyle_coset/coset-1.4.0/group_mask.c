@@ -0,0 +1,199 @@
+/* contains implementation for group masks (see group_mask.h) for the
+ * Flack left coset decomposition program which uses alogorithms
+ * outlined in Acta Cryst. (1987), A43, 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifdef NEED_C89_COMPATIBILITY
+#undef _ISOC99_SOURCE
+#else
+#define _ISOC99_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <limits.h>
+
+#include "symm_mat.h"
+#include "cayley.h"
+#include "group_mask.h"
+
+/* mask_order(): number of operators in the mask */
+int mask_order( group_mask m )
+{
+#if defined(__GNUC__) && !defined(NEED_C89_COMPATIBILITY)
+    return __builtin_popcountll( m );
+#else
+    int n;
+
+    for( n = 0; EMPTY_MASK != m; n++ ) {
+         m &= m - 1;   /* clear the lowest set bit */
+    }
+    return n;
+#endif
+}
+
+/* mask_lowest(): position of the first operator in the mask, or -1 if
+ * the mask is empty.
+ */
+int mask_lowest( group_mask m )
+{
+#if defined(__GNUC__) && !defined(NEED_C89_COMPATIBILITY)
+    return EMPTY_MASK == m ? -1 : __builtin_ctzll( m );
+#else
+    int i;
+
+    if( EMPTY_MASK == m ) {
+        return -1;
+    }
+    for( i = 0; !mask_has( m, i ); i++ )
+         ;
+    return i;
+#endif
+}
+
+/* mask_full(): all the operators of the supergroup */
+group_mask mask_full( const struct cayley_table *t )
+{
+    return mask_below( t->order );
+}
+
+/* mask_left_coset(): the left coset g*h of the operators in 'h' by the
+ * operator at position 'g'.  Each product is a table lookup, so the cost
+ * is one step per operator of 'h' (at most 48).
+ */
+group_mask mask_left_coset( const struct cayley_table *t, int g, group_mask h )
+{
+    group_mask coset = EMPTY_MASK;
+    int k;
+
+    while( EMPTY_MASK != h ) {
+           k = mask_lowest( h );
+           h &= h - 1;
+           coset |= mask_bit( cayley_product( t, g, k ) );
+    }
+    return coset;
+}
+
+/* mask_conjugate(): the conjugate g*h*g^-1 of the operators in 'h' by the
+ * operator at position 'g'.
+ */
+group_mask mask_conjugate( const struct cayley_table *t, int g, group_mask h )
+{
+    group_mask conj = EMPTY_MASK;
+    int k, g_inv;
+
+    g_inv = t->inverse[g];
+    while( EMPTY_MASK != h ) {
+           k = mask_lowest( h );
+           h &= h - 1;
+           conj |= mask_bit( cayley_product( t, cayley_product( t, g, k ), g_inv ) );
+    }
+    return conj;
+}
+
+/* mask_of_ops(): the mask of the operators in the sentinel terminated
+ * array 's' which are members of the supergroup.  Operators which are not
+ * in the supergroup (e.g. a subgroup transformed with a non integral
+ * matrix) are left out.
+ */
+group_mask mask_of_ops( const struct cayley_table *t, struct symm_op *s )
+{
+    group_mask m = EMPTY_MASK;
+    int i, k;
+
+    for( i = 0; 0 != s[i].bcm; i++ ) {
+         k = cayley_index( t, s[i].bcm );
+         if( k >= 0 ) {
+             m |= mask_bit( k );
+         }
+    }
+    return m;
+}
+
+/* mask_from_truth(): the mask of the operators of 's' whose truefalse
+ * member is True.  Only the first GROUP_MASK_BITS operators are looked at.
+ */
+group_mask mask_from_truth( struct symm_op *s )
+{
+    group_mask m = EMPTY_MASK;
+    int i;
+
+    for( i = 0; (0 != s[i].bcm) && (i < (int)GROUP_MASK_BITS); i++ ) {
+         if( True == s[i].truefalse ) {
+             m |= mask_bit( i );
+         }
+    }
+    return m;
+}
+
+/* mask_to_truth(): sets the truefalse member of each operator of 's'
+ * according to the mask.
+ */
+void mask_to_truth( group_mask m, struct symm_op *s )
+{
+    int i;
+
+    for( i = 0; (0 != s[i].bcm) && (i < (int)GROUP_MASK_BITS); i++ ) {
+         s[i].truefalse = mask_has( m, i ) ? True : False;
+    }
+    return;
+}
+
+/* mask_closure(): the smallest subgroup of the supergroup which contains
+ * the operators in 'm'.  Each pass multiplies every operator found so far
+ * by all the others, so the number of passes grows only with the log of
+ * the order of the result.
+ */
+group_mask mask_closure( const struct cayley_table *t, group_mask m )
+{
+    group_mask prev, rest;
+    int k;
+
+    m |= mask_bit( t->identity );
+    do {
+        prev = m;
+        for( rest = prev; EMPTY_MASK != rest; rest &= rest - 1 ) {
+             k = mask_lowest( rest );
+             m |= mask_left_coset( t, k, prev );
+        }
+    } while( m != prev );
+
+    return m;
+}
+
+/* mask_coset_representatives(): Flack's algorithm A on masks.  Returns the
+ * first operator of each left coset g*h of the subgroup 'h' in the
+ * supergroup, the identity's coset included.
+ */
+group_mask mask_coset_representatives( const struct cayley_table *t, group_mask h )
+{
+    group_mask remaining;
+    int i;
+
+    remaining = mask_full( t );
+    for( i = 0; i < t->order; i++ ) {
+         if( mask_has( remaining, i ) ) {
+             remaining = mask_difference( remaining,
+                                          mask_left_coset( t, i, h ) & ~mask_below( i + 1 ) );
+         }
+    }
+    return remaining;
+}
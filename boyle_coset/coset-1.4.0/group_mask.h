@@ -0,0 +1,69 @@
+/* contains public interface for group masks, which represent sets of
+ * operators of a supergroup, for the Flack left coset decomposition
+ * program which uses alogorithms outlined in Acta Cryst. (1987), A43,
+ * 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef GROUP_MASK_H
+#define GROUP_MASK_H
+
+#include "symm_mat.h"
+#include "cayley.h"
+
+/* A holohedry has at most 48 operators, so any set of its operators (a
+ * subgroup, a coset, or a system of representatives) fits in one word.
+ * Bit i of a mask stands for the operator at position i of the
+ * supergroup, i.e. the order of select_symm_ops() and the Cayley tables.
+ */
+#ifdef NEED_C89_COMPATIBILITY
+#include <limits.h>
+typedef unsigned long group_mask;   /* must be at least MAX_HOLOHEDRY_ORDER bits */
+#define GROUP_MASK_BITS  (CHAR_BIT * sizeof(group_mask))
+#else
+#include <stdint.h>
+typedef uint64_t group_mask;
+#define GROUP_MASK_BITS  64
+#endif
+
+#define EMPTY_MASK                 ((group_mask)0)
+#define mask_bit(i)                ((group_mask)1 << (i))
+#define mask_below(n)              (mask_bit(n) - 1)   /* positions 0..n-1 */
+#define mask_has(m, i)             (0 != ((m) & mask_bit(i)))
+#define mask_intersection(a, b)    ((a) & (b))
+#define mask_union(a, b)           ((a) | (b))
+#define mask_difference(a, b)      ((a) & ~(b))
+#define mask_is_centric(t, m)      mask_has((m), (t)->inversion)
+
+/* prototypes */
+int mask_order( group_mask m );
+int mask_lowest( group_mask m );
+group_mask mask_full( const struct cayley_table *t );
+group_mask mask_left_coset( const struct cayley_table *t, int g, group_mask h );
+group_mask mask_conjugate( const struct cayley_table *t, int g, group_mask h );
+group_mask mask_of_ops( const struct cayley_table *t, struct symm_op *s );
+group_mask mask_closure( const struct cayley_table *t, group_mask m );
+group_mask mask_coset_representatives( const struct cayley_table *t, group_mask h );
+group_mask mask_from_truth( struct symm_op *s );
+void mask_to_truth( group_mask m, struct symm_op *s );
+
+#endif
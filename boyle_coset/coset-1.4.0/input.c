@@ -48,6 +48,11 @@
 
 #include "queue.h"
 #include "symm_mat.h"
+#include "symm_group.h"
+#include "bcm.h"
+#include "cayley.h"
+#include "point_group.h"
+#include "rational.h"
 #include "task.h"
 #include "coset.h"
 #include "matrix.h"
@@ -75,8 +80,12 @@
 #define HAS_EXEC        (1 << 8)
 #define HAS_NEWINS      (1 << 9)
 #define HAS_END         (1 << 10)
-#define N_FLAGS         11
-#define ALL_FLAGS       0x7ff /* 00000111 11111111 */
+#define HAS_SWEEP       (1 << 11)
+#define HAS_GENERATORS  (1 << 12)
+#define HAS_LAUE        (1 << 13)
+#define HAS_CELL        (1 << 14)
+#define N_FLAGS         15
+#define ALL_FLAGS       0x7fff /* 01111111 11111111 */
 
 #define NEWINS_REQUIRES (HAS_INSFILE|HAS_TRANS)
 #define EXEC_REQUIRES   (HAS_TRANS|HAS_NEWINS)
@@ -90,12 +99,16 @@ static fsm *title( struct fsm *f );
 static fsm *algorithm( struct fsm *f );
 static fsm *supergroup( struct fsm *f );
 static fsm *subgroup( struct fsm *f );
+static fsm *generators( struct fsm *f );
 static fsm *rmat( struct fsm *f );
 static fsm *trans( struct fsm *f );
 static fsm *insfile( struct fsm *f );
 static fsm *outfile( struct fsm *f );
 static fsm *exec( struct fsm *f );
 static fsm *newins( struct fsm *f );
+static fsm *sweep( struct fsm *f );
+static fsm *laue( struct fsm *f );
+static fsm *cell( struct fsm *f );
 static fsm *end( struct fsm *f );
 
 /* Borrow get_line from my user_dialog utility, but just incorporate get_line()
@@ -236,12 +249,16 @@ static fsm *read_line( struct fsm *f )
            { "ALGORITHM", algorithm },
            { "SUPERGROUP", supergroup },
            { "SUBGROUP", subgroup },
+           { "GENERATORS", generators },
            { "RMAT", rmat },
            { "TRANS", trans },
            { "INSFILE", insfile },
            { "OUTFILE", outfile },
            { "EXEC", exec },
            { "NEWINS", newins },
+           { "SWEEP", sweep },
+           { "LAUE", laue },
+           { "CELL", cell },
            { "END", end },
            {  NULL, NULL }
            };
@@ -412,10 +429,10 @@ static fsm *algorithm( struct fsm *f )
 
    p[0] = toupper( p[0] );
               if( 'A' == p[0] ) {
-                  f->tsk->coset_decomp = coset_decomposition_A;
+                  f->tsk->coset_decomp = coset_group_A;
               }
               else if( 'B' == p[0] ) {
-                  f->tsk->coset_decomp = coset_decomposition_B;
+                  f->tsk->coset_decomp = coset_group_B;
               }
               else {
                  f->tsk->coset_decomp = NULL;
@@ -436,8 +453,7 @@ static fsm *supergroup( struct fsm *f )
    static const char *fmt = "%s%s";  /* format: SUPERGROUP <name> */
    char keyword[12];
    int n_scanned = 0,
-       point_group_num,
-       er;
+       point_group_num;
 
    n_scanned = sscanf(f->line, fmt, keyword, f->tsk->super_name);
    if( 2 != n_scanned ) {  
@@ -451,13 +467,13 @@ static fsm *supergroup( struct fsm *f )
   
    point_group_num = lookup_supergroup( f->tsk->super_name );
    errno = 0;
-   f->tsk->super = select_symm_ops( point_group_num, &er ); 
+   f->tsk->super = select_supergroup( point_group_num ); 
    if( NULL == f->tsk->super ) { /* error */
        int src_line = __LINE__;
        char *file = __FILE__;
        gen_error_message(f->err_msg, sizeof(f->err_msg), "%s:%d: %s", file, src_line,
-                0 != errno ? strerror(errno) : "select_symm_ops() returned NULL" );
-       f->last_err = er;
+                0 != errno ? strerror(errno) : "select_supergroup() returned NULL" );
+       f->last_err = 0 != errno ? -2 : -1;
        f->next = NULL;
        return f;
    }
@@ -468,50 +484,158 @@ static fsm *supergroup( struct fsm *f )
 }    
 
 
-static fsm *subgroup( struct fsm *f )
+/* fill_subgroup(): sets the subgroup operators from a list of 'n' encoded
+ * matrices.
+ */
+static void fill_subgroup( struct task *t, const unsigned int *ops, int n )
 {
-   static const char *fmt = "%s%s%d"; /* format: SUBGROUP <name> <number of matricies> */
-   char keyword[12];
-   int i,
-       n_scanned,
-       n_mat;
-
+   symm_group_set_bcm( t->sub, ops, n );
+   t->n_subgroup_mats = n;
+   return;
+}
 
-   n_scanned = sscanf( f->line, fmt, keyword, f->tsk->sub_name, &n_mat );
-   if( 3 != n_scanned ) {
+/* subgroup(): either 'SUBGROUP <name> <number of matricies>', which is
+ * followed by the RMAT statements, or 'SUBGROUP <name> [<setting>]',
+ * which takes the operators from the point group catalogue (point_group.h)
+ * and needs no RMAT statements.
+ */
+static fsm *subgroup( struct fsm *f )
+{
+   static const char *fmt = "%11s%15s%11s"; /* format: SUBGROUP <name> [<number of matricies> | <setting>] */
+   char keyword[12],
+        name[MAX_GROUP_KEY_LEN],
+        third[12],
+        *endp;
+   const char *setting = NULL;
+   const struct point_group *pg = NULL;
+   int n_scanned,
+       n_mat = 0;
+
+
+   n_scanned = sscanf( f->line, fmt, keyword, name, third );
+   if( 3 == n_scanned ) {
+       n_mat = (int)strtol( third, &endp, 10 );
+       if( '\0' != *endp ) {
+           setting = third;
+       }
+   }
+   if( (n_scanned < 2) || ((3 == n_scanned) && (NULL == setting) &&
+       ((n_mat < 1) || (n_mat > MAX_HOLOHEDRY_ORDER))) ) {
        gen_error_message(f->err_msg, sizeof(f->err_msg), "%s:%d: %s",
                          f->input_filename, f->line_num, "bad input line, subgroup not set" );
        f->last_err = -4;
        f->next = NULL;
        return f;
    }
+   strncpy( f->tsk->sub_name, name, GROUP_NAME_LEN - 1 );
+   f->tsk->sub_name[GROUP_NAME_LEN - 1] = '\0';
+
+/* a point group from the catalogue */
+   if( (2 == n_scanned) || (NULL != setting) ) {
+       pg = lookup_point_group( name, setting );
+       if( NULL == pg ) {
+           gen_error_message(f->err_msg, sizeof(f->err_msg), "%s:%d: unknown point group %s%s%s",
+                             f->input_filename, f->line_num, name, NULL != setting ? " " : "",
+                             NULL != setting ? setting : "" );
+           f->last_err = -4;
+           f->next = NULL;
+           return f;
+       }
+       n_mat = pg->order;
+   }
 
-   f->tsk->sub = malloc( (n_mat+1) * sizeof(*f->tsk->sub) );
+   f->tsk->sub = alloc_symm_group();
    if( NULL == f->tsk->sub ) {
        int src_line = __LINE__;
        char *file = __FILE__;
        gen_error_message(f->err_msg, sizeof(f->err_msg), "%s:%d: %s", file, src_line,
-                0 != errno ? strerror(errno) : "malloc() returned NULL" );
+                0 != errno ? strerror(errno) : "alloc_symm_group() returned NULL" );
        f->last_err = errno;
        f->next = NULL;
        return f;
    }
 
-/* zero bcm and truefalse members the struct symm_op array including the sentinel value at [n_mat] */
-   for( i = 0; i <= n_mat; i++ ) {
-        f->tsk->sub[i].bcm = 0;
-        f->tsk->sub[i].truefalse = False;
+   if( NULL != pg ) {
+       fill_subgroup( f->tsk, pg->bcm, pg->order );
+       f->rmats_read = pg->order;  /* any RMAT statements are skipped */
+       f->flags |= (HAS_SUBGROUP|HAS_RMAT);
+       f->next = read_line;
+       return f;
    }
+
+/* the subgroup is empty until the RMAT statements are read */
    f->tsk->n_subgroup_mats = n_mat;
    f->flags |= HAS_SUBGROUP;
    f->next = read_line;
    return f;
 }
 
+/* generators(): like subgroup(), but the RMAT statements which follow are
+ * only the generators of the subgroup.  The rest of the subgroup is filled
+ * in by closure once the last generator has been read (see rmat()).
+ */
+static fsm *generators( struct fsm *f )
+{
+   static const char *fmt = "%11s%15s%d"; /* format: GENERATORS <name> <number of generators> */
+   char keyword[12],
+        name[MAX_GROUP_KEY_LEN];
+   int n_scanned,
+       n_gen;
+
+   n_scanned = sscanf( f->line, fmt, keyword, name, &n_gen );
+   if( (3 != n_scanned) || (n_gen < 1) || (n_gen > MAX_HOLOHEDRY_ORDER) ) {
+       gen_error_message(f->err_msg, sizeof(f->err_msg), "%s:%d: %s",
+                         f->input_filename, f->line_num, "bad input line, generators not set" );
+       f->last_err = -4;
+       f->next = NULL;
+       return f;
+   }
+   strncpy( f->tsk->sub_name, name, GROUP_NAME_LEN - 1 );
+   f->tsk->sub_name[GROUP_NAME_LEN - 1] = '\0';
+
+   f->tsk->sub = alloc_symm_group();
+   if( NULL == f->tsk->sub ) {
+       int src_line = __LINE__;
+       char *file = __FILE__;
+       gen_error_message(f->err_msg, sizeof(f->err_msg), "%s:%d: %s", file, src_line,
+                0 != errno ? strerror(errno) : "alloc_symm_group() returned NULL" );
+       f->last_err = errno;
+       f->next = NULL;
+       return f;
+   }
+
+   f->tsk->n_subgroup_mats = n_gen;
+   f->flags |= (HAS_SUBGROUP|HAS_GENERATORS);
+   f->next = read_line;
+   return f;
+}
+
+/* close_subgroup(): replaces the generators read by rmat() with the whole
+ * subgroup, identity first and, if it is centric, the proper operators
+ * before their inversion related partners as algorithm B expects (see
+ * bcm_centric_order()).  Returns 0 if everything OK, -1 otherwise.
+ */
+static int close_subgroup( struct task *t )
+{
+   unsigned int gens[MAX_HOLOHEDRY_ORDER],
+                ops[MAX_HOLOHEDRY_ORDER];
+   int i, n;
+
+   for( i = 0; i < t->sub->n; i++ ) {
+        gens[i] = t->sub->bcm[i];
+   }
+   n = bcm_closure( gens, t->sub->n, ops, MAX_HOLOHEDRY_ORDER );
+   if( (n < 0) || (0 != bcm_centric_order( ops, n )) ) {
+       return -1;
+   }
+   fill_subgroup( t, ops, n );
+   return 0;
+}
+
 static fsm *rmat( struct fsm *f )
 {
    static const char *fmt = "%s%lf%lf%lf%lf%lf%lf%lf%lf%lf";
-   int i, j, k, n_scanned;
+   int n_scanned;
    char keyword[12];
    double mat[3][3] = { {0.0} };
    double itm[3][3] = { {0.0} }; /* inverse transpose matrix */
@@ -551,45 +675,49 @@ static fsm *rmat( struct fsm *f )
 
    
 
-/* search for first 'False' element, and read data into that one */
-   for( k = 0; k < f->tsk->n_subgroup_mats; k++ ) {
-        if( False == f->tsk->sub[k].truefalse ) {
-            break; 
-        }
-   } 
-
-/* copy the matrix */
-   for( i = 0; i < 3; i++ ) {
-        for( j = 0; j < 3; j++ ) {
-             f->tsk->sub[k].mat[i][j] = itm[i][j];
-        }
+/* add the matrix to the subgroup, which calculates its Bit enCoded Matrix */
+   if( symm_group_append( f->tsk->sub, itm ) < 0 ) {
+       gen_error_message( f->err_msg, sizeof(f->err_msg), "%s:%d: %s", f->input_filename,
+                          f->line_num, "too many RMAT statements" );
+       f->last_err = -5;
+       f->next = NULL;
+       return f;
    }
-/* mark the element 'True' so it doesn't get overwritten
- * and calculate Bit enCoded Matrix. Initialize other struct 
- * members to zero values.
- */
-   f->tsk->sub[k].truefalse = True;
-   f->tsk->sub[k].bcm = encode_matrix(f->tsk->sub[k].mat );
-   f->tsk->sub[k].n_fold = 0;
-   f->tsk->sub[k].rotation_angle = 0.0;
 
    f->rmats_read++;
 
+/* the last generator has been read, so generate the whole subgroup */
+   if( (HAS_GENERATORS & f->flags) && (f->rmats_read == f->tsk->n_subgroup_mats) ) {
+       if( 0 != close_subgroup( f->tsk ) ) {
+           gen_error_message( f->err_msg, sizeof(f->err_msg), "%s:%d: %s", f->input_filename,
+                              f->line_num, "GENERATORS don't generate a point group" );
+           f->last_err = -5;
+           f->next = NULL;
+           return f;
+       }
+       f->rmats_read = f->tsk->n_subgroup_mats;
+   }
+
    f->flags |= HAS_RMAT;
    f->next = read_line;
    return f;
 }
 
+/* trans(): the TRANS elements may be integers, fractions like 1/3, or
+ * decimals, which are snapped to the nearest small fraction (see
+ * rational.h).  The matrix is kept exactly, so transforming the groups
+ * involves no round off.
+ */
 static fsm *trans( struct fsm *f )
 {
-   static const char *fmt = "%s%lf%lf%lf%lf%lf%lf%lf%lf%lf";
+   static const char *fmt = "%11s%31s%31s%31s%31s%31s%31s%31s%31s%31s";
    char keyword[12];
-   int n_scanned;
+   char elem[9][RAT_FORMAT_LEN];
+   rat_int num[3][3], den[3][3];
+   int k, n_scanned;
 
-   n_scanned = sscanf( f->line, fmt, keyword,
-                       &f->tsk->trans_mat[0][0], &f->tsk->trans_mat[0][1], &f->tsk->trans_mat[0][2],
-                       &f->tsk->trans_mat[1][0], &f->tsk->trans_mat[1][1], &f->tsk->trans_mat[1][2],
-                       &f->tsk->trans_mat[2][0], &f->tsk->trans_mat[2][1], &f->tsk->trans_mat[2][2] );
+   n_scanned = sscanf( f->line, fmt, keyword, elem[0], elem[1], elem[2],
+                       elem[3], elem[4], elem[5], elem[6], elem[7], elem[8] );
    if( 10 != n_scanned ) {
        gen_error_message(f->err_msg, sizeof(f->err_msg), "%s:%d: %s",
                          f->input_filename, f->line_num, "bad input line for TRANS" );
@@ -597,7 +725,25 @@ static fsm *trans( struct fsm *f )
        f->next = NULL;
        return f;
    }
-   f->tsk->trans_mat_bcm = encode_matrix( f->tsk->trans_mat );
+   for( k = 0; k < 9; k++ ) {
+        if( 0 != rat_parse( elem[k], &num[k / 3][k % 3], &den[k / 3][k % 3] ) ) {
+            gen_error_message(f->err_msg, sizeof(f->err_msg), "%s:%d: TRANS element '%s' %s",
+                              f->input_filename, f->line_num, elem[k],
+                              "is not a number or a small fraction" );
+            f->last_err = -4;
+            f->next = NULL;
+            return f;
+        }
+   }
+   if( 0 != rat_matrix_set( &f->tsk->trans, num, den ) ) {
+       gen_error_message(f->err_msg, sizeof(f->err_msg), "%s:%d: %s",
+                         f->input_filename, f->line_num, "TRANS elements are too large" );
+       f->last_err = -4;
+       f->next = NULL;
+       return f;
+   }
+   rat_matrix_to_double( f->tsk->trans_mat, &f->tsk->trans );
+   f->tsk->trans_mat_bcm = rat_matrix_encode( &f->tsk->trans );
    f->flags |= HAS_TRANS;
    f->next = read_line;
    return f;
@@ -674,6 +820,13 @@ static fsm *newins( struct fsm *f )
       f->last_err = -6;
       f->next = NULL;
    }   
+   if( HAS_SWEEP & f->flags ) {
+      gen_error_message(f->err_msg, sizeof(f->err_msg), "%s:%d: %s", f->input_filename, f->line_num,
+                        "NEWINS can't be used with SWEEP" );
+      f->last_err = -6;
+      f->next = NULL;
+      return f;
+   }   
    f->tsk->new_base_name = get_filename( f->line );
    if( NULL == f->tsk->new_base_name ) {
        int src_line = __LINE__;
@@ -690,6 +843,48 @@ static fsm *newins( struct fsm *f )
    return f;
 }
 
+static fsm *sweep( struct fsm *f )
+{
+   if( HAS_NEWINS & f->flags ) {
+      gen_error_message(f->err_msg, sizeof(f->err_msg), "%s:%d: %s", f->input_filename, f->line_num,
+                        "SWEEP can't be used with NEWINS" );
+      f->last_err = -6;
+      f->next = NULL;
+      return f;
+   }   
+   f->tsk->sweep = 1;
+   f->flags |= HAS_SWEEP;
+   f->next = read_line;
+   return f;
+}
+
+static fsm *laue( struct fsm *f )
+{
+   f->tsk->laue = 1;
+   f->flags |= HAS_LAUE;
+   f->next = read_line;
+   return f;
+}
+
+/* cell(): 'CELL a b c alpha beta gamma', the crystal's cell, for ranking
+ * the twin laws.  A SHELX CELL card, with the wavelength first, may be
+ * copied as it is.
+ */
+static fsm *cell( struct fsm *f )
+{
+   if( 0 != cell_from_string( &f->tsk->cell, skip_keyword( f->line ) ) ) {
+       gen_error_message(f->err_msg, sizeof(f->err_msg), "%s:%d: %s",
+                         f->input_filename, f->line_num, "bad input line for CELL" );
+       f->last_err = -4;
+       f->next = NULL;
+       return f;
+   }
+   f->tsk->has_cell = 1;
+   f->flags |= HAS_CELL;
+   f->next = read_line;
+   return f;
+}
+
 static fsm *end( struct fsm *f )
 {
    f->next = close_file;
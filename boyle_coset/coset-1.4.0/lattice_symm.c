@@ -0,0 +1,1113 @@
+/* contains the lattice symmetry search for the Flack left coset
+ * decomposition program which uses alogorithms outlined in Acta Cryst.
+ * (1987), A43, 564-568, by H. D. Flack.  The supergroup of a task is the
+ * metric symmetry of the crystal's lattice, which is found here from the
+ * cell as by Le Page, J. Appl. Cryst. (1982), 15, 255-259: the cell is
+ * Niggli reduced (Krivy & Gruber, Acta Cryst. (1976), A32, 297-298), its
+ * twofold axes are enumerated once up to the largest obliquity wanted, and
+ * the groups made by taking them in order of obliquity give the lattice
+ * symmetry at every tolerance.  Each group is put in the conventional cell
+ * of its holohedry to give the SUPERGROUP and TRANS of a task.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifdef NEED_C89_COMPATIBILITY
+#undef _ISOC99_SOURCE
+#else
+#define _ISOC99_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef NEED_C89_COMPATIBILITY
+#include "c89_util.h"
+#endif
+
+#include "matrix.h"
+#include "float_util.h"
+#include "symm_mat.h"
+#include "cayley.h"
+#include "rational.h"
+#include "twin_metric.h"
+#include "lattice_symm.h"
+
+#define NIGGLI_EPSILON      1.0e-5   /* relative to volume^(2/3) */
+#define NIGGLI_MAX_CYCLES   1000
+#define MAX_ROTATION_ORDER  6
+#define MAX_ELEMENT         24       /* larger elements mean the axes make no finite group */
+#define OBLIQUITY_TIE       1.0e-4   /* degrees; axes this close in obliquity come in together */
+
+/* the rotations of a group generated by twofold axes, as integral matrices
+ * acting on the coordinates of the reduced cell's lattice vectors
+ */
+struct rotation_group {
+       int n;
+       int rot[MAX_LATTICE_ROTATIONS][3][3];
+       };
+
+/*** small integral vectors and matrices ***/
+
+static int dot3( const int a[3], const int b[3] )
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static int det_rows( const int a[3], const int b[3], const int c[3] )
+{
+    return a[0] * (b[1] * c[2] - b[2] * c[1]) - a[1] * (b[0] * c[2] - b[2] * c[0])
+         + a[2] * (b[0] * c[1] - b[1] * c[0]);
+}
+
+static double metric_dot( double g[3][3], const int u[3], const int v[3] )
+{
+    double sum = 0.0;
+    int i, j;
+
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              sum += u[i] * g[i][j] * v[j];
+         }
+    }
+    return sum;
+}
+
+static int gcd( int a, int b )
+{
+    int t;
+
+    a = abs( a );
+    b = abs( b );
+    while( 0 != b ) {
+        t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* make_primitive(): divides 'v' by the gcd of its components and makes its
+ * first nonzero component positive.  Returns 0, or -1 if 'v' is zero.
+ */
+static int make_primitive( int v[3] )
+{
+    int d, i;
+
+    d = gcd( gcd( v[0], v[1] ), v[2] );
+    if( 0 == d ) {
+        return -1;
+    }
+    for( i = 0; 0 == v[i]; i++ )
+         ;
+    if( v[i] < 0 ) {
+        d = -d;
+    }
+    for( i = 0; i < 3; i++ ) {
+         v[i] /= d;
+    }
+    return 0;
+}
+
+static void negate3( int v[3] )
+{
+    v[0] = -v[0];
+    v[1] = -v[1];
+    v[2] = -v[2];
+    return;
+}
+
+static void imat_identity( int m[3][3] )
+{
+    int i, j;
+
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              m[i][j] = i == j;
+         }
+    }
+    return;
+}
+
+static int imat_equal( int a[3][3], int b[3][3] )
+{
+    int i, j;
+
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              if( a[i][j] != b[i][j] ) {
+                  return 0;
+              }
+         }
+    }
+    return 1;
+}
+
+static int imat_is_identity( int m[3][3] )
+{
+    int id[3][3];
+
+    imat_identity( id );
+    return imat_equal( m, id );
+}
+
+static void imat_multiply( int ab[3][3], int a[3][3], int b[3][3] )
+{
+    int t[3][3], i, j;
+
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              t[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j];
+         }
+    }
+    memcpy( ab, t, sizeof(t) );
+    return;
+}
+
+/* imat_apply(): mv = m * v, with 'v' a column */
+static void imat_apply( int mv[3], int m[3][3], const int v[3] )
+{
+    int t[3], i;
+
+    for( i = 0; i < 3; i++ ) {
+         t[i] = m[i][0] * v[0] + m[i][1] * v[1] + m[i][2] * v[2];
+    }
+    memcpy( mv, t, sizeof(t) );
+    return;
+}
+
+/* imat_adjugate(): the adjugate of 'm', its inverse if det(m) = 1 */
+static void imat_adjugate( int adj[3][3], int m[3][3] )
+{
+    int i, j;
+
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              adj[j][i] = m[(i+1)%3][(j+1)%3] * m[(i+2)%3][(j+2)%3]
+                        - m[(i+1)%3][(j+2)%3] * m[(i+2)%3][(j+1)%3];
+         }
+    }
+    return;
+}
+
+static int imat_max_element( int m[3][3] )
+{
+    int i, j, most = 0;
+
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              most = abs( m[i][j] ) > most ? abs( m[i][j] ) : most;
+         }
+    }
+    return most;
+}
+
+/* rotation_order(): the order of the rotation 'r', or 0 if it is larger
+ * than MAX_ROTATION_ORDER.
+ */
+static int rotation_order( int r[3][3] )
+{
+    int p[3][3], n;
+
+    memcpy( p, r, sizeof(p) );
+    for( n = 1; n <= MAX_ROTATION_ORDER; n++ ) {
+         if( imat_is_identity( p ) ) {
+             return n;
+         }
+         imat_multiply( p, p, r );
+    }
+    return 0;
+}
+
+/* rotation_axis(): the shortest lattice vector along the axis of the
+ * rotation 'r' of order 'n'.  The sum of the powers of 'r' projects onto
+ * the axis, so its columns are along it.  If 'plane' is not NULL it gets
+ * the lattice plane normal to the axis, from the rows of the sum.
+ */
+static void rotation_axis( int axis[3], int plane[3], int r[3][3], int n )
+{
+    int sum[3][3], p[3][3], i, j, k;
+
+    imat_identity( sum );
+    imat_identity( p );
+    for( k = 1; k < n; k++ ) {
+         imat_multiply( p, p, r );
+         for( i = 0; i < 3; i++ ) {
+              for( j = 0; j < 3; j++ ) {
+                   sum[i][j] += p[i][j];
+              }
+         }
+    }
+    for( j = 0; j < 3; j++ ) {
+         axis[0] = sum[0][j];
+         axis[1] = sum[1][j];
+         axis[2] = sum[2][j];
+         if( 0 == make_primitive( axis ) ) {
+             break;
+         }
+    }
+    if( NULL != plane ) {
+        for( i = 0; i < 3; i++ ) {
+             memcpy( plane, sum[i], 3 * sizeof(int) );
+             if( 0 == make_primitive( plane ) ) {
+                 break;
+             }
+        }
+    }
+    return;
+}
+
+/* obliquity(): Le Page's angle in degrees between the row 'u' and the
+ * normal to the plane 'h', for the metric 'g' and its inverse 'gstar'.
+ */
+static double obliquity( double g[3][3], double gstar[3][3], const int u[3], const int h[3] )
+{
+    double c;
+
+    c = abs( dot3( u, h ) ) / sqrt( metric_dot( g, u, u ) * metric_dot( gstar, h, h ) );
+    return RAD2DEG( acos( c < 1.0 ? c : 1.0 ) );
+}
+
+/*** Niggli reduction ***/
+
+/* basis_metric(): the metric tensor B G0 B' of the cell whose edges are the
+ * rows of 'b', in terms of the cell with metric 'g0'.
+ */
+static void basis_metric( double g[3][3], int b[3][3], double g0[3][3] )
+{
+    int i, j;
+
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              g[i][j] = metric_dot( g0, b[i], b[j] );
+         }
+    }
+    return;
+}
+
+static int sign_of( double x, double eps )
+{
+    return x > eps ? 1 : (x < -eps ? -1 : 0);
+}
+
+/* niggli_reduce(): the Niggli reduced cell of 'c', by the algorithm of
+ * Krivy and Gruber as set out by Grosse-Kunstleve, Sauter and Adams, Acta
+ * Cryst. (2004), A60, 1-6.  Writing A = a.a, B = b.b, C = c.c, xi = 2b.c,
+ * eta = 2a.c and zeta = 2a.b, each step below is a unimodular change of
+ * the cell edges which is tried in turn until none applies.  The edges are
+ * kept as integral rows in terms of the given cell, in 'tm', and the metric
+ * is recomputed from them at every step so no round off builds up.
+ * Returns 0, or -1 if the cell is not valid or the reduction doesn't end.
+ */
+int niggli_reduce( struct unit_cell *reduced, int tm[3][3], const struct unit_cell *c )
+{
+    double g0[3][3], g[3][3], eps, A, B, C, xi, eta, zeta, w;
+    int b[3][3], t[3], sgn[3], flip[3], cycle, k, n_pos, n_zero, positive, s;
+
+    if( !cell_is_valid( c ) ) {
+        return -1;
+    }
+    cell_metric( g0, c );
+    eps = NIGGLI_EPSILON * pow( determinant( g0 ), 1.0 / 3.0 );
+    imat_identity( b );
+
+    for( cycle = 0; cycle < NIGGLI_MAX_CYCLES; cycle++ ) {
+         basis_metric( g, b, g0 );
+         A = g[0][0];
+         B = g[1][1];
+         C = g[2][2];
+         xi = 2.0 * g[1][2];
+         eta = 2.0 * g[0][2];
+         zeta = 2.0 * g[0][1];
+
+/* A1: A <= B, and a,b,c -> -b,-a,-c */
+         if( (A > B + eps) || ((fabs( A - B ) <= eps) && (fabs( xi ) > fabs( eta ) + eps)) ) {
+             memcpy( t, b[0], sizeof(t) );
+             memcpy( b[0], b[1], sizeof(t) );
+             memcpy( b[1], t, sizeof(t) );
+             for( k = 0; k < 3; k++ ) {
+                  negate3( b[k] );
+             }
+             continue;
+         }
+/* A2: B <= C, and a,b,c -> -a,-c,-b */
+         if( (B > C + eps) || ((fabs( B - C ) <= eps) && (fabs( eta ) > fabs( zeta ) + eps)) ) {
+             memcpy( t, b[1], sizeof(t) );
+             memcpy( b[1], b[2], sizeof(t) );
+             memcpy( b[2], t, sizeof(t) );
+             for( k = 0; k < 3; k++ ) {
+                  negate3( b[k] );
+             }
+             continue;
+         }
+/* A3 and A4: xi, eta and zeta all positive, or none of them.  Negating a
+ * changes the signs of eta and zeta, b those of xi and zeta, and c those
+ * of xi and eta, so the number of signs to change must be even; a zero
+ * may be counted as either sign to make it so.  Negating all three edges
+ * changes none, which keeps the cell right handed.
+ */
+         sgn[0] = sign_of( xi, eps );
+         sgn[1] = sign_of( eta, eps );
+         sgn[2] = sign_of( zeta, eps );
+         n_pos = (sgn[0] > 0) + (sgn[1] > 0) + (sgn[2] > 0);
+         n_zero = (0 == sgn[0]) + (0 == sgn[1]) + (0 == sgn[2]);
+         positive = (3 == n_pos) || ((0 == n_zero) && (1 == n_pos));
+         for( k = 0; k < 3; k++ ) {
+              t[k] = positive ? sgn[k] < 0 : sgn[k] > 0;
+         }
+         if( (t[0] + t[1] + t[2]) % 2 ) {
+             for( k = 0; 0 != sgn[k]; k++ )
+                  ;
+             t[k] = 1;
+         }
+         flip[0] = t[1];
+         flip[1] = t[0];
+         flip[2] = 0;
+         if( (flip[0] + flip[1]) % 2 ) {
+             for( k = 0; k < 3; k++ ) {
+                  flip[k] = !flip[k];
+             }
+         }
+         if( flip[0] || flip[1] || flip[2] ) {
+             for( k = 0; k < 3; k++ ) {
+                  if( flip[k] ) {
+                      negate3( b[k] );
+                  }
+             }
+             continue;
+         }
+/* A5: c -> c - sign(xi) b */
+         if( (fabs( xi ) > B + eps) || ((fabs( xi - B ) <= eps) && (2.0 * eta < zeta - eps)) ||
+             ((fabs( xi + B ) <= eps) && (zeta < -eps)) ) {
+             s = xi > 0.0 ? 1 : -1;
+             for( k = 0; k < 3; k++ ) {
+                  b[2][k] -= s * b[1][k];
+             }
+             continue;
+         }
+/* A6: c -> c - sign(eta) a */
+         if( (fabs( eta ) > A + eps) || ((fabs( eta - A ) <= eps) && (2.0 * xi < zeta - eps)) ||
+             ((fabs( eta + A ) <= eps) && (zeta < -eps)) ) {
+             s = eta > 0.0 ? 1 : -1;
+             for( k = 0; k < 3; k++ ) {
+                  b[2][k] -= s * b[0][k];
+             }
+             continue;
+         }
+/* A7: b -> b - sign(zeta) a */
+         if( (fabs( zeta ) > A + eps) || ((fabs( zeta - A ) <= eps) && (2.0 * xi < eta - eps)) ||
+             ((fabs( zeta + A ) <= eps) && (eta < -eps)) ) {
+             s = zeta > 0.0 ? 1 : -1;
+             for( k = 0; k < 3; k++ ) {
+                  b[1][k] -= s * b[0][k];
+             }
+             continue;
+         }
+/* A8: c -> a + b + c */
+         w = xi + eta + zeta + A + B;
+         if( (w < -eps) || ((fabs( w ) <= eps) && (2.0 * (A + eta) + zeta > eps)) ) {
+             for( k = 0; k < 3; k++ ) {
+                  b[2][k] += b[0][k] + b[1][k];
+             }
+             continue;
+         }
+         break;
+    }
+    if( NIGGLI_MAX_CYCLES == cycle ) {
+        return -1;
+    }
+
+    reduced->a = sqrt( g[0][0] );
+    reduced->b = sqrt( g[1][1] );
+    reduced->c = sqrt( g[2][2] );
+    reduced->alpha = RAD2DEG( acos( g[1][2] / (reduced->b * reduced->c) ) );
+    reduced->beta = RAD2DEG( acos( g[0][2] / (reduced->a * reduced->c) ) );
+    reduced->gamma = RAD2DEG( acos( g[0][1] / (reduced->a * reduced->b) ) );
+    memcpy( tm, b, sizeof(b) );
+    return 0;
+}
+
+/*** the twofold axes ***/
+
+/* lattice_rows(): the rows (or planes) with indices up to LATTICE_MAX_INDEX,
+ * one of each +/- pair.  Returns how many there are.
+ */
+static int lattice_rows( int rows[MAX_LATTICE_AXES][3] )
+{
+    int v[3], n = 0;
+
+    for( v[0] = 0; v[0] <= LATTICE_MAX_INDEX; v[0]++ ) {
+         for( v[1] = -LATTICE_MAX_INDEX; v[1] <= LATTICE_MAX_INDEX; v[1]++ ) {
+              for( v[2] = -LATTICE_MAX_INDEX; v[2] <= LATTICE_MAX_INDEX; v[2]++ ) {
+                   if( ((0 == v[0]) && ((v[1] < 0) || ((0 == v[1]) && (v[2] <= 0)))) ||
+                       (1 != gcd( gcd( v[0], v[1] ), v[2] )) ) {
+                       continue;
+                   }
+                   memcpy( rows[n++], v, sizeof(v) );
+              }
+         }
+    }
+    return n;
+}
+
+/* find_lattice_axes(): Niggli reduces the cell 'c' and finds its twofold
+ * axes with obliquities up to 'max_obliquity' degrees.  Each row [uvw] is
+ * paired with the plane (hkl), |uh + vk + wl| = 1 or 2, nearest to being
+ * perpendicular to it.  This is the only search made for the cell: any
+ * smaller tolerance just takes fewer of the axes (see
+ * lattice_symmetry_sweep()).  Returns the number of axes, or -1 if the cell
+ * can't be reduced.
+ */
+int find_lattice_axes( struct lattice_search *s, const struct unit_cell *c, double max_obliquity )
+{
+    struct lattice_axis ax;
+    int rows[MAX_LATTICE_AXES][3], n_rows, i, j, k, d, best;
+    double gstar[3][3], obl, best_obl;
+
+    s->cell = *c;
+    s->max_obliquity = max_obliquity;
+    s->n_axes = 0;
+    if( 0 != niggli_reduce( &s->reduced, s->reduce, c ) ) {
+        return -1;
+    }
+    cell_metric( s->g, &s->reduced );
+    invert_matrix( determinant( s->g ), s->g, gstar );
+
+    n_rows = lattice_rows( rows );
+    for( i = 0; i < n_rows; i++ ) {
+         best = -1;
+         best_obl = max_obliquity;
+         for( j = 0; j < n_rows; j++ ) {
+              d = abs( dot3( rows[i], rows[j] ) );
+              if( (1 != d) && (2 != d) ) {
+                  continue;
+              }
+              obl = obliquity( s->g, gstar, rows[i], rows[j] );
+              if( (best < 0) ? obl <= best_obl : obl < best_obl ) {
+                  best = j;
+                  best_obl = obl;
+              }
+         }
+         if( best < 0 ) {
+             continue;
+         }
+         memcpy( ax.u, rows[i], sizeof(ax.u) );
+         memcpy( ax.h, rows[best], sizeof(ax.h) );
+         ax.obliquity = best_obl;
+         d = dot3( ax.u, ax.h );
+         for( j = 0; j < 3; j++ ) {
+              for( k = 0; k < 3; k++ ) {
+                   ax.rot[j][k] = 2 * ax.u[j] * ax.h[k] / d - (j == k);
+              }
+         }
+/* insertion sort by obliquity */
+         for( k = s->n_axes; (k > 0) && (s->axes[k-1].obliquity > ax.obliquity); k-- ) {
+              s->axes[k] = s->axes[k-1];
+         }
+         s->axes[k] = ax;
+         s->n_axes++;
+    }
+    return s->n_axes;
+}
+
+/*** the lattice symmetry ***/
+
+static int group_find( const struct rotation_group *grp, int r[3][3] )
+{
+    int i;
+
+    for( i = 0; i < grp->n; i++ ) {
+         if( imat_equal( (int (*)[3])grp->rot[i], r ) ) {
+             return i;
+         }
+    }
+    return -1;
+}
+
+/* close_group(): adds the products of the rotations with the generators
+ * until the group is closed.  Returns 0, or -1 if the rotations do not make
+ * a crystallographic group, which is the case when twofold axes far from
+ * exact are combined.
+ */
+static int close_group( struct rotation_group *grp, int (*gen)[3][3], int n_gen )
+{
+    int p[3][3], i, j;
+
+    for( i = 0; i < grp->n; i++ ) {
+         for( j = 0; j < n_gen; j++ ) {
+              imat_multiply( p, grp->rot[i], gen[j] );
+              if( group_find( grp, p ) >= 0 ) {
+                  continue;
+              }
+              if( (MAX_LATTICE_ROTATIONS == grp->n) || (imat_max_element( p ) > MAX_ELEMENT) ||
+                  (0 == rotation_order( p )) ) {
+                  return -1;
+              }
+              memcpy( grp->rot[grp->n++], p, sizeof(p) );
+         }
+    }
+    return 0;
+}
+
+/* holohedry_name(): the holohedry whose rotations are a group of order 'n'
+ * generated by twofolds: 2, 222, 32, 422, 622 or 432.
+ */
+static const char *holohedry_name( int n )
+{
+    switch( n ) {
+        case 1:  return "-1";
+        case 2:  return "2/m";
+        case 4:  return "mmm";
+        case 6:  return "-3m";
+        case 8:  return "4/mmm";
+        case 12: return "6/mmm";
+        case 24: return "m-3m";
+        default: return NULL;
+    }
+}
+
+/* find_rotation(): the first rotation of order 'n' in the group */
+static int find_rotation( const struct rotation_group *grp, int n )
+{
+    int i;
+
+    for( i = 0; i < grp->n; i++ ) {
+         if( n == rotation_order( (int (*)[3])grp->rot[i] ) ) {
+             return i;
+         }
+    }
+    return -1;
+}
+
+/* principal_axes(): the shortest lattice vectors along the axes of the
+ * rotations of order 'n', each axis once.  Unless 'c' is NULL only the
+ * rotations which reverse 'c', i.e. are perpendicular to it, are taken.
+ * Returns how many there are.
+ */
+static int principal_axes( int axes[][3], const struct rotation_group *grp, int n, const int c[3] )
+{
+    int v[3], i, k, m = 0;
+
+    for( i = 0; i < grp->n; i++ ) {
+         if( n != rotation_order( (int (*)[3])grp->rot[i] ) ) {
+             continue;
+         }
+         if( NULL != c ) {
+             imat_apply( v, (int (*)[3])grp->rot[i], c );
+             if( (v[0] != -c[0]) || (v[1] != -c[1]) || (v[2] != -c[2]) ) {
+                 continue;
+             }
+         }
+         rotation_axis( v, NULL, (int (*)[3])grp->rot[i], n );
+         for( k = 0; (k < m) && (0 != memcmp( axes[k], v, sizeof(v) )); k++ )
+              ;
+         if( k == m ) {
+             memcpy( axes[m++], v, sizeof(v) );
+         }
+    }
+    return m;
+}
+
+static int shortest( int axes[][3], int n, double g[3][3] )
+{
+    int k, best = 0;
+
+    for( k = 1; k < n; k++ ) {
+         if( metric_dot( g, axes[k], axes[k] ) < metric_dot( g, axes[best], axes[best] ) - NIGGLI_EPSILON ) {
+             best = k;
+         }
+    }
+    return best;
+}
+
+/* monoclinic_cell(): b along the twofold and a, c the shortest pair of
+ * lattice vectors it reverses which make the smallest cell, with beta
+ * obtuse.  Returns 0, or -1 if there is no such pair.
+ */
+static int monoclinic_cell( int tc[3][3], int r[3][3], double g[3][3] )
+{
+    int plane[2 * MAX_LATTICE_AXES][3], v[3], rv[3], n = 0, i, j, d, best_d = 0;
+    double len, best_len = 0.0;
+
+    rotation_axis( tc[1], NULL, r, 2 );
+    for( v[0] = -LATTICE_MAX_INDEX; v[0] <= LATTICE_MAX_INDEX; v[0]++ ) {
+         for( v[1] = -LATTICE_MAX_INDEX; v[1] <= LATTICE_MAX_INDEX; v[1]++ ) {
+              for( v[2] = -LATTICE_MAX_INDEX; v[2] <= LATTICE_MAX_INDEX; v[2]++ ) {
+                   imat_apply( rv, r, v );
+                   if( (rv[0] == -v[0]) && (rv[1] == -v[1]) && (rv[2] == -v[2]) &&
+                       (1 == gcd( gcd( v[0], v[1] ), v[2] )) ) {
+                       memcpy( plane[n++], v, sizeof(v) );
+                   }
+              }
+         }
+    }
+    if( 0 == n ) {
+        return -1;
+    }
+    i = shortest( plane, n, g );
+    memcpy( tc[0], plane[i], sizeof(v) );
+    for( j = 0; j < n; j++ ) {
+         d = abs( det_rows( tc[0], tc[1], plane[j] ) );
+         len = metric_dot( g, plane[j], plane[j] );
+         if( (0 != d) && ((0 == best_d) || (d < best_d) || ((d == best_d) && (len < best_len - NIGGLI_EPSILON))) ) {
+             best_d = d;
+             best_len = len;
+             memcpy( tc[2], plane[j], sizeof(v) );
+         }
+    }
+    if( 0 == best_d ) {
+        return -1;
+    }
+    if( det_rows( tc[0], tc[1], tc[2] ) < 0 ) {
+        negate3( tc[2] );
+    }
+    if( metric_dot( g, tc[0], tc[2] ) > 0.0 ) {
+        negate3( tc[0] );
+        negate3( tc[2] );
+    }
+    return 0;
+}
+
+/* conventional_cell(): the edges of the conventional cell of the group's
+ * holohedry as rows of 'tc', in terms of the reduced cell with metric 'g'.
+ * Returns 0, or -1 if the group has no such cell.
+ */
+static int conventional_cell( int tc[3][3], const struct rotation_group *grp, double g[3][3] )
+{
+    int axes[MAX_LATTICE_ROTATIONS][3], r[3][3], r2[3][3], n, i;
+
+    switch( grp->n ) {
+        case 1:   /* any cell will do */
+           imat_identity( tc );
+           return 0;
+        case 2:
+           memcpy( r, grp->rot[imat_is_identity( (int (*)[3])grp->rot[0] ) ? 1 : 0], sizeof(r) );
+           return monoclinic_cell( tc, r, g );
+        case 4:   /* along the three twofolds, shortest first */
+           if( 3 != principal_axes( axes, grp, 2, NULL ) ) {
+               return -1;
+           }
+           for( n = 0; n < 3; n++ ) {
+                i = shortest( axes + n, 3 - n, g ) + n;
+                memcpy( tc[n], axes[i], sizeof(axes[0]) );
+                memcpy( axes[i], axes[n], sizeof(axes[0]) );
+           }
+           break;
+        case 24:  /* along the three fourfolds */
+           if( 3 != principal_axes( axes, grp, 4, NULL ) ) {
+               return -1;
+           }
+           memcpy( tc, axes, 3 * sizeof(axes[0]) );
+           break;
+        case 6:   /* c along the threefold, a along a twofold and b = 3(a) */
+        case 8:   /* c along the fourfold, a along a twofold and b = 4(a) */
+        case 12:  /* c along the sixfold, a along a twofold and b = 3(a) */
+           n = 6 == grp->n ? 3 : (8 == grp->n ? 4 : 6);
+           i = find_rotation( grp, n );
+           if( i < 0 ) {
+               return -1;
+           }
+           memcpy( r, grp->rot[i], sizeof(r) );
+           rotation_axis( tc[2], NULL, r, n );
+           n = principal_axes( axes, grp, 2, tc[2] );
+           if( 0 == n ) {
+               return -1;
+           }
+           memcpy( tc[0], axes[shortest( axes, n, g )], sizeof(axes[0]) );
+           if( 12 == grp->n ) {
+               imat_multiply( r, r, r );
+           }
+           imat_apply( tc[1], r, tc[0] );
+           if( det_rows( tc[0], tc[1], tc[2] ) < 0 ) {  /* the other sense of rotation */
+               if( 8 == grp->n ) {
+                   negate3( tc[1] );
+               }
+               else {
+                   imat_multiply( r2, r, r );
+                   imat_apply( tc[1], r2, tc[0] );
+               }
+           }
+           return 0;
+        default:
+           return -1;
+    }
+    if( det_rows( tc[0], tc[1], tc[2] ) < 0 ) {
+        negate3( tc[2] );
+    }
+    return 0;
+}
+
+/* in_supergroup(): checks that the rotations of the group and their
+ * inversion related partners, put in the cell 'tc', are the operators of
+ * the supergroup 't'.  The rotations act on direct lattice coordinates,
+ * while the supergroup operators are stored as their inverse transposes,
+ * which act on the indices hkl, as the RMATs of the tasks are.
+ */
+static int in_supergroup( const struct cayley_table *t, const struct rotation_group *grp, int tc[3][3] )
+{
+    struct rat_matrix tm, m, out;
+    int inv[3][3], i, j, k, sign;
+
+    if( 2 * grp->n != t->order ) {
+        return 0;
+    }
+    rat_matrix_identity( &tm );
+    for( j = 0; j < 3; j++ ) {
+         for( k = 0; k < 3; k++ ) {
+              tm.num[j][k] = tc[j][k];
+         }
+    }
+    for( i = 0; i < grp->n; i++ ) {
+         memcpy( inv, grp->rot[i], sizeof(inv) );
+         for( k = rotation_order( inv ); k > 2; k-- ) {
+              imat_multiply( inv, inv, (int (*)[3])grp->rot[i] );
+         }
+         for( sign = 1; sign >= -1; sign -= 2 ) {
+              rat_matrix_identity( &m );
+              for( j = 0; j < 3; j++ ) {
+                   for( k = 0; k < 3; k++ ) {
+                        m.num[j][k] = sign * inv[k][j];
+                   }
+              }
+              if( (0 != rat_matrix_conjugate( &out, &tm, &m )) ||
+                  (cayley_index( t, rat_matrix_encode( &out ) ) < 0) ) {
+                  return 0;
+              }
+         }
+    }
+    return 1;
+}
+
+/* group_obliquity(): the largest obliquity of the twofolds of the group */
+static double group_obliquity( const struct rotation_group *grp, double g[3][3], double gstar[3][3] )
+{
+    double most = 0.0, obl;
+    int u[3], h[3], i;
+
+    for( i = 0; i < grp->n; i++ ) {
+         if( 2 == rotation_order( (int (*)[3])grp->rot[i] ) ) {
+             rotation_axis( u, h, (int (*)[3])grp->rot[i], 2 );
+             obl = obliquity( g, gstar, u, h );
+             most = obl > most ? obl : most;
+         }
+    }
+    return most;
+}
+
+/* make_level(): the lattice symmetry of the rotation group 'grp' of the
+ * search 's'.  Returns 0, or -1 if there is no conventional cell for it
+ * or its TRANS can't be represented.
+ */
+static int make_level( struct lattice_symmetry *ls, const struct lattice_search *s,
+                       const struct rotation_group *grp )
+{
+    const char *name;
+    double gstar[3][3], g[3][3];
+    int tc[3][3], tr[3][3], i, j;
+    rat_int num[3][3], den[3][3];
+
+    name = holohedry_name( grp->n );
+    if( NULL == name ) {
+        return -1;
+    }
+    ls->table = lookup_cayley_table( lookup_supergroup( name ) );
+    memcpy( g, s->g, sizeof(g) );
+    if( (NULL == ls->table) || (0 != conventional_cell( tc, grp, g )) ||
+        !in_supergroup( ls->table, grp, tc ) ) {
+        return -1;
+    }
+
+/* TRANS = Tc * N for the reduced cell N, but if the given cell is already
+ * a conventional cell of the holohedry, which it always is for -1, it is
+ * kept: then Tc = N^-1 and TRANS is the identity.
+ */
+    imat_adjugate( tr, (int (*)[3])s->reduce );
+    if( in_supergroup( ls->table, grp, tr ) ) {
+        imat_identity( tr );
+    }
+    else {
+        imat_multiply( tr, tc, (int (*)[3])s->reduce );
+    }
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              num[i][j] = tr[i][j];
+              den[i][j] = 1;
+         }
+    }
+    if( 0 != rat_matrix_set( &ls->trans, num, den ) ) {
+        return -1;
+    }
+
+    invert_matrix( determinant( g ), g, gstar );
+    ls->obliquity = group_obliquity( grp, g, gstar );
+    ls->n_twofolds = 0;
+    for( i = 0; i < grp->n; i++ ) {
+         ls->n_twofolds += 2 == rotation_order( (int (*)[3])grp->rot[i] );
+    }
+    return 0;
+}
+
+/* lattice_symmetry_sweep(): the lattice symmetry for every tolerance up to
+ * the search's largest.  The axes are taken in order of obliquity, and
+ * each one not already in the group made by the ones before it is added
+ * to its generators and the group is closed again, so the whole sweep is
+ * done from the one search.  The closure may have twofolds of larger
+ * obliquity than the axes which made it, so a group is only a level if
+ * all of its twofolds come before the next axis which would enlarge it;
+ * it is then the lattice symmetry from its own obliquity up to that
+ * axis'.  The last group is always a level.  The sweep stops at an axis
+ * which makes no crystallographic group with those before it, as no larger
+ * tolerance does either.  Returns the number of levels, or -1 if one of
+ * them has no conventional cell.
+ */
+int lattice_symmetry_sweep( const struct lattice_search *s, struct lattice_symmetry *levels, int max_levels )
+{
+    struct rotation_group grp, next;
+    int gen[MAX_LATTICE_AXES][3][3], n_gen = 0, n = 0, k;
+    double g[3][3], gstar[3][3], grp_obl = 0.0;
+
+    memcpy( g, s->g, sizeof(g) );
+    invert_matrix( determinant( g ), g, gstar );
+    grp.n = 1;
+    imat_identity( grp.rot[0] );
+    for( k = 0; k < s->n_axes; k++ ) {
+         if( group_find( &grp, (int (*)[3])s->axes[k].rot ) >= 0 ) {
+             continue;
+         }
+         if( (grp_obl < s->axes[k].obliquity - OBLIQUITY_TIE) && (n < max_levels) ) {
+             if( 0 != make_level( &levels[n], s, &grp ) ) {
+                 return -1;
+             }
+             levels[n++].n_axes = k;
+         }
+         next = grp;
+         memcpy( gen[n_gen], s->axes[k].rot, sizeof(gen[0]) );
+         if( 0 != close_group( &next, gen, n_gen + 1 ) ) {
+             return n;
+         }
+         n_gen++;
+         grp = next;
+         grp_obl = group_obliquity( &grp, g, gstar );
+    }
+    if( n < max_levels ) {
+        if( 0 != make_level( &levels[n], s, &grp ) ) {
+            return -1;
+        }
+        levels[n++].n_axes = s->n_axes;
+    }
+    return n;
+}
+
+/* derive_lattice_symmetry(): the highest lattice symmetry of the cell 'c'
+ * whose twofolds are all within 'max_obliquity' degrees.  Returns 0, or
+ * -1 if the cell can't be reduced or no symmetry could be set up.
+ */
+int derive_lattice_symmetry( struct lattice_symmetry *ls, const struct unit_cell *c, double max_obliquity )
+{
+    struct lattice_search s;
+    struct lattice_symmetry levels[MAX_LATTICE_LEVELS];
+    int n;
+
+    if( find_lattice_axes( &s, c, max_obliquity ) < 0 ) {
+        return -1;
+    }
+    n = lattice_symmetry_sweep( &s, levels, MAX_LATTICE_LEVELS );
+    if( n < 1 ) {
+        return -1;
+    }
+    while( (n > 1) && (levels[n-1].obliquity > max_obliquity) ) {
+        n--;
+    }
+    *ls = levels[n-1];
+    return 0;
+}
+
+/* centring_matrix(): the rows of 'p' are the edges of a primitive cell of
+ * the lattice with centring 'lattice', P, A, B, C, I, F, or R on hexagonal
+ * axes (obverse), in terms of the edges of the centred cell, as in Table
+ * 5.1.3.1 of International Tables A.  Returns 0, or -1 if 'lattice' is
+ * none of these.
+ */
+int centring_matrix( struct rat_matrix *p, char lattice )
+{
+    static const char centrings[] = "PABCIFR";
+    static const rat_int sixths[7][3][3] = {
+           { { 6, 0, 0 }, { 0, 6, 0 }, { 0, 0, 6 } },
+           { { 6, 0, 0 }, { 0, 3, 3 }, { 0, -3, 3 } },
+           { { 3, 0, 3 }, { 0, 6, 0 }, { -3, 0, 3 } },
+           { { 3, 3, 0 }, { -3, 3, 0 }, { 0, 0, 6 } },
+           { { -3, 3, 3 }, { 3, -3, 3 }, { 3, 3, -3 } },
+           { { 0, 3, 3 }, { 3, 0, 3 }, { 3, 3, 0 } },
+           { { 4, 2, 2 }, { -2, 2, 2 }, { -2, -4, 2 } }
+           };
+    const char *c;
+    rat_int num[3][3], den[3][3];
+    int i, j;
+
+    c = strchr( centrings, lattice );
+    if( ('\0' == lattice) || (NULL == c) ) {
+        return -1;
+    }
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              num[i][j] = sixths[c - centrings][i][j];
+              den[i][j] = 6;
+         }
+    }
+    return rat_matrix_set( p, num, den );
+}
+
+/* primitive_cell(): the cell whose edges are the rows of 'p' in terms of
+ * the edges of the cell 'c', e.g. the primitive cell of a centred one.
+ */
+void primitive_cell( struct unit_cell *out, const struct unit_cell *c, const struct rat_matrix *p )
+{
+    double g[3][3], m[3][3], mg[3][3], gp[3][3];
+    int i, j, k;
+
+    cell_metric( g, c );
+    rat_matrix_to_double( m, p );
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              mg[i][j] = 0.0;
+              for( k = 0; k < 3; k++ ) {
+                   mg[i][j] += m[i][k] * g[k][j];
+              }
+         }
+    }
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              gp[i][j] = 0.0;
+              for( k = 0; k < 3; k++ ) {
+                   gp[i][j] += mg[i][k] * m[j][k];
+              }
+         }
+    }
+    out->a = sqrt( gp[0][0] );
+    out->b = sqrt( gp[1][1] );
+    out->c = sqrt( gp[2][2] );
+    out->alpha = RAD2DEG( acos( gp[1][2] / (out->b * out->c) ) );
+    out->beta = RAD2DEG( acos( gp[0][2] / (out->a * out->c) ) );
+    out->gamma = RAD2DEG( acos( gp[0][1] / (out->a * out->b) ) );
+    return;
+}
+
+static void print_cell( FILE *out, const char *label, const struct unit_cell *c )
+{
+    fprintf( out, "%-21s%10.4f %10.4f %10.4f %9.3f %9.3f %9.3f\n", label,
+             c->a, c->b, c->c, c->alpha, c->beta, c->gamma );
+    return;
+}
+
+/* print_lattice_symmetry(): the reduced cell, its twofold axes and the
+ * lattice symmetry at each level of the tolerance sweep, with the
+ * SUPERGROUP and TRANS lines for a task.
+ */
+void print_lattice_symmetry( FILE *out, const struct lattice_search *s,
+                             const struct lattice_symmetry *levels, int n_levels )
+{
+    char buf[9 * RAT_FORMAT_LEN];
+    const int (*r)[3];
+    int k;
+
+    fputs( "*** Lattice Symmetry ***\n", out );
+    print_cell( out, "Given cell:", &s->cell );
+    print_cell( out, "Niggli reduced cell:", &s->reduced );
+    r = (const int (*)[3])s->reduce;
+    fprintf( out, "Reduced cell edges:  a' = %d %d %d   b' = %d %d %d   c' = %d %d %d\n\n",
+             r[0][0], r[0][1], r[0][2], r[1][0], r[1][1], r[1][2], r[2][0], r[2][1], r[2][2] );
+
+    fprintf( out, "Twofold axes of the reduced cell within %.2f deg (Le Page, 1982):\n", s->max_obliquity );
+    fputs( " No.     [uvw]        (hkl)     Obliquity (deg)\n", out );
+    for( k = 0; k < s->n_axes; k++ ) {
+         fprintf( out, "%4d  [%2d %2d %2d]  (%2d %2d %2d)  %14.3f\n", k + 1,
+                  s->axes[k].u[0], s->axes[k].u[1], s->axes[k].u[2],
+                  s->axes[k].h[0], s->axes[k].h[1], s->axes[k].h[2], s->axes[k].obliquity );
+    }
+    fputc( '\n', out );
+
+    fputs( "Lattice symmetry by tolerance (the largest obliquity of its twofolds):\n", out );
+    fputs( "Obliquity (deg)  Twofolds  Axes  Input lines\n", out );
+    for( k = 0; k < n_levels; k++ ) {
+         rat_matrix_format( buf, sizeof(buf), &levels[k].trans );
+         fprintf( out, "%15.3f  %8d  %4d  SUPERGROUP %s\n", levels[k].obliquity, levels[k].n_twofolds,
+                  levels[k].n_axes, levels[k].table->name );
+         fprintf( out, "%33s  TRANS %s\n", "", buf );
+    }
+    if( (n_levels > 0) && (levels[n_levels-1].n_axes < s->n_axes) ) {
+        fprintf( out, "The axes from %.3f deg on make no crystallographic group with those above.\n",
+                 s->axes[levels[n_levels-1].n_axes].obliquity );
+    }
+    fputc( '\n', out );
+    return;
+}
+
+/* lattice_symmetry_mode(): 'coset -C a b c alpha beta gamma [max_obliquity]'
+ * prints the lattice symmetry sweep of the cell.  Returns 0 if everything
+ * is OK, -1 otherwise.
+ */
+int lattice_symmetry_mode( FILE *out, int n_args, char **args )
+{
+    struct lattice_search s;
+    struct lattice_symmetry levels[MAX_LATTICE_LEVELS];
+    struct unit_cell c;
+    double v[7], max_obliquity = DEFAULT_MAX_OBLIQUITY;
+    char *end;
+    int k, n;
+
+    if( (6 != n_args) && (7 != n_args) ) {
+        fprintf( stderr, "a cell, a b c alpha beta gamma, and the largest obliquity are wanted\n" );
+        return -1;
+    }
+    for( k = 0; k < n_args; k++ ) {
+         v[k] = strtod( args[k], &end );
+         if( (end == args[k]) || ('\0' != *end) ) {
+             fprintf( stderr, "'%s' is not a number\n", args[k] );
+             return -1;
+         }
+    }
+    c.a = v[0];
+    c.b = v[1];
+    c.c = v[2];
+    c.alpha = v[3];
+    c.beta = v[4];
+    c.gamma = v[5];
+    if( 7 == n_args ) {
+        max_obliquity = v[6];
+    }
+    if( !cell_is_valid( &c ) || (max_obliquity < 0.0) || (max_obliquity >= 90.0) ) {
+        fprintf( stderr, "the cell or the largest obliquity is not valid\n" );
+        return -1;
+    }
+
+    if( find_lattice_axes( &s, &c, max_obliquity ) < 0 ) {
+        fprintf( stderr, "the cell could not be Niggli reduced\n" );
+        return -1;
+    }
+    n = lattice_symmetry_sweep( &s, levels, MAX_LATTICE_LEVELS );
+    if( n < 0 ) {
+        fprintf( stderr, "no conventional cell was found for a lattice symmetry of the cell\n" );
+        return -1;
+    }
+    print_lattice_symmetry( out, &s, levels, n );
+    return 0;
+}
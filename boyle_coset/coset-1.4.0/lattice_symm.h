@@ -0,0 +1,91 @@
+/* contains public interface for the lattice symmetry search of the Flack
+ * left coset decomposition program which uses alogorithms outlined in
+ * Acta Cryst. (1987), A43, 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef LATTICE_SYMM_H
+#define LATTICE_SYMM_H
+
+#include <stdio.h>
+
+#include "cayley.h"
+#include "rational.h"
+#include "twin_metric.h"
+
+#define LATTICE_MAX_INDEX      2      /* largest |u|, |v|, |w| and |h|, |k|, |l| searched */
+#define MAX_LATTICE_AXES       49     /* the rows [uvw] with indices up to 2 */
+#define MAX_LATTICE_ROTATIONS  24     /* 432 */
+#define MAX_LATTICE_LEVELS     5      /* -1 < 2/m < mmm < 4/mmm < m-3m is the longest chain */
+#define DEFAULT_MAX_OBLIQUITY  3.0    /* degrees */
+
+/* A twofold axis of the lattice after Le Page, J. Appl. Cryst. (1982), 15,
+ * 255-259: the row [uvw] and the lattice plane (hkl) which are nearly
+ * perpendicular, with |uh + vk + wl| = 1 or 2.  The twofold rotation is
+ * then R = 2[uvw](hkl) / (uh + vk + wl) - I, an integral matrix acting on
+ * the coordinates of the direct lattice vectors.  Everything is referred
+ * to the Niggli reduced cell, where all the twofolds have small indices.
+ */
+struct lattice_axis {
+       int u[3];            /* [uvw] */
+       int h[3];            /* (hkl) */
+       int rot[3][3];
+       double obliquity;    /* degrees, the angle between [uvw] and the normal to (hkl) */
+       };
+
+/* the twofold axes of a cell within 'max_obliquity', sorted by obliquity */
+struct lattice_search {
+       struct unit_cell cell;       /* as given */
+       struct unit_cell reduced;    /* Niggli reduced */
+       int reduce[3][3];            /* rows are the reduced cell's edges in terms of the given cell's */
+       double g[3][3];              /* metric of the reduced cell */
+       double max_obliquity;
+       int n_axes;
+       struct lattice_axis axes[MAX_LATTICE_AXES];
+       };
+
+/* The lattice symmetry at one step of a tolerance sweep: the holohedry
+ * of the group generated by the first 'n_axes' twofold axes of the search,
+ * and the SUPERGROUP and TRANS lines for it.  TRANS takes the given cell
+ * to the conventional cell of the holohedry, in the form expected by
+ * transform_group().
+ */
+struct lattice_symmetry {
+       const struct cayley_table *table;   /* the holohedry, table->name is the SUPERGROUP */
+       int n_axes;                         /* twofold axes of the search which are in it */
+       int n_twofolds;                     /* twofold rotations of the group */
+       double obliquity;                   /* degrees, the largest of its twofolds */
+       struct rat_matrix trans;
+       };
+
+/* prototypes */
+int niggli_reduce( struct unit_cell *reduced, int tm[3][3], const struct unit_cell *c );
+int find_lattice_axes( struct lattice_search *s, const struct unit_cell *c, double max_obliquity );
+int lattice_symmetry_sweep( const struct lattice_search *s, struct lattice_symmetry *levels, int max_levels );
+int derive_lattice_symmetry( struct lattice_symmetry *ls, const struct unit_cell *c, double max_obliquity );
+int centring_matrix( struct rat_matrix *p, char lattice );
+void primitive_cell( struct unit_cell *out, const struct unit_cell *c, const struct rat_matrix *p );
+void print_lattice_symmetry( FILE *out, const struct lattice_search *s,
+                             const struct lattice_symmetry *levels, int n_levels );
+int lattice_symmetry_mode( FILE *out, int n_args, char **args );
+
+#endif
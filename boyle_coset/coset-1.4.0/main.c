@@ -32,15 +32,21 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <errno.h>
 
 #include "input.h"
 #include "queue.h"
 #include "task.h"
+#include "subgroup_lattice.h"
+#include "lattice_symm.h"
+#include "bulk.h"
+#include "eigen.h"
+
+#define MSG_BUF_SZ 256
 
 #ifdef PYTHON_EXTENSION_MODULE
 #include <Python.h>
-#define MSG_BUF_SZ 256
 
 #ifndef PyMODINIT_FUNC
 #define PyMODINIT_FUNC void
@@ -59,9 +65,10 @@ int main( int argc, char **argv )
 {
     Queue *task_queue;
     void *task_data;
-    struct task *t;
+    struct task *t, **tasks;
     char *filename;
-    int n_tasks = 0;
+    char reason[MSG_BUF_SZ];
+    int i, n_tasks = 0;
 #ifdef PYTHON_EXTENSION_MODULE
     char msg[MSG_BUF_SZ] = {0};
 
@@ -69,6 +76,28 @@ int main( int argc, char **argv )
         return NULL;
     }
 #else
+/* 'coset -e <eigen code> ...' chooses the eigen code for the run */
+    if( (argc >= 3) && (0 == strcmp( argv[1], "-e" )) ) {
+        if( 0 != set_eigen_backend( argv[2] ) ) {
+            fprintf( stderr, "'%s' is not an eigen code of this program, which has:", argv[2] );
+            print_eigen_backends( stderr );
+            exit( EXIT_FAILURE );
+        }
+        argc -= 2;
+        argv += 2;
+    }
+/* 'coset -L [supergroup ...]' prints the subgroup lattices instead */
+    if( (argc >= 2) && (0 == strcmp( argv[1], "-L" )) ) {
+        exit( 0 == subgroup_lattice_mode( stdout, argc - 2, argv + 2 ) ? EXIT_SUCCESS : EXIT_FAILURE );
+    }
+/* 'coset -C a b c alpha beta gamma [max obliquity]' prints the lattice symmetry of a cell */
+    if( (argc >= 2) && (0 == strcmp( argv[1], "-C" )) ) {
+        exit( 0 == lattice_symmetry_mode( stdout, argc - 2, argv + 2 ) ? EXIT_SUCCESS : EXIT_FAILURE );
+    }
+/* 'coset -B [options] [file ...]' screens the cells of PDB, CIF or CSV files */
+    if( (argc >= 2) && (0 == strcmp( argv[1], "-B" )) ) {
+        exit( 0 == bulk_mode( stdout, argc - 2, argv + 2 ) ? EXIT_SUCCESS : EXIT_FAILURE );
+    }
     if( argc == 2 ) {
         filename = argv[argc-1];
     }
@@ -86,8 +115,41 @@ int main( int argc, char **argv )
         exit(EXIT_FAILURE );
     }
 
+/* reject the tasks whose subgroup is not a group before doing any work */
+    n_tasks = queue_size( task_queue );
+    for( i = 0; i < n_tasks; i++ ) {
+         queue_dequeue( task_queue, &task_data );
+         t = (struct task *)task_data;
+         if( 0 == validate_task( t, reason, sizeof(reason) ) ) {
+             queue_enqueue( task_queue, t );
+         }
+         else {
+             fprintf( stderr, "Task '%s' rejected: %s\n",
+                      NULL != t->title ? t->title : "(no TITLE)", reason );
+             dealloc_task( t );
+         }
+    }
     n_tasks = queue_size( task_queue );
 
+/* the decompositions are done up front, many tasks at a time (see
+ * decompose_tasks()), then the tasks are output in their input order.
+ * If there is no memory for the array the loop below does the tasks one
+ * by one.
+ */
+    tasks = malloc( (n_tasks > 0 ? n_tasks : 1) * sizeof(*tasks) );
+    if( NULL != tasks ) {
+        for( i = 0; i < n_tasks; i++ ) {
+             queue_dequeue( task_queue, &task_data );
+             tasks[i] = (struct task *)task_data;
+        }
+        decompose_tasks( tasks, n_tasks );
+        for( i = 0; i < n_tasks; i++ ) {
+             process_task( tasks[i] );
+             dealloc_task( tasks[i] );
+        }
+        free( tasks );
+    }
+
     while( 0 < queue_size(task_queue) ) {
            queue_dequeue( task_queue, &task_data );
            t = (struct task *)task_data;
@@ -192,6 +192,296 @@ void copy_matrix( double dest[N_DIM][N_DIM], double src[N_DIM][N_DIM] )
 
     return;
 }
+/***********************************************************************/
+/***********************************************************************/
+/* Batched kernels.  These do the same work as the functions above on an
+ * array of 'n' matrices per call, so the loop over the matrices stays in
+ * one place and can use the SIMD units.  The kernels are chosen once, at
+ * the first call, from the best instruction set the CPU supports: AVX2
+ * with FMA, SSE2, or plain C.  Results agree with the single matrix
+ * functions to rounding, and exactly whenever the elements are integers
+ * small enough for every intermediate to be exact in a double (e.g. the
+ * integral TRANS products of transform_bcm_batch(), see symm_mat.c).
+ *
+ * The output may be the same array as the input.
+ */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(NEED_C89_COMPATIBILITY)
+#define HAVE_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+typedef void (*multiply_kernel)( double (*prod)[N_DIM][N_DIM], double a[N_DIM][N_DIM],
+                                 double (*b)[N_DIM][N_DIM], int n );
+typedef void (*similarity_kernel)( double (*transformed)[N_DIM][N_DIM], double (*mat)[N_DIM][N_DIM],
+                                   int n, double left[N_DIM][N_DIM], double right[N_DIM][N_DIM] );
+
+struct matrix_kernels {
+       const char *name;
+       int (*supported)( void );          /* NULL if always available */
+       multiply_kernel multiply;
+       similarity_kernel similarity;
+       };
+
+static void multiply_scalar( double (*prod)[N_DIM][N_DIM], double a[N_DIM][N_DIM],
+                             double (*b)[N_DIM][N_DIM], int n )
+{
+    double tmp[N_DIM][N_DIM];
+    int i;
+
+    for( i = 0; i < n; i++ ) {
+         matrix_multiply3x3( tmp, a, b[i] );
+         copy_matrix( prod[i], tmp );
+    }
+    return;
+}
+
+static void similarity_scalar( double (*transformed)[N_DIM][N_DIM], double (*mat)[N_DIM][N_DIM],
+                               int n, double left[N_DIM][N_DIM], double right[N_DIM][N_DIM] )
+{
+    double tmp[N_DIM][N_DIM];
+    int i;
+
+    for( i = 0; i < n; i++ ) {
+         matrix_multiply3x3( tmp, mat[i], right );
+         matrix_multiply3x3( transformed[i], left, tmp );
+    }
+    return;
+}
+
+#ifdef HAVE_X86_KERNELS
+
+/* SSE2: columns 0 and 1 of a row are one vector, column 2 is scalar.  All
+ * rows of a matrix are loaded before any are stored, which is what allows
+ * the output to overwrite the input.
+ */
+__attribute__((target("sse2")))
+static void multiply_sse2( double (*prod)[N_DIM][N_DIM], double a[N_DIM][N_DIM],
+                           double (*b)[N_DIM][N_DIM], int n )
+{
+    __m128d b0, b1, b2, lo;
+    double b02, b12, b22;
+    int i, j;
+
+    for( i = 0; i < n; i++ ) {
+         b0 = _mm_loadu_pd( &b[i][0][0] );
+         b1 = _mm_loadu_pd( &b[i][1][0] );
+         b2 = _mm_loadu_pd( &b[i][2][0] );
+         b02 = b[i][0][2];
+         b12 = b[i][1][2];
+         b22 = b[i][2][2];
+         for( j = 0; j < N_DIM; j++ ) {
+              lo = _mm_add_pd( _mm_add_pd( _mm_mul_pd( _mm_set1_pd( a[j][0] ), b0 ),
+                                           _mm_mul_pd( _mm_set1_pd( a[j][1] ), b1 ) ),
+                               _mm_mul_pd( _mm_set1_pd( a[j][2] ), b2 ) );
+              _mm_storeu_pd( &prod[i][j][0], lo );
+              prod[i][j][2] = a[j][0] * b02 + a[j][1] * b12 + a[j][2] * b22;
+         }
+    }
+    return;
+}
+
+__attribute__((target("sse2")))
+static void similarity_sse2( double (*transformed)[N_DIM][N_DIM], double (*mat)[N_DIM][N_DIM],
+                             int n, double left[N_DIM][N_DIM], double right[N_DIM][N_DIM] )
+{
+    double tmp[N_DIM][N_DIM];
+    int i;
+
+    for( i = 0; i < n; i++ ) {
+         multiply_sse2( (double (*)[N_DIM][N_DIM])tmp, left, &mat[i], 1 );
+         multiply_sse2( &transformed[i], tmp, (double (*)[N_DIM][N_DIM])right, 1 );
+    }
+    return;
+}
+
+static int have_sse2( void )
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports( "sse2" );
+}
+
+/* AVX2: a row is one vector, loaded and stored with lane 3 masked off so
+ * that nothing beyond the matrix is touched.  A row of a product is the
+ * sum of the rows of the right hand matrix weighted by the elements of the
+ * row of the left hand one.
+ */
+#define ROW_MASK  _mm256_set_epi64x( 0, -1, -1, -1 )
+
+__attribute__((target("avx2,fma")))
+static void multiply_avx2( double (*prod)[N_DIM][N_DIM], double a[N_DIM][N_DIM],
+                           double (*b)[N_DIM][N_DIM], int n )
+{
+    const __m256i mask = ROW_MASK;
+    __m256d b0, b1, b2, row;
+    int i, j;
+
+    for( i = 0; i < n; i++ ) {
+         b0 = _mm256_maskload_pd( &b[i][0][0], mask );
+         b1 = _mm256_maskload_pd( &b[i][1][0], mask );
+         b2 = _mm256_maskload_pd( &b[i][2][0], mask );
+         for( j = 0; j < N_DIM; j++ ) {
+              row = _mm256_mul_pd( _mm256_broadcast_sd( &a[j][0] ), b0 );
+              row = _mm256_fmadd_pd( _mm256_broadcast_sd( &a[j][1] ), b1, row );
+              row = _mm256_fmadd_pd( _mm256_broadcast_sd( &a[j][2] ), b2, row );
+              _mm256_maskstore_pd( &prod[i][j][0], mask, row );
+         }
+    }
+    return;
+}
+
+__attribute__((target("avx2,fma")))
+static void similarity_avx2( double (*transformed)[N_DIM][N_DIM], double (*mat)[N_DIM][N_DIM],
+                             int n, double left[N_DIM][N_DIM], double right[N_DIM][N_DIM] )
+{
+    const __m256i mask = ROW_MASK;
+    __m256d l[N_DIM][N_DIM], r0, r1, r2, m0, m1, m2, t, row;
+    int i, j, k;
+
+/* the elements of 'left' and the rows of 'right' are the same for every
+ * matrix, so they are only loaded once */
+    for( j = 0; j < N_DIM; j++ ) {
+         for( k = 0; k < N_DIM; k++ ) {
+              l[j][k] = _mm256_broadcast_sd( &left[j][k] );
+         }
+    }
+    r0 = _mm256_maskload_pd( &right[0][0], mask );
+    r1 = _mm256_maskload_pd( &right[1][0], mask );
+    r2 = _mm256_maskload_pd( &right[2][0], mask );
+
+    for( i = 0; i < n; i++ ) {
+         m0 = _mm256_maskload_pd( &mat[i][0][0], mask );
+         m1 = _mm256_maskload_pd( &mat[i][1][0], mask );
+         m2 = _mm256_maskload_pd( &mat[i][2][0], mask );
+         for( j = 0; j < N_DIM; j++ ) {
+              t = _mm256_mul_pd( l[j][0], m0 );        /* row j of left * mat */
+              t = _mm256_fmadd_pd( l[j][1], m1, t );
+              t = _mm256_fmadd_pd( l[j][2], m2, t );
+              row = _mm256_mul_pd( _mm256_permute4x64_pd( t, 0x00 ), r0 );
+              row = _mm256_fmadd_pd( _mm256_permute4x64_pd( t, 0x55 ), r1, row );
+              row = _mm256_fmadd_pd( _mm256_permute4x64_pd( t, 0xaa ), r2, row );
+              _mm256_maskstore_pd( &transformed[i][j][0], mask, row );
+         }
+    }
+    return;
+}
+
+#undef ROW_MASK
+
+static int have_avx2( void )
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" );
+}
+
+#endif  /* HAVE_X86_KERNELS */
+
+/* best first; the last entry is always available */
+static const struct matrix_kernels kernel_table[] = {
+#ifdef HAVE_X86_KERNELS
+       { "avx2", have_avx2, multiply_avx2, similarity_avx2 },
+       { "sse2", have_sse2, multiply_sse2, similarity_sse2 },
+#endif
+       { "scalar", NULL, multiply_scalar, similarity_scalar }
+       };
+
+#define N_KERNELS  ((int)(sizeof(kernel_table) / sizeof(kernel_table[0])))
+
+static const struct matrix_kernels *kernels = NULL;
+
+static const struct matrix_kernels *select_kernels( void )
+{
+    int i;
+
+    if( NULL == kernels ) {
+        for( i = 0; i < N_KERNELS - 1; i++ ) {
+             if( kernel_table[i].supported() ) {
+                 break;
+             }
+        }
+        kernels = &kernel_table[i];
+    }
+    return kernels;
+}
+
+/* matrix_kernel_name(): the instruction set the batched kernels use */
+const char *matrix_kernel_name( void )
+{
+    return select_kernels()->name;
+}
+
+/* set_matrix_kernels(): makes the batched kernels use the named
+ * instruction set ("avx2", "sse2" or "scalar") instead of the one chosen
+ * from the CPU.  Returns 0, or -1 if the name is unknown or the CPU can't
+ * run those kernels.
+ */
+int set_matrix_kernels( const char *name )
+{
+    int i;
+
+    for( i = 0; i < N_KERNELS; i++ ) {
+         if( 0 == strcmp( name, kernel_table[i].name ) ) {
+             if( (NULL != kernel_table[i].supported) && !kernel_table[i].supported() ) {
+                 return -1;
+             }
+             kernels = &kernel_table[i];
+             return 0;
+         }
+    }
+    return -1;
+}
+
+/* matrix_multiply3x3_batch(): prod[i] = a * b[i] */
+void matrix_multiply3x3_batch( double (*prod)[N_DIM][N_DIM], double a[N_DIM][N_DIM],
+                               double (*b)[N_DIM][N_DIM], int n )
+{
+    select_kernels()->multiply( prod, a, b, n );
+    return;
+}
+
+/* similarity_transform_batch(): transformed[i] = left * mat[i] * right.
+ * With 'right' the inverse of 'left' this is similarity_transform() with
+ * trans_mat = left; passing the adjugate instead keeps integer matrices
+ * integral, and the caller divides by the determinant.
+ */
+void similarity_transform_batch( double (*transformed)[N_DIM][N_DIM], double (*mat)[N_DIM][N_DIM],
+                                 int n, double left[N_DIM][N_DIM], double right[N_DIM][N_DIM] )
+{
+    select_kernels()->similarity( transformed, mat, n, left, right );
+    return;
+}
+
+/* determinant_batch() and trace_batch(): det[i] = determinant( m[i] ) and
+ * tr[i] = trace( m[i] ).  These are plain C on every CPU: a vector
+ * determinant has to bring the elements of a matrix together across lanes
+ * (or gather one matrix per lane), which costs more than the dozen scalar
+ * multiplies it saves.
+ */
+void determinant_batch( double *det, double (*m)[N_DIM][N_DIM], int n )
+{
+    int i;
+
+    for( i = 0; i < n; i++ ) {
+         det[i] = determinant( m[i] );
+    }
+    return;
+}
+
+void trace_batch( double *tr, double (*m)[N_DIM][N_DIM], int n )
+{
+    int i;
+
+    for( i = 0; i < n; i++ ) {
+         tr[i] = m[i][0][0] + m[i][1][1] + m[i][2][2];
+    }
+    return;
+}
+
+#undef N_KERNELS
+#ifdef HAVE_X86_KERNELS
+#undef HAVE_X86_KERNELS
+#endif
+
 /***********************************************************************/
 
 #ifdef USE_DIALOG
@@ -48,6 +48,17 @@ void matrix_subtract3x3(double prod[N_DIM][N_DIM], double a[N_DIM][N_DIM], doubl
 void calculate_inverse_transpose(double inv_tr[N_DIM][N_DIM], double matrx[N_DIM][N_DIM]);
 void similarity_transform( double transformed[3][3], double mat[3][3], double trans_mat[3][3] );
 void copy_matrix( double dest[N_DIM][N_DIM], double src[N_DIM][N_DIM] );
+
+/* batched kernels on arrays of 'n' matrices (see matrix.c) */
+void matrix_multiply3x3_batch( double (*prod)[N_DIM][N_DIM], double a[N_DIM][N_DIM],
+                               double (*b)[N_DIM][N_DIM], int n );
+void similarity_transform_batch( double (*transformed)[N_DIM][N_DIM], double (*mat)[N_DIM][N_DIM],
+                                 int n, double left[N_DIM][N_DIM], double right[N_DIM][N_DIM] );
+void determinant_batch( double *det, double (*m)[N_DIM][N_DIM], int n );
+void trace_batch( double *tr, double (*m)[N_DIM][N_DIM], int n );
+const char *matrix_kernel_name( void );
+int set_matrix_kernels( const char *name );
+
 #ifdef USE_DIALOG
 void get_matrix(double m[N_DIM][N_DIM]);
 #endif
@@ -0,0 +1,291 @@
+/* decomp_bench.c: times the indexed coset decomposition engine in coset.c
+ * against the original triple loop implementation of Flack's algorithms
+ * A and B, and checks that both give identical systems of representatives.
+ * The "symm_group" column times the engine on groups already gathered into
+ * struct symm_group (see symm_group.h), and the "batch" column the batch
+ * engine doing GROUP_MASK_BITS decompositions per call.
+ *
+ * Build and run from the top level directory with:
+ * make decomp_bench
+ * ./decomp_bench [n_repeats]
+ */
+#define _ISOC99_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "symm_mat.h"
+#include "matrix.h"
+#include "symm_group.h"
+#include "coset.h"
+
+#define DEFAULT_REPEATS 20000
+
+/* the original linear scan version of algorithm A, kept here as a reference */
+static void reference_A( struct symm_op *G, struct symm_op *H )
+{
+   int i, j;
+   struct symm_op *G_k;
+
+   for( i = 0;  0 != G[i].bcm; i++ ) {
+        if( True == G[i].truefalse ) {
+            for( j = 1; 0 != H[j].bcm; j++ ) {
+                 double prod[3][3] = { {0.0} };
+                 unsigned int bcm;
+                 matrix_multiply3x3( prod, G[i].mat, H[j].mat );
+                 bcm = encode_matrix( prod );
+                 for( G_k = &G[i+1]; 0 != G_k->bcm; G_k++ ) {
+                      if( bcm == G_k->bcm ) {
+                          G_k->truefalse = False;
+                      }
+                 }
+            }
+        }
+   }
+   return;
+}
+
+/* the original linear scan version of algorithm B, kept here as a reference */
+static void reference_B( struct symm_op *G, struct symm_op *H )
+{
+   int i, j,
+       centric_flag,
+       G_count,
+       H_count;
+   struct symm_op *G_k;
+
+   G_count = count_ops( G ) / 2;
+   H_count = count_ops( H );
+   centric_flag = is_centric( H );
+   if( Centric == centric_flag ) {
+       H_count /= 2;
+   }
+
+   for( i = G_count; 0 != G[i].bcm; i++ ) {
+        G[i].truefalse = False;
+   }
+
+   for( i = 0; i < G_count; i++ ) {
+        if( True == G[i].truefalse ) {
+            for( j = 1; j < H_count; j++ ) {
+                 double pos[3][3] = { {0.0} };
+                 double neg[3][3] = { {0.0} };
+                 unsigned int pos_bcm, neg_bcm;
+                 matrix_multiply3x3( pos, G[i].mat, H[j].mat );
+                 pos_bcm = encode_matrix( pos );
+                 negate_matrix( neg, pos );
+                 neg_bcm = encode_matrix( neg );
+                 for( G_k = &G[i+1]; G_k < &G[G_count]; G_k++ ) {
+                      if( (pos_bcm == G_k->bcm) || (neg_bcm == G_k->bcm) ) {
+                          G_k->truefalse = False;
+                      }
+                 }
+            }
+        }
+   }
+#ifdef USE_EXTENDED_B_ALGORITHM
+   if( Acentric == centric_flag ) {
+       for( i = 0; i < G_count; i++ ) {
+            if( True == G[i].truefalse ) {
+                double neg[3][3] = { {0.0} };
+                unsigned int bcm;
+                negate_matrix( neg, G[i].mat );
+                bcm = encode_matrix( neg );
+                for( j = G_count; 0 != G[j].bcm; j++ ) {
+                     if( bcm == G[j].bcm ) {
+                         G[j].truefalse = True;
+                     }
+                }
+            }
+       }
+   }
+#endif
+   return;
+}
+
+/* make_subgroup(): copies the listed operators of G into a new sentinel
+ * terminated array.  Caller must free() the returned pointer.
+ */
+static struct symm_op *make_subgroup( struct symm_op *G, const int *idx, int n )
+{
+    struct symm_op *H;
+    int i;
+
+    H = malloc( (n + 1) * sizeof(*H) );
+    if( NULL == H ) {
+        perror( "malloc" );
+        exit( EXIT_FAILURE );
+    }
+    for( i = 0; i < n; i++ ) {
+         H[i] = G[idx[i]];
+    }
+    H[n].bcm = 0;
+    H[n].truefalse = False;
+    return H;
+}
+
+static void reset_truth( struct symm_op *G )
+{
+    int i;
+    for( i = 0; 0 != G[i].bcm; i++ ) {
+         G[i].truefalse = True;
+    }
+}
+
+static double time_decomp( void (*decomp)(struct symm_op *, struct symm_op *),
+                           struct symm_op *G, struct symm_op *H, long n_rep )
+{
+    long r;
+    clock_t t0;
+
+    t0 = clock();
+    for( r = 0; r < n_rep; r++ ) {
+         reset_truth( G );
+         decomp( G, H );
+    }
+    return (double)(clock() - t0) / CLOCKS_PER_SEC;
+}
+
+/* time_group(): times the engine on groups which are already in the
+ * structure of arrays form, i.e. without the gather and scatter done by
+ * coset_decomposition_A() and coset_decomposition_B().
+ */
+static double time_group( group_mask (*decomp)(const struct symm_group *, group_mask, const struct symm_group *),
+                          const struct symm_group *G, const struct symm_group *H, long n_rep,
+                          group_mask *reps )
+{
+    long r;
+    clock_t t0;
+    group_mask all;
+
+    all = mask_below( G->n );
+    t0 = clock();
+    for( r = 0; r < n_rep; r++ ) {
+         *reps = decomp( G, all, H );
+    }
+    return (double)(clock() - t0) / CLOCKS_PER_SEC;
+}
+
+/* time_batch(): times the batch engine with the same subgroup in every
+ * lane.  Returns the time per decomposition.
+ */
+static double time_batch( void (*batch)(const struct symm_group *, const group_mask *,
+                                        const struct symm_group *const *, int, group_mask *),
+                          const struct symm_group *G, const struct symm_group *H, long n_rep,
+                          group_mask *reps )
+{
+    const struct symm_group *lanes[GROUP_MASK_BITS];
+    group_mask g[GROUP_MASK_BITS];
+    long r;
+    int L;
+    clock_t t0;
+
+    for( L = 0; L < (int)GROUP_MASK_BITS; L++ ) {
+         lanes[L] = H;
+         g[L] = mask_below( G->n );
+    }
+    t0 = clock();
+    for( r = 0; r < n_rep; r++ ) {
+         batch( G, g, lanes, GROUP_MASK_BITS, reps );
+    }
+    return (double)(clock() - t0) / CLOCKS_PER_SEC / GROUP_MASK_BITS;
+}
+
+/* run_case(): times one supergroup/subgroup pair with both algorithms and
+ * returns the number of mismatched truth values found.
+ */
+static int run_case( const char *super, const char *sub, const int *idx, int n, long n_rep )
+{
+    struct symm_op *G, *G_ref, *H;
+    int err = 0, mismatches = 0, alg, i;
+    void (*engine[2])(struct symm_op *, struct symm_op *) = { coset_decomposition_A, coset_decomposition_B };
+    void (*reference[2])(struct symm_op *, struct symm_op *) = { reference_A, reference_B };
+    group_mask (*group_engine[2])(const struct symm_group *, group_mask, const struct symm_group *) = { coset_group_A, coset_group_B };
+    void (*batch_engine[2])(const struct symm_group *, const group_mask *,
+                            const struct symm_group *const *, int, group_mask *) = { coset_batch_A, coset_batch_B };
+    static struct symm_group G_soa, H_soa;
+
+    G = select_symm_ops( lookup_supergroup(super), &err );
+    G_ref = select_symm_ops( lookup_supergroup(super), &err );
+    if( (NULL == G) || (NULL == G_ref) ) {
+        fprintf( stderr, "select_symm_ops() failed for %s\n", super );
+        exit( EXIT_FAILURE );
+    }
+    H = make_subgroup( G, idx, n );
+    if( (0 != symm_group_from_ops( &G_soa, G, 0 )) || (0 != symm_group_from_ops( &H_soa, H, 0 )) ) {
+        fprintf( stderr, "symm_group_from_ops() failed for %s\n", super );
+        exit( EXIT_FAILURE );
+    }
+
+    for( alg = 0; alg < 2; alg++ ) {
+         double t_ref, t_new, t_soa, t_batch;
+         group_mask reps, batch_reps[GROUP_MASK_BITS];
+         int L;
+
+         t_ref = time_decomp( reference[alg], G_ref, H, n_rep );
+         t_new = time_decomp( engine[alg], G, H, n_rep );
+         t_soa = time_group( group_engine[alg], &G_soa, &H_soa, n_rep, &reps );
+         t_batch = time_batch( batch_engine[alg], &G_soa, &H_soa, n_rep, batch_reps );
+         for( L = 0; L < (int)GROUP_MASK_BITS; L++ ) {
+              if( batch_reps[L] != reps ) {
+                  mismatches++;
+              }
+         }
+         for( i = 0; 0 != G[i].bcm; i++ ) {
+              if( G[i].truefalse != G_ref[i].truefalse ) {
+                  mismatches++;
+              }
+              if( mask_has( reps, i ) != (True == G_ref[i].truefalse) ) {
+                  mismatches++;
+              }
+         }
+         printf( "%-6s %-8s  %c  %12.3f %12.3f %12.3f %12.3f %9.1fx\n", super, sub, 'A' + alg,
+                 1.0e6 * t_ref / n_rep, 1.0e6 * t_new / n_rep, 1.0e6 * t_soa / n_rep,
+                 1.0e6 * t_batch / n_rep, t_new > 0.0 ? t_ref / t_new : 0.0 );
+    }
+
+    free( H );
+    free( G );
+    free( G_ref );
+    return mismatches;
+}
+
+int main( int argc, char **argv )
+{
+    long n_rep = DEFAULT_REPEATS;
+    int mismatches = 0;
+
+/* subgroups are given as positions in the arrays returned by select_symm_ops() */
+    static const int triv[] = { 0 };
+    static const int centric1[] = { 0, 24 };
+    static const int pg432[] = { 0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23 };
+    static const int pg4mmm[] = { 0,1,2,3,4,5,10,11,24,25,26,27,28,29,34,35 };
+    static const int hcentric1[] = { 0, 12 };
+    static const int pg622[] = { 0,1,2,3,4,5,6,7,8,9,10,11 };
+    static const int pg6[] = { 0,4,8,9,10,11 };
+
+    if( argc > 1 ) {
+        n_rep = strtol( argv[1], NULL, 10 );
+        if( n_rep <= 0 )
+            n_rep = DEFAULT_REPEATS;
+    }
+
+    printf( "%ld repetitions per case, times in microseconds per decomposition\n", n_rep );
+    printf( "%-6s %-8s %s %12s %12s %12s %12s %10s\n", "Super", "Sub", "Alg", "triple loop", "indexed", "symm_group", "batch", "speedup" );
+    mismatches += run_case( "m-3m", "1", triv, 1, n_rep );
+    mismatches += run_case( "m-3m", "-1", centric1, 2, n_rep );
+    mismatches += run_case( "m-3m", "432", pg432, 24, n_rep );
+    mismatches += run_case( "m-3m", "4/mmm", pg4mmm, 16, n_rep );
+    mismatches += run_case( "6/mmm", "1", triv, 1, n_rep );
+    mismatches += run_case( "6/mmm", "-1", hcentric1, 2, n_rep );
+    mismatches += run_case( "6/mmm", "622", pg622, 12, n_rep );
+    mismatches += run_case( "6/mmm", "6", pg6, 6, n_rep );
+
+    if( 0 != mismatches ) {
+        printf( "%d truth values differ from the reference implementation!\n", mismatches );
+        exit( EXIT_FAILURE );
+    }
+    printf( "All systems of representatives match the reference implementation.\n" );
+    exit( EXIT_SUCCESS );
+}
@@ -0,0 +1,242 @@
+/* eigen_bench.c: compares the eigen codes built into COSET (see eigen.c).
+ * Every operator of every supergroup is transformed by a number of TRANS
+ * matrices (cell choices, centrings, the rhombohedral and orthohexagonal
+ * settings, and random unimodular matrices) and analysed with each eigen
+ * code.  For each code it reports the time per eigen solve, one matrix at
+ * a time and in batches of EIGEN_BATCH (see symm_mat.h), and how its
+ * rotation axes and n-folds compare with those of the first code: the
+ * largest angle between the axis lines, the number of axes which point
+ * the other way, and the number of n-folds which differ.
+ *
+ * Build and run from the top level directory with:
+ * make eigen_bench
+ * ./eigen_bench [n_repeats]
+ */
+#define _ISOC99_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "symm_mat.h"
+#include "cayley.h"
+#include "matrix.h"
+#include "rational.h"
+#include "float_util.h"
+#include "eigen.h"
+
+#define DEFAULT_REPEATS 200
+#define N_RANDOM_TRANS  24
+#define MAX_TRANS       (16 + N_RANDOM_TRANS)
+#define MAX_OPS         (MAX_TRANS * 7 * MAX_HOLOHEDRY_ORDER)
+
+/* the fixed TRANS matrices, numerators over the common denominator */
+struct trans_setting {
+       const char *name;
+       rat_int num[3][3];
+       rat_int den;
+       };
+
+static const struct trans_setting fixed_trans[] = {
+       { "identity",        { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } }, 1 },
+       { "a->b->c",         { { 0, 1, 0 }, { 0, 0, 1 }, { 1, 0, 0 } }, 1 },
+       { "a,-c,b",          { { 1, 0, 0 }, { 0, 0, -1 }, { 0, 1, 0 } }, 1 },
+       { "a+b,-a+b,c",      { { 1, 1, 0 }, { -1, 1, 0 }, { 0, 0, 1 } }, 1 },
+       { "C centred",       { { 1, 1, 0 }, { -1, 1, 0 }, { 0, 0, 2 } }, 2 },
+       { "I centred",       { { -1, 1, 1 }, { 1, -1, 1 }, { 1, 1, -1 } }, 2 },
+       { "F centred",       { { 0, 1, 1 }, { 1, 0, 1 }, { 1, 1, 0 } }, 2 },
+       { "rhomb. obverse",  { { 2, 1, 1 }, { -1, 1, 1 }, { -1, -2, 1 } }, 3 },
+       { "rhomb. reverse",  { { 1, 2, 1 }, { 1, -1, 1 }, { -2, -1, 1 } }, 3 },
+       { "orthohexagonal",  { { 1, 0, 0 }, { 1, 2, 0 }, { 0, 0, 1 } }, 1 },
+       { "monoclinic a+c",  { { 1, 0, 1 }, { 0, 1, 0 }, { -1, 0, 0 } }, 1 },
+       };
+
+#define N_FIXED_TRANS ((int)(sizeof(fixed_trans) / sizeof(fixed_trans[0])))
+
+/* the operators to analyse, and each eigen code's analysis of them */
+static struct symm_op ops[MAX_OPS];
+static struct symm_op ref[MAX_OPS];
+static int n_ops = 0;
+
+/* the same matrices sorted for the batch solvers */
+static double sym_mat[MAX_OPS][3][3], gen_mat[MAX_OPS][3][3];
+static struct real_eigen_data batch_real_eig[MAX_OPS][3];
+static struct complex_eigen_data batch_cmplx_eig[MAX_OPS][3];
+static int n_sym = 0, n_gen = 0;
+
+/* random_unimodular(): a product of a few random shears and axis swaps,
+ * with elements kept small so that the transformed operators stay exact.
+ */
+static void random_unimodular( struct rat_matrix *m )
+{
+    struct rat_matrix e, p;
+    int k, i, j;
+
+    rat_matrix_identity( m );
+    for( k = 0; k < 3; k++ ) {
+         rat_matrix_identity( &e );
+         i = rand() % 3;
+         j = (i + 1 + rand() % 2) % 3;
+         e.num[i][j] = rand() % 2 ? 1 : -1;
+         if( (0 != rat_matrix_multiply( &p, &e, m )) || (0 != rat_matrix_multiply( m, &p, &e )) ) {
+             rat_matrix_identity( m );
+         }
+    }
+    return;
+}
+
+/* add_setting(): appends the operators of every supergroup transformed by 'tm' */
+static void add_setting( const struct rat_matrix *tm )
+{
+    struct symm_op *g;
+    int err = 0, k, i;
+
+    for( k = 0; k < n_cayley_tables; k++ ) {
+         g = select_symm_ops( cayley_tables[k].point_group, &err );
+         if( NULL == g ) {
+             fprintf( stderr, "select_symm_ops() failed for %s\n", cayley_tables[k].name );
+             exit( EXIT_FAILURE );
+         }
+         transform_group( g, tm );
+         for( i = 0; (0 != g[i].bcm) && (n_ops < MAX_OPS); i++ ) {
+              ops[n_ops++] = g[i];
+         }
+         free( g );
+    }
+    return;
+}
+
+/* time_solves(): the time of one eigen solve in microseconds, over n_rep
+ * passes through the operators.
+ */
+static double time_solves( long n_rep )
+{
+    struct real_eigen_data real_eig[3];
+    struct complex_eigen_data cmplx_eig[3];
+    long r;
+    int i;
+    clock_t t0;
+
+    t0 = clock();
+    for( r = 0; r < n_rep; r++ ) {
+         for( i = 0; i < n_ops; i++ ) {
+              if( is_symmetric( &ops[i] ) ) {
+                  symm_eigen_solve( ops[i].mat, real_eig );
+              }
+              else {
+                  non_symm_eigen_solve( ops[i].mat, cmplx_eig );
+              }
+         }
+    }
+    return 1.0e6 * (double)(clock() - t0) / CLOCKS_PER_SEC / ((double)n_rep * n_ops);
+}
+
+/* time_batch_solves(): time_solves() with the batch solvers */
+static double time_batch_solves( long n_rep )
+{
+    long r;
+    int i, n;
+    clock_t t0;
+
+    t0 = clock();
+    for( r = 0; r < n_rep; r++ ) {
+         for( i = 0; i < n_sym; i += n ) {
+              n = n_sym - i < EIGEN_BATCH ? n_sym - i : EIGEN_BATCH;
+              symm_eigen_solve_batch( &sym_mat[i], n, &batch_real_eig[i] );
+         }
+         for( i = 0; i < n_gen; i += n ) {
+              n = n_gen - i < EIGEN_BATCH ? n_gen - i : EIGEN_BATCH;
+              non_symm_eigen_solve_batch( &gen_mat[i], n, &batch_cmplx_eig[i] );
+         }
+    }
+    return 1.0e6 * (double)(clock() - t0) / CLOCKS_PER_SEC / ((double)n_rep * n_ops);
+}
+
+/* axis_angle(): the angle in degrees between the lines along 'a' and 'b',
+ * and through 'reversed' whether they point opposite ways.
+ */
+static double axis_angle( const double a[3], const double b[3], int *reversed )
+{
+    double dot, na, nb, c;
+
+    dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    na = sqrt( a[0] * a[0] + a[1] * a[1] + a[2] * a[2] );
+    nb = sqrt( b[0] * b[0] + b[1] * b[1] + b[2] * b[2] );
+    *reversed = dot < 0.0;
+    if( is_zero( na ) || is_zero( nb ) ) {
+        return 90.0;
+    }
+    c = fabs( dot ) / (na * nb);
+    return RAD2DEG( acos( c < 1.0 ? c : 1.0 ) );
+}
+
+int main( int argc, char **argv )
+{
+    const struct eigen_backend *b;
+    struct rat_matrix tm;
+    struct symm_op op;
+    long n_rep = DEFAULT_REPEATS;
+    double t, t_batch, angle, worst;
+    int k, i, reversed, n_reversed, n_fold_diffs, n_trans = 0;
+
+    if( argc > 1 ) {
+        n_rep = strtol( argv[1], NULL, 10 );
+        if( n_rep <= 0 )
+            n_rep = DEFAULT_REPEATS;
+    }
+
+    for( k = 0; k < N_FIXED_TRANS; k++ ) {
+         rat_matrix_identity( &tm );
+         memcpy( tm.num, fixed_trans[k].num, sizeof(tm.num) );
+         tm.den = fixed_trans[k].den;
+         add_setting( &tm );
+         n_trans++;
+    }
+    srand( 12345 );
+    for( k = 0; k < N_RANDOM_TRANS; k++ ) {
+         random_unimodular( &tm );
+         add_setting( &tm );
+         n_trans++;
+    }
+
+    for( i = 0; i < n_ops; i++ ) {
+         if( is_symmetric( &ops[i] ) ) {
+             memcpy( sym_mat[n_sym++], ops[i].mat, sizeof(sym_mat[0]) );
+         }
+         else {
+             memcpy( gen_mat[n_gen++], ops[i].mat, sizeof(gen_mat[0]) );
+         }
+    }
+
+    set_analysis_cache( 0 );
+    printf( "%d operators: the %d supergroups in %d settings, %ld repetitions\n",
+            n_ops, n_cayley_tables, n_trans, n_rep );
+    printf( "axes and n-folds are compared with those of the '%s' eigen code\n\n", eigen_backend_at( 0 )->name );
+    printf( "%-10s %10s %10s %16s %14s %14s\n", "Eigen code", "us/solve", "batched",
+            "max axis angle", "reversed axes", "n-fold diffs" );
+    for( k = 0; NULL != (b = eigen_backend_at( k )); k++ ) {
+         set_eigen_backend( b->name );
+         t = time_solves( n_rep );
+         t_batch = time_batch_solves( n_rep );
+         worst = 0.0;
+         n_reversed = 0;
+         n_fold_diffs = 0;
+         for( i = 0; i < n_ops; i++ ) {
+              op = ops[i];
+              analyze_symm_op( &op );
+              if( 0 == k ) {
+                  ref[i] = op;
+                  continue;
+              }
+              if( op.n_fold != ref[i].n_fold ) {
+                  n_fold_diffs++;
+              }
+              angle = axis_angle( op.eig_vec, ref[i].eig_vec, &reversed );
+              worst = angle > worst ? angle : worst;
+              n_reversed += reversed;
+         }
+         printf( "%-10s %10.3f %10.3f %16.2e %14d %14d\n", b->name, t, t_batch, worst, n_reversed, n_fold_diffs );
+    }
+    exit( EXIT_SUCCESS );
+}
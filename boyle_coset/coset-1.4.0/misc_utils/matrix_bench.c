@@ -0,0 +1,283 @@
+/* matrix_bench.c: times the batched 3x3 matrix kernels in matrix.c with
+ * each instruction set the CPU supports, and checks them against the one
+ * matrix at a time functions.  It also times transforming the operators
+ * of m-3m by a TRANS matrix with transform_group(), which uses the
+ * kernels, against a loop of transform_matrix(), and checks that both give
+ * the same operators.  Last it times analyze_symm_group() on the
+ * transformed operators with and without the analysis caches, and checks
+ * that both give the same analysis.
+ *
+ * Build and run from the top level directory with:
+ * make matrix_bench
+ * ./matrix_bench [n_repeats]
+ */
+#define _ISOC99_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "symm_mat.h"
+#include "matrix.h"
+#include "rational.h"
+
+#define DEFAULT_REPEATS 2000
+#define N_MATRICES      1024
+
+static double a[N_MATRICES][3][3], b[N_MATRICES][3][3], out[N_MATRICES][3][3];
+static double det[N_MATRICES];
+
+/* fill_matrices(): small integers, so that every kernel must agree exactly */
+static void fill_matrices( void )
+{
+    int i, j, k;
+
+    srand( 12345 );
+    for( i = 0; i < N_MATRICES; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              for( k = 0; k < 3; k++ ) {
+                   a[i][j][k] = (double)(rand() % 7 - 3);
+                   b[i][j][k] = (double)(rand() % 7 - 3);
+              }
+         }
+    }
+    return;
+}
+
+static int same_matrix( double x[3][3], double y[3][3] )
+{
+    int j, k;
+
+    for( j = 0; j < 3; j++ ) {
+         for( k = 0; k < 3; k++ ) {
+              if( x[j][k] != y[j][k] ) {
+                  return 0;
+              }
+         }
+    }
+    return 1;
+}
+
+/* check_kernels(): returns the number of results which differ from the
+ * one matrix at a time functions.
+ */
+static int check_kernels( void )
+{
+    double tmp[3][3], ref[3][3];
+    int i, bad = 0;
+
+    matrix_multiply3x3_batch( out, a[0], b, N_MATRICES );
+    for( i = 0; i < N_MATRICES; i++ ) {
+         matrix_multiply3x3( ref, a[0], b[i] );
+         bad += !same_matrix( ref, out[i] );
+    }
+
+    similarity_transform_batch( out, b, N_MATRICES, a[1], a[2] );
+    for( i = 0; i < N_MATRICES; i++ ) {
+         matrix_multiply3x3( tmp, b[i], a[2] );
+         matrix_multiply3x3( ref, a[1], tmp );
+         bad += !same_matrix( ref, out[i] );
+    }
+
+    determinant_batch( det, a, N_MATRICES );
+    for( i = 0; i < N_MATRICES; i++ ) {
+         bad += determinant( a[i] ) != det[i];
+    }
+
+    trace_batch( det, a, N_MATRICES );
+    for( i = 0; i < N_MATRICES; i++ ) {
+         bad += trace( a[i] ) != det[i];
+    }
+    return bad;
+}
+
+/* time_kernels(): times per matrix for the multiply, similarity
+ * transform and determinant kernels.
+ */
+static void time_kernels( long n_rep, double t[3] )
+{
+    long r;
+    clock_t t0;
+
+    t0 = clock();
+    for( r = 0; r < n_rep; r++ ) {
+         matrix_multiply3x3_batch( out, a[r % N_MATRICES], b, N_MATRICES );
+    }
+    t[0] = (double)(clock() - t0) / CLOCKS_PER_SEC;
+
+    t0 = clock();
+    for( r = 0; r < n_rep; r++ ) {
+         similarity_transform_batch( out, b, N_MATRICES, a[r % N_MATRICES], a[(r + 1) % N_MATRICES] );
+    }
+    t[1] = (double)(clock() - t0) / CLOCKS_PER_SEC;
+
+    t0 = clock();
+    for( r = 0; r < n_rep; r++ ) {
+         determinant_batch( det, b, N_MATRICES );
+    }
+    t[2] = (double)(clock() - t0) / CLOCKS_PER_SEC;
+
+    for( r = 0; r < 3; r++ ) {
+         t[r] *= 1.0e6 / ((double)n_rep * N_MATRICES);
+    }
+    return;
+}
+
+/* time_transform(): transforms m-3m by 'tm' n_rep times both ways and
+ * returns the number of operators on which they disagree.
+ */
+static int time_transform( const char *name, const struct rat_matrix *tm, long n_rep )
+{
+    struct symm_op *G, *G_ref;
+    int err = 0, bad = 0, i;
+    long r;
+    clock_t t0;
+    double t_loop, t_batch;
+
+    G = select_symm_ops( lookup_supergroup( "m-3m" ), &err );
+    G_ref = select_symm_ops( lookup_supergroup( "m-3m" ), &err );
+    if( (NULL == G) || (NULL == G_ref) ) {
+        fprintf( stderr, "select_symm_ops() failed for m-3m\n" );
+        exit( EXIT_FAILURE );
+    }
+
+    t0 = clock();
+    for( r = 0; r < n_rep; r++ ) {
+         for( i = 0; 0 != G_ref[i].bcm; i++ ) {
+              transform_matrix( G_ref[i].mat, G_ref[i].bcm, tm );
+         }
+    }
+    t_loop = (double)(clock() - t0) / CLOCKS_PER_SEC;
+
+    t0 = clock();
+    for( r = 0; r < n_rep; r++ ) {
+         transform_group( G, tm );
+         for( i = 0; 0 != G[i].bcm; i++ ) {
+              G[i].bcm = G_ref[i].bcm;
+         }
+    }
+    t_batch = (double)(clock() - t0) / CLOCKS_PER_SEC;
+
+    transform_group( G, tm );
+    for( i = 0; 0 != G_ref[i].bcm; i++ ) {
+         G_ref[i].bcm = transform_matrix( G_ref[i].mat, G_ref[i].bcm, tm );
+         if( (G[i].bcm != G_ref[i].bcm) || !same_matrix( G[i].mat, G_ref[i].mat ) ) {
+             bad++;
+         }
+    }
+    printf( "m-3m by %-12s %16.3f %12.3f %9.1fx\n", name,
+            1.0e6 * t_loop / n_rep, 1.0e6 * t_batch / n_rep,
+            t_batch > 0.0 ? t_loop / t_batch : 0.0 );
+
+    free( G );
+    free( G_ref );
+    return bad;
+}
+
+/* time_analysis(): analyses m-3m transformed by 'tm' n_rep times with and
+ * without the analysis caches, and returns the number of operators whose
+ * analyses differ.
+ */
+static int time_analysis( const char *name, const struct rat_matrix *tm, long n_rep )
+{
+    struct symm_op *G, *G_ref;
+    int err = 0, bad = 0, i;
+    long r;
+    clock_t t0;
+    double t_plain, t_cached;
+
+    G = select_symm_ops( lookup_supergroup( "m-3m" ), &err );
+    G_ref = select_symm_ops( lookup_supergroup( "m-3m" ), &err );
+    if( (NULL == G) || (NULL == G_ref) ) {
+        fprintf( stderr, "select_symm_ops() failed for m-3m\n" );
+        exit( EXIT_FAILURE );
+    }
+    transform_group( G, tm );
+    transform_group( G_ref, tm );
+
+    set_analysis_cache( 0 );
+    t0 = clock();
+    for( r = 0; r < n_rep; r++ ) {
+         analyze_symm_group( G_ref );
+    }
+    t_plain = (double)(clock() - t0) / CLOCKS_PER_SEC;
+
+    set_analysis_cache( 1 );
+    t0 = clock();
+    for( r = 0; r < n_rep; r++ ) {
+         analyze_symm_group( G );
+    }
+    t_cached = (double)(clock() - t0) / CLOCKS_PER_SEC;
+
+    for( i = 0; 0 != G[i].bcm; i++ ) {
+         if( (G[i].n_fold != G_ref[i].n_fold) || (G[i].rotation_angle != G_ref[i].rotation_angle) ||
+             (G[i].eig_val != G_ref[i].eig_val) || (0 != memcmp( G[i].eig_vec, G_ref[i].eig_vec, sizeof(G[i].eig_vec) )) ) {
+             bad++;
+         }
+    }
+    printf( "m-3m by %-12s %16.3f %12.3f %9.1fx\n", name,
+            1.0e6 * t_plain / n_rep, 1.0e6 * t_cached / n_rep,
+            t_cached > 0.0 ? t_plain / t_cached : 0.0 );
+
+    free( G );
+    free( G_ref );
+    return bad;
+}
+
+int main( int argc, char **argv )
+{
+    static const char *names[] = { "scalar", "sse2", "avx2" };
+    static rat_int cubic_num[3][3] = { { 0, 1, 0 }, { 0, 0, 1 }, { 1, 0, 0 } };
+    static rat_int rhomb_num[3][3] = { { 2, 1, 1 }, { -1, 1, 1 }, { -1, -2, 1 } };
+    static rat_int rhomb_den[3][3] = { { 3, 3, 3 }, { 3, 3, 3 }, { 3, 3, 3 } };
+    static rat_int one[3][3] = { { 1, 1, 1 }, { 1, 1, 1 }, { 1, 1, 1 } };
+    struct rat_matrix cubic, rhomb;
+    long n_rep = DEFAULT_REPEATS;
+    double t[3];
+    int bad = 0, k;
+
+    if( argc > 1 ) {
+        n_rep = strtol( argv[1], NULL, 10 );
+        if( n_rep <= 0 )
+            n_rep = DEFAULT_REPEATS;
+    }
+    fill_matrices();
+    rat_matrix_set( &cubic, cubic_num, one );
+    rat_matrix_set( &rhomb, rhomb_num, rhomb_den );
+
+    printf( "kernels chosen for this CPU: %s\n", matrix_kernel_name() );
+    printf( "%ld repetitions of %d matrices, times in nanoseconds per matrix\n", n_rep, N_MATRICES );
+    printf( "%-8s %12s %12s %12s\n", "Kernels", "multiply", "similarity", "determinant" );
+    for( k = 0; k < (int)(sizeof(names) / sizeof(names[0])); k++ ) {
+         if( 0 != set_matrix_kernels( names[k] ) ) {
+             printf( "%-8s not supported on this CPU\n", names[k] );
+             continue;
+         }
+         bad += check_kernels();
+         time_kernels( n_rep, t );
+         printf( "%-8s %12.3f %12.3f %12.3f\n", names[k], 1.0e3 * t[0], 1.0e3 * t[1], 1.0e3 * t[2] );
+    }
+
+    printf( "\ntimes in microseconds per group\n" );
+    printf( "%-8s %-20s %16s %12s %10s\n", "Kernels", "Transform", "transform_matrix", "batched", "speedup" );
+    for( k = 0; k < (int)(sizeof(names) / sizeof(names[0])); k++ ) {
+         if( 0 == set_matrix_kernels( names[k] ) ) {
+             printf( "%-8s ", names[k] );
+             bad += time_transform( "axis swap", &cubic, n_rep );
+             printf( "%-8s ", names[k] );
+             bad += time_transform( "rhombohedral", &rhomb, n_rep );
+         }
+    }
+
+    printf( "\ntimes in microseconds per group\n" );
+    printf( "%-20s %16s %12s %10s\n", "Analysis", "uncached", "cached", "speedup" );
+    bad += time_analysis( "axis swap", &cubic, n_rep );
+    bad += time_analysis( "rhombohedral", &rhomb, n_rep );
+
+    if( 0 != bad ) {
+        printf( "%d results differ from the one matrix at a time functions!\n", bad );
+        exit( EXIT_FAILURE );
+    }
+    printf( "All batched and cached results match the one matrix at a time functions.\n" );
+    exit( EXIT_SUCCESS );
+}
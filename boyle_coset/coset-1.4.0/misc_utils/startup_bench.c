@@ -0,0 +1,132 @@
+/* startup_bench.c: times the launch of COSET executables, to compare a
+ * program with the LAPACKE and GSL eigen codes linked in with one which
+ * loads them on first use (see EIGEN_LOAD in the Makefile).  Each program
+ * is run n_runs times on a short input file, with its output thrown away,
+ * and the mean and the least wall clock time per run are printed.  Without
+ * an input file a one task input, startup_bench.inp, is written and used.
+ * The eigen code the programs use can be chosen with the COSET_EIGEN
+ * environment variable as usual.
+ *
+ * Build the two programs and run from the top level directory with:
+ * make EIGEN_BACKENDS="lapacke gsl" && mv coset coset_link && make clean
+ * make EIGEN_BACKENDS="lapacke gsl" EIGEN_LOAD=dlopen EIGEN_MODULE_DIR=`pwd`
+ * make startup_bench
+ * ./startup_bench [-n n_runs] [-i input_file] ./coset_link ./coset
+ */
+#define _XOPEN_SOURCE 500
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_RUNS  200
+#define DEFAULT_INPUT "startup_bench.inp"
+
+/* a task which only decomposes and prints */
+static const char default_task[] =
+       "TITLE startup_bench\n"
+       "ALGORITHM A\n"
+       "SUPERGROUP mmm\n"
+       "SUBGROUP 2/m 4\n"
+       "RMAT 1 0 0 0 1 0 0 0 1\n"
+       "RMAT -1 0 0 0 1 0 0 0 -1\n"
+       "RMAT -1 0 0 0 -1 0 0 0 -1\n"
+       "RMAT 1 0 0 0 -1 0 0 0 1\n"
+       "TRANS 0 0 1 2 0 1 0 1 0\n"
+       "END\n";
+
+static double now( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (double)ts.tv_sec + 1.0e-9 * (double)ts.tv_nsec;
+}
+
+/* run_once(): runs 'exe' on 'input' with its output to /dev/null, and
+ * returns the wall clock time it took in seconds, or -1.0 if it failed.
+ */
+static double run_once( const char *exe, const char *input )
+{
+    pid_t pid;
+    int status, fd;
+    double t0;
+
+    t0 = now();
+    switch( pid = fork() ) {
+        case -1:
+           perror( "fork()" );
+           return -1.0;
+        case 0:
+           fd = open( "/dev/null", O_WRONLY );
+           if( fd >= 0 ) {
+               dup2( fd, STDOUT_FILENO );
+               dup2( fd, STDERR_FILENO );
+           }
+           execl( exe, exe, input, (char *)0 );
+           _exit( 127 );
+        default:
+           break;
+    }
+    if( (pid != waitpid( pid, &status, 0 )) || ! WIFEXITED(status) || (0 != WEXITSTATUS(status)) ) {
+        return -1.0;
+    }
+    return now() - t0;
+}
+
+int main( int argc, char **argv )
+{
+    const char *input = NULL;
+    long n_runs = DEFAULT_RUNS, r;
+    double t, total, least;
+    FILE *fp;
+    int i;
+
+    for( i = 1; (i < argc - 1) && ('-' == argv[i][0]); i += 2 ) {
+         if( 0 == strcmp( argv[i], "-n" ) ) {
+             n_runs = strtol( argv[i+1], NULL, 10 );
+             if( n_runs <= 0 )
+                 n_runs = DEFAULT_RUNS;
+         }
+         else if( 0 == strcmp( argv[i], "-i" ) ) {
+             input = argv[i+1];
+         }
+         else {
+             break;
+         }
+    }
+    if( i >= argc ) {
+        fprintf( stderr, "usage: %s [-n n_runs] [-i input_file] coset_executable ...\n", argv[0] );
+        exit( EXIT_FAILURE );
+    }
+    if( NULL == input ) {
+        input = DEFAULT_INPUT;
+        fp = fopen( input, "w" );
+        if( (NULL == fp) || (EOF == fputs( default_task, fp )) || (0 != fclose( fp )) ) {
+            perror( input );
+            exit( EXIT_FAILURE );
+        }
+    }
+
+    printf( "%ld runs of each program on %s\n\n", n_runs, input );
+    printf( "%-30s %14s %14s\n", "Program", "mean ms/run", "least ms/run" );
+    for( ; i < argc; i++ ) {
+         total = 0.0;
+         least = -1.0;
+         for( r = 0; r < n_runs; r++ ) {
+              t = run_once( argv[i], input );
+              if( t < 0.0 ) {
+                  fprintf( stderr, "%s failed on %s\n", argv[i], input );
+                  exit( EXIT_FAILURE );
+              }
+              total += t;
+              least = (least < 0.0) || (t < least) ? t : least;
+         }
+         printf( "%-30s %14.3f %14.3f\n", argv[i], 1.0e3 * total / n_runs, 1.0e3 * least );
+    }
+    exit( EXIT_SUCCESS );
+}
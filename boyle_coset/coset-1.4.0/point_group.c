@@ -0,0 +1,293 @@
+/* contains implementation for lookups in the catalogue of the 32
+ * crystallographic point groups (see point_group.h) for the Flack left
+ * coset decomposition program which uses alogorithms outlined in
+ * Acta Cryst. (1987), A43, 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifdef NEED_C89_COMPATIBILITY
+#undef _ISOC99_SOURCE
+#else
+#define _ISOC99_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#ifdef NEED_C89_COMPATIBILITY
+#include "c89_util.h"
+#endif
+
+#include "dupstr.h"
+#include "point_group.h"
+
+#define MAX_SYMBOL_PARTS  4     /* a lattice letter is followed by up to 3 parts, one more to catch a 4th */
+#define SYMBOL_PART_LEN   8
+#define MAX_SYMBOL_TRIALS 16    /* readings of a compact symbol tried, see space_group_point_group() */
+
+/* the parts of a Hermann-Mauguin symbol after the lattice letter, reduced
+ * to the symmetry elements of the point group, e.g. "2/m", "-4", "m"
+ */
+struct symbol_parts {
+       int n;
+       char part[MAX_SYMBOL_PARTS][SYMBOL_PART_LEN];
+       };
+
+/* lookup_group_name(): finds the entry for a point group or supergroup
+ * name with an optional setting (NULL or "" for the standard setting).
+ * Returns NULL if there is no such group.
+ */
+const struct group_name *lookup_group_name( const char *name, const char *setting )
+{
+    char key[MAX_GROUP_KEY_LEN];
+    int n, idx;
+
+    if( (NULL == setting) || ('\0' == setting[0]) ) {
+        n = snprintf( key, sizeof(key), "%s", name );
+    }
+    else {
+        n = snprintf( key, sizeof(key), "%s %s", name, setting );
+    }
+    if( (n < 0) || (n >= (int)sizeof(key)) ) {
+        return NULL;
+    }
+
+    idx = group_name_hash[strhash( key ) % group_name_hash_size];
+    if( (idx < 0) || (0 != strcmp( key, group_names[idx].key )) ) {
+        return NULL;
+    }
+    return &group_names[idx];
+}
+
+/* lookup_point_group(): returns the catalogue entry for a point group, or
+ * NULL if there is no such point group or setting.
+ */
+const struct point_group *lookup_point_group( const char *name, const char *setting )
+{
+    const struct group_name *g;
+
+    g = lookup_group_name( name, setting );
+    if( (NULL == g) || (g->point_group < 0) ) {
+        return NULL;
+    }
+    return &point_groups[g->point_group];
+}
+
+/* split_symbol(): reads the parts of a space group symbol 's', without its
+ * lattice letter, into 'sp'.  Glide planes become mirrors and screw axes
+ * rotations, so "21/c" is read as "2/m".  In a symbol written with blanks
+ * between its parts a digit after a rotation is its screw component, but
+ * in a compact symbol such as "P4212" it may be the next part.  Each such
+ * digit of a compact symbol is a choice, and bit k of 'no_screw' makes the
+ * k-th of them the next part.  'screws' is 0 for the R lattice, which has
+ * no screw axes.  Returns the number of choices met, or -1 if the symbol
+ * can't be read.
+ */
+static int split_symbol( struct symbol_parts *sp, const char *s, int compact, int screws,
+                         unsigned int no_screw )
+{
+    char *out;
+    int k, axis, n_choices = 0;
+
+    sp->n = 0;
+    while( '\0' != *s ) {
+        if( isspace( (unsigned char)*s ) ) {
+            s++;
+            continue;
+        }
+        if( sp->n >= MAX_SYMBOL_PARTS ) {
+            return -1;
+        }
+        out = sp->part[sp->n++];
+        if( NULL != strchr( "abcdenm", tolower( (unsigned char)*s ) ) ) {
+            strcpy( out, "m" );
+            s++;
+            continue;
+        }
+        k = 0;
+        if( '-' == *s ) {
+            out[k++] = *s++;
+        }
+        if( ('\0' == *s) || (NULL == strchr( "12346", *s )) ) {
+            return -1;
+        }
+        axis = *s;
+        out[k++] = *s++;
+
+/* the screw component, e.g. the 1 of 41 or 4_1 */
+        if( ('_' == *s) && screws && ('-' != out[0]) && isdigit( (unsigned char)s[1] ) && (s[1] < axis) ) {
+            s += 2;
+        }
+        else if( screws && ('-' != out[0]) && ('1' <= *s) && (*s < axis) ) {
+            if( !compact ) {
+                s++;
+            }
+            else {
+                if( !(no_screw & (1u << n_choices)) ) {
+                    s++;
+                }
+                n_choices++;
+            }
+        }
+        if( '/' == *s ) {
+            s++;
+            if( ('\0' == *s) || (NULL == strchr( "abcdenm", tolower( (unsigned char)*s ) )) ) {
+                return -1;
+            }
+            s++;
+            out[k++] = '/';
+            out[k++] = 'm';
+        }
+        out[k] = '\0';
+    }
+    return n_choices;
+}
+
+/* parts_point_group(): the catalogue entry for the point group whose
+ * elements are 'sp', or NULL if they are not a point group symbol.  A
+ * monoclinic full symbol, e.g. 1 2/m 1, gives the unique axis as the
+ * setting.  In the orthorhombic and cubic symbols, and after the first
+ * part of the others, 2/m is written m, as in mmm, 4/mmm and m-3m.  The
+ * old cubic symbols, e.g. m3m, are read as m-3m.
+ */
+static const struct point_group *parts_point_group( struct symbol_parts *sp, int lattice )
+{
+    static const char axes[] = "abc";
+    char key[MAX_GROUP_KEY_LEN], setting[2];
+    int i, n_ones = 0, other = 0, cubic;
+
+    if( 1 == sp->n ) {
+        return lookup_point_group( sp->part[0], NULL );
+    }
+    if( 3 == sp->n ) {
+        for( i = 0; i < 3; i++ ) {
+             if( 0 == strcmp( sp->part[i], "1" ) ) {
+                 n_ones++;
+             }
+             else {
+                 other = i;
+             }
+        }
+        if( 2 == n_ones ) {
+            setting[0] = axes[other];
+            setting[1] = '\0';
+            return lookup_point_group( sp->part[other], setting );
+        }
+    }
+
+/* only the cubic groups, and those of the R lattice, have two parts */
+    cubic = (sp->n >= 2) && ((0 == strcmp( sp->part[1], "3" )) || (0 == strcmp( sp->part[1], "-3" )));
+    if( (sp->n < 2) || (sp->n > 3) || ((2 == sp->n) && !cubic && ('R' != lattice)) ) {
+        return NULL;
+    }
+    if( cubic && (0 == strcmp( sp->part[1], "3" )) && (NULL != strchr( sp->part[0], 'm' )) ) {
+        strcpy( sp->part[1], "-3" );
+    }
+    key[0] = '\0';
+    for( i = 0; i < sp->n; i++ ) {
+         if( (cubic || (i > 0) || (3 == sp->n)) && (0 == strcmp( sp->part[i], "2/m" )) ) {
+             strcpy( sp->part[i], "m" );
+         }
+         if( cubic && (0 == strcmp( sp->part[i], "4/m" )) ) {
+             strcpy( sp->part[i], "m" );
+         }
+         if( strlen( key ) + strlen( sp->part[i] ) >= sizeof(key) ) {
+             return NULL;
+         }
+         strcat( key, sp->part[i] );
+    }
+    return lookup_point_group( key, NULL );
+}
+
+/* space_group_point_group(): the point group of a space group from its
+ * Hermann-Mauguin symbol, as written in PDB CRYST1 records and CIFs, e.g.
+ * "P 1 21/c 1", "P 43 21 2", "I 41/a", "R -3 m :H" or compact, "P212121".
+ * The lattice letter is returned in 'lattice' (H, the PDB's hexagonal
+ * setting of R, is returned as R), and an origin or axes choice after a
+ * ':' or '(' is ignored.  A compact symbol can often be read more than one
+ * way, e.g. "P321" as P 3 2 1 or P 32 1, so the readings are tried in turn,
+ * screw axes first, until one is a point group symbol.  Returns the
+ * catalogue entry in the setting of the symbol, or NULL if the symbol
+ * can't be read or its setting isn't in the catalogue.
+ */
+const struct point_group *space_group_point_group( const char *symbol, char *lattice )
+{
+    struct symbol_parts sp;
+    const struct point_group *pg;
+    char buf[MAX_SPACE_GROUP_LEN];
+    unsigned int no_screw;
+    int trial, n_choices, compact, L;
+    size_t n;
+
+    while( isspace( (unsigned char)*symbol ) ) {
+        symbol++;
+    }
+    L = toupper( (unsigned char)*symbol );
+    if( ('\0' == L) || (NULL == strchr( "PABCIFRH", L )) ) {
+        return NULL;
+    }
+    if( 'H' == L ) {
+        L = 'R';
+    }
+    symbol++;
+    while( isspace( (unsigned char)*symbol ) ) {
+        symbol++;
+    }
+    n = strcspn( symbol, ":(" );
+    if( n >= sizeof(buf) ) {
+        return NULL;
+    }
+    memcpy( buf, symbol, n );
+    buf[n] = '\0';
+    while( (n > 0) && isspace( (unsigned char)buf[n-1] ) ) {
+        buf[--n] = '\0';
+    }
+    compact = NULL == strpbrk( buf, " \t" );
+
+/* the readings are tried depth first, the last choice changed first */
+    no_screw = 0;
+    for( trial = 0; trial < MAX_SYMBOL_TRIALS; trial++ ) {
+         n_choices = split_symbol( &sp, buf, compact, 'R' != L, no_screw );
+         if( n_choices >= 0 ) {
+             pg = parts_point_group( &sp, L );
+             if( NULL != pg ) {
+                 *lattice = (char)L;
+                 return pg;
+             }
+         }
+         else if( compact ) {  /* too many parts, which another reading may not have */
+             n_choices = MAX_SYMBOL_PARTS;
+         }
+         else {
+             break;
+         }
+         while( (n_choices > 0) && (no_screw & (1u << (n_choices - 1))) ) {
+             n_choices--;
+         }
+         if( 0 == n_choices ) {
+             break;
+         }
+         no_screw = (no_screw & ((1u << (n_choices - 1)) - 1)) | (1u << (n_choices - 1));
+    }
+    return NULL;
+}
@@ -0,0 +1,71 @@
+/* contains public interface for the catalogue of the 32 crystallographic
+ * point groups used by the Flack left coset decomposition program which
+ * uses alogorithms outlined in Acta Cryst. (1987), A43, 564-568, by
+ * H. D. Flack.
+ *
+ * The catalogue and the group name hash table are written at build time
+ * by the gen_cayley program (see gen_cayley.c) into cayley_tables.c.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef POINT_GROUP_H
+#define POINT_GROUP_H
+
+/* a point group in a standard setting.  The operators are encoded the way
+ * rmat() stores a subgroup, i.e. as the inverse transpose of the direct
+ * space matrices of the International Tables, with the identity first.
+ */
+struct point_group {
+       const char *key;          /* name used in the input file, see below */
+       const char *symbol;       /* full Hermann-Mauguin symbol of the setting */
+       int order;
+       const unsigned int *bcm;
+       };
+
+/* an entry of the group name hash table, which is indexed by strhash()
+ * (see dupstr.c) of the key modulo group_name_hash_size.  The key is the
+ * point group's name, optionally followed by a blank and a setting (the
+ * unique axis of the monoclinic groups, e.g. "2/m c").  Supergroup names
+ * are in the same table.
+ */
+struct group_name {
+       const char *key;
+       int supergroup;           /* id for select_symm_ops(), or -1 */
+       int point_group;          /* index into point_groups[], or -1 */
+       };
+
+/* these are defined in the generated file cayley_tables.c */
+extern const struct point_group point_groups[];
+extern const int n_point_groups;
+extern const struct group_name group_names[];
+extern const signed char group_name_hash[];  /* index into group_names[], or -1 */
+extern const unsigned int group_name_hash_size;
+
+#define MAX_GROUP_KEY_LEN 16
+#define MAX_SPACE_GROUP_LEN 32
+
+/* prototypes */
+const struct group_name *lookup_group_name( const char *name, const char *setting );
+const struct point_group *lookup_point_group( const char *name, const char *setting );
+const struct point_group *space_group_point_group( const char *symbol, char *lattice );
+
+#endif
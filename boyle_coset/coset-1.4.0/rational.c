@@ -0,0 +1,423 @@
+/* contains implementation for exact rational 3x3 matrices (see rational.h)
+ * for the Flack left coset decomposition program which uses alogorithms
+ * outlined in Acta Cryst. (1987), A43, 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifdef NEED_C89_COMPATIBILITY
+#undef _ISOC99_SOURCE
+#else
+#define _ISOC99_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#ifdef NEED_C89_COMPATIBILITY
+#include "c89_util.h"
+#endif
+
+#include "symm_mat.h"
+#include "bcm.h"
+#include "rational.h"
+
+#define RAT_ABS(x)  ((x) < 0 ? -(x) : (x))
+
+static rat_int gcd( rat_int a, rat_int b )
+{
+    rat_int r;
+
+    a = RAT_ABS( a );
+    b = RAT_ABS( b );
+    while( 0 != b ) {
+           r = a % b;
+           a = b;
+           b = r;
+    }
+    return a;
+}
+
+/* normalize(): makes the denominator positive and reduces the matrix to
+ * lowest terms.  Returns -1 if the denominator is zero or the result is
+ * outside of RAT_MAX_VALUE.
+ */
+static int normalize( struct rat_matrix *m )
+{
+    rat_int g;
+    int i, j;
+
+    if( 0 == m->den ) {
+        return -1;
+    }
+    g = m->den;
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              g = gcd( g, m->num[i][j] );
+         }
+    }
+    if( m->den < 0 ) {
+        g = -g;
+    }
+    m->den /= g;
+    if( m->den > RAT_MAX_VALUE ) {
+        return -1;
+    }
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              m->num[i][j] /= g;
+              if( RAT_ABS( m->num[i][j] ) > RAT_MAX_VALUE ) {
+                  return -1;
+              }
+         }
+    }
+    return 0;
+}
+
+static rat_int determinant3( rat_int n[3][3] )
+{
+    return n[0][0] * (n[1][1] * n[2][2] - n[1][2] * n[2][1]) -
+           n[0][1] * (n[1][0] * n[2][2] - n[1][2] * n[2][0]) +
+           n[0][2] * (n[1][0] * n[2][1] - n[1][1] * n[2][0]);
+}
+
+/* adjugate(): the transposed cofactor matrix, so that n * adj = det(n) * I */
+static void adjugate( rat_int adj[3][3], rat_int n[3][3] )
+{
+    int i, j;
+
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              int r1 = (j + 1) % 3, r2 = (j + 2) % 3,
+                  c1 = (i + 1) % 3, c2 = (i + 2) % 3;
+
+              adj[i][j] = n[r1][c1] * n[r2][c2] - n[r1][c2] * n[r2][c1];
+         }
+    }
+    return;
+}
+
+static void multiply3( rat_int ab[3][3], rat_int a[3][3], rat_int b[3][3] )
+{
+    int i, j, k;
+
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              ab[i][j] = 0;
+              for( k = 0; k < 3; k++ ) {
+                   ab[i][j] += a[i][k] * b[k][j];
+              }
+         }
+    }
+    return;
+}
+
+/* snap(): the fraction with the smallest denominator which is close enough
+ * to 'x', see RAT_SNAP_TOLERANCE.  Returns -1 if there is none.
+ */
+static int snap( double x, rat_int *num, rat_int *den )
+{
+    double y, diff;
+    rat_int d;
+
+    for( d = 1; d <= RAT_SNAP_DEN; d++ ) {
+         y = x * (double)d;
+         if( (y > (double)RAT_MAX_VALUE + 0.5) || (y < -(double)RAT_MAX_VALUE - 0.5) ) {
+             return -1;
+         }
+         *num = (rat_int)(y < 0.0 ? y - 0.5 : y + 0.5);
+         diff = x - (double)*num / (double)d;
+         if( (diff < RAT_SNAP_TOLERANCE) && (diff > -RAT_SNAP_TOLERANCE) ) {
+             *den = d;
+             return 0;
+         }
+    }
+    return -1;
+}
+
+/* rat_parse(): reads a number written as an integer ("-1"), a fraction
+ * ("1/3") or a decimal ("0.3333").  Decimals are snapped to the nearest
+ * small fraction.  Returns 0 on success, -1 if the string is not such a
+ * number.
+ */
+int rat_parse( const char *s, rat_int *num, rat_int *den )
+{
+    char *end;
+    long n, d;
+    double x;
+    rat_int g;
+
+    n = strtol( s, &end, 10 );
+    if( (end != s) && isdigit( (unsigned char)end[-1] ) ) {
+        if( '\0' == *end ) {
+            d = 1;
+        }
+        else if( ('/' == *end) && isdigit( (unsigned char)end[1] ) ) {
+            d = strtol( end + 1, &end, 10 );
+            if( ('\0' != *end) || (0 == d) ) {
+                return -1;
+            }
+        }
+        else {
+            goto decimal;
+        }
+        if( (n > RAT_MAX_VALUE) || (n < -RAT_MAX_VALUE) || (d > RAT_MAX_VALUE) ) {
+            return -1;
+        }
+        g = gcd( n, d );
+        *num = n / g;
+        *den = d / g;
+        return 0;
+    }
+
+decimal:
+    x = strtod( s, &end );
+    if( (end == s) || ('\0' != *end) ) {
+        return -1;
+    }
+    return snap( x, num, den );
+}
+
+/* rat_format(): writes a number in lowest terms the way rat_parse() reads it */
+int rat_format( char *buf, size_t len, rat_int num, rat_int den )
+{
+    rat_int g;
+
+    g = gcd( num, den );
+    num /= g;
+    den /= g;
+    if( 1 == den ) {
+        return snprintf( buf, len, "%ld", (long)num );
+    }
+    return snprintf( buf, len, "%ld/%ld", (long)num, (long)den );
+}
+
+/* rat_matrix_set(): builds a matrix from nine fractions num[i][j]/den[i][j],
+ * which are put over their least common denominator.  Returns -1 if a
+ * denominator is zero or the result is outside of RAT_MAX_VALUE.
+ */
+int rat_matrix_set( struct rat_matrix *m, rat_int num[3][3], rat_int den[3][3] )
+{
+    rat_int lcm = 1;
+    int i, j;
+
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              if( 0 == den[i][j] ) {
+                  return -1;
+              }
+              lcm = lcm / gcd( lcm, den[i][j] ) * RAT_ABS( den[i][j] );
+              if( lcm > RAT_MAX_VALUE ) {
+                  return -1;
+              }
+         }
+    }
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              m->num[i][j] = num[i][j] * (lcm / den[i][j]);
+         }
+    }
+    m->den = lcm;
+    return normalize( m );
+}
+
+void rat_matrix_identity( struct rat_matrix *m )
+{
+    int i, j;
+
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              m->num[i][j] = (i == j) ? 1 : 0;
+         }
+    }
+    m->den = 1;
+    return;
+}
+
+/* rat_matrix_from_double(): snaps each element of 'd' to a small fraction.
+ * Returns -1 if an element can't be snapped.
+ */
+int rat_matrix_from_double( struct rat_matrix *m, double d[3][3] )
+{
+    rat_int num[3][3], den[3][3];
+    int i, j;
+
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              if( 0 != snap( d[i][j], &num[i][j], &den[i][j] ) ) {
+                  return -1;
+              }
+         }
+    }
+    return rat_matrix_set( m, num, den );
+}
+
+/* rat_matrix_to_double(): each element is the double nearest the fraction,
+ * and integers (the usual case) come out exactly.
+ */
+void rat_matrix_to_double( double d[3][3], const struct rat_matrix *m )
+{
+    int i, j;
+
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              d[i][j] = (double)m->num[i][j] / (double)m->den;
+         }
+    }
+    return;
+}
+
+void rat_matrix_from_bcm( struct rat_matrix *m, unsigned int bcm )
+{
+    int e[9], k;
+
+    bcm_unpack( bcm, e );
+    for( k = 0; k < 9; k++ ) {
+         m->num[k / 3][k % 3] = e[k];
+    }
+    m->den = 1;
+    return;
+}
+
+/* rat_matrix_encode(): the BCM of the matrix, or BCM_ERROR if it has an
+ * element other than -1, 0 or 1.
+ */
+unsigned int rat_matrix_encode( const struct rat_matrix *m )
+{
+    int e[9], k;
+
+    if( 1 != m->den ) {
+        return BCM_ERROR;
+    }
+    for( k = 0; k < 9; k++ ) {
+         if( RAT_ABS( m->num[k / 3][k % 3] ) > 1 ) {
+             return BCM_ERROR;
+         }
+         e[k] = (int)m->num[k / 3][k % 3];
+    }
+    return bcm_pack( e );
+}
+
+int rat_matrix_is_singular( const struct rat_matrix *m )
+{
+    rat_int n[3][3];
+
+    memcpy( n, m->num, sizeof(n) );
+    return 0 == determinant3( n );
+}
+
+/* rat_matrix_multiply(): ab = a * b.  Returns -1 if the product is outside
+ * of RAT_MAX_VALUE.
+ */
+int rat_matrix_multiply( struct rat_matrix *ab, const struct rat_matrix *a, const struct rat_matrix *b )
+{
+    struct rat_matrix p;
+    rat_int an[3][3], bn[3][3];
+
+    memcpy( an, a->num, sizeof(an) );
+    memcpy( bn, b->num, sizeof(bn) );
+    multiply3( p.num, an, bn );
+    p.den = a->den * b->den;
+    if( 0 != normalize( &p ) ) {
+        return -1;
+    }
+    *ab = p;
+    return 0;
+}
+
+/* rat_matrix_invert(): with m = N/d, the inverse is d * adj(N) / det(N).
+ * Returns -1 if 'm' is singular or the inverse is outside of RAT_MAX_VALUE.
+ */
+int rat_matrix_invert( struct rat_matrix *inv, const struct rat_matrix *m )
+{
+    struct rat_matrix p;
+    rat_int n[3][3];
+    int i, j;
+
+    memcpy( n, m->num, sizeof(n) );
+    p.den = determinant3( n );
+    if( 0 == p.den ) {
+        return -1;
+    }
+    adjugate( p.num, n );
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              p.num[i][j] *= m->den;
+         }
+    }
+    if( 0 != normalize( &p ) ) {
+        return -1;
+    }
+    *inv = p;
+    return 0;
+}
+
+/* rat_matrix_conjugate(): out = t * m * t^-1, the similarity transform
+ * done by transform_group().  With t = N/d and m = P/e this is
+ * N * P * adj(N) / (e * det(N)), so the denominator of 't' cancels and the
+ * whole product is a single integer matrix product followed by one exact
+ * division.  Returns -1 if 't' is singular or the result is outside of
+ * RAT_MAX_VALUE.
+ */
+int rat_matrix_conjugate( struct rat_matrix *out, const struct rat_matrix *t, const struct rat_matrix *m )
+{
+    struct rat_matrix p;
+    rat_int n[3][3], adj[3][3], mn[3][3], tmp[3][3];
+
+    memcpy( n, t->num, sizeof(n) );
+    memcpy( mn, m->num, sizeof(mn) );
+    p.den = determinant3( n ) * m->den;
+    if( 0 == p.den ) {
+        return -1;
+    }
+    adjugate( adj, n );
+    multiply3( tmp, mn, adj );
+    multiply3( p.num, n, tmp );
+    if( 0 != normalize( &p ) ) {
+        return -1;
+    }
+    *out = p;
+    return 0;
+}
+
+/* rat_matrix_format(): writes the nine elements in row major order,
+ * separated by blanks, in the form accepted on a TRANS line.
+ */
+int rat_matrix_format( char *buf, size_t len, const struct rat_matrix *m )
+{
+    char elem[RAT_FORMAT_LEN];
+    size_t used = 0;
+    int k, n;
+
+    if( len > 0 ) {
+        buf[0] = '\0';
+    }
+    for( k = 0; k < 9; k++ ) {
+         rat_format( elem, sizeof(elem), m->num[k / 3][k % 3], m->den );
+         n = snprintf( buf + used, len - used, "%s%s", 0 == k ? "" : " ", elem );
+         if( (n < 0) || ((size_t)n >= len - used) ) {
+             return -1;
+         }
+         used += (size_t)n;
+    }
+    return (int)used;
+}
@@ -0,0 +1,79 @@
+/* contains public interface for exact rational 3x3 matrices used for the
+ * TRANS matrix of the Flack left coset decomposition program which uses
+ * alogorithms outlined in Acta Cryst. (1987), A43, 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef RATIONAL_H
+#define RATIONAL_H
+
+#include <stddef.h>
+
+/* A rational matrix is kept as integer numerators over one common
+ * denominator, which is always positive and in lowest terms with the
+ * numerators.  Transformation matrices for centred and rhombohedral cells
+ * have elements like 1/2 and 1/3, which are exact here but not in doubles.
+ *
+ * Numerators and the denominator are limited to RAT_MAX_VALUE, which keeps
+ * every intermediate of a similarity transform inside rat_int.  Operations
+ * whose result would exceed the limit fail rather than overflow.
+ */
+#ifdef NEED_C89_COMPATIBILITY
+typedef long rat_int;               /* at least 32 bits */
+#define RAT_MAX_VALUE  12L
+#else
+#include <stdint.h>
+typedef int64_t rat_int;
+#define RAT_MAX_VALUE  4096
+#endif
+
+/* decimal input (e.g. 0.3333) is snapped to the fraction with the smallest
+ * denominator up to RAT_SNAP_DEN which is within RAT_SNAP_TOLERANCE.
+ * Fractions with denominators up to 12 are at least 1/132 apart, so the
+ * snap is never ambiguous.
+ */
+#define RAT_SNAP_DEN        12
+#define RAT_SNAP_TOLERANCE  0.0005
+
+#define RAT_FORMAT_LEN      32
+
+struct rat_matrix {
+       rat_int num[3][3];
+       rat_int den;
+       };
+
+/* prototypes */
+int rat_parse( const char *s, rat_int *num, rat_int *den );
+int rat_format( char *buf, size_t len, rat_int num, rat_int den );
+int rat_matrix_set( struct rat_matrix *m, rat_int num[3][3], rat_int den[3][3] );
+void rat_matrix_identity( struct rat_matrix *m );
+int rat_matrix_from_double( struct rat_matrix *m, double d[3][3] );
+void rat_matrix_to_double( double d[3][3], const struct rat_matrix *m );
+void rat_matrix_from_bcm( struct rat_matrix *m, unsigned int bcm );
+unsigned int rat_matrix_encode( const struct rat_matrix *m );
+int rat_matrix_is_singular( const struct rat_matrix *m );
+int rat_matrix_multiply( struct rat_matrix *ab, const struct rat_matrix *a, const struct rat_matrix *b );
+int rat_matrix_invert( struct rat_matrix *inv, const struct rat_matrix *m );
+int rat_matrix_conjugate( struct rat_matrix *out, const struct rat_matrix *t, const struct rat_matrix *m );
+int rat_matrix_format( char *buf, size_t len, const struct rat_matrix *m );
+
+#endif
@@ -0,0 +1,127 @@
+/* contains implementation for Seitz operators (see seitz.h) for the Flack
+ * left coset decomposition program which uses alogorithms outlined in
+ * Acta Cryst. (1987), A43, 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifdef NEED_C89_COMPATIBILITY
+#undef _ISOC99_SOURCE
+#else
+#define _ISOC99_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#ifdef NEED_C89_COMPATIBILITY
+#include "c89_util.h"
+#endif
+
+#include "symm_mat.h"
+#include "bcm.h"
+#include "rational.h"
+#include "seitz.h"
+
+#define T_MASK  (((seitz_key)1 << SEITZ_T_BITS) - 1)
+
+/* reduce a translation component into 0..SEITZ_DEN-1 */
+static long reduce_t( long t )
+{
+    t %= SEITZ_DEN;
+    return t < 0 ? t + SEITZ_DEN : t;
+}
+
+/* seitz_set(): builds {bcm|t} with 't' in units of 1/SEITZ_DEN */
+void seitz_set( struct seitz_op *s, unsigned int bcm, const long t[3] )
+{
+    int i;
+
+    s->bcm = bcm;
+    for( i = 0; i < 3; i++ ) {
+         s->t[i] = reduce_t( t[i] );
+    }
+    return;
+}
+
+/* seitz_set_rational(): builds {bcm|num/den}.  Returns -1 if 'den' does not
+ * divide SEITZ_DEN, i.e. the translation can't be held exactly.
+ */
+int seitz_set_rational( struct seitz_op *s, unsigned int bcm, const rat_int num[3], rat_int den )
+{
+    long t[3];
+    int i;
+
+    if( (den <= 0) || (0 != SEITZ_DEN % den) ) {
+        return -1;
+    }
+    for( i = 0; i < 3; i++ ) {
+         t[i] = (long)(num[i] % den) * (long)(SEITZ_DEN / den);
+    }
+    seitz_set( s, bcm, t );
+    return 0;
+}
+
+seitz_key seitz_encode( const struct seitz_op *s )
+{
+    return ((seitz_key)s->bcm << (3 * SEITZ_T_BITS)) |
+           ((seitz_key)s->t[0] << (2 * SEITZ_T_BITS)) |
+           ((seitz_key)s->t[1] << SEITZ_T_BITS) |
+            (seitz_key)s->t[2];
+}
+
+void seitz_decode( seitz_key k, struct seitz_op *s )
+{
+    s->bcm = (unsigned int)(k >> (3 * SEITZ_T_BITS));
+    s->t[0] = (long)((k >> (2 * SEITZ_T_BITS)) & T_MASK);
+    s->t[1] = (long)((k >> SEITZ_T_BITS) & T_MASK);
+    s->t[2] = (long)(k & T_MASK);
+    return;
+}
+
+/* seitz_multiply(): {Ra|ta}{Rb|tb} = {Ra*Rb|Ra*tb + ta}.  'ab' may be the
+ * same as 'a' or 'b'.
+ */
+void seitz_multiply( struct seitz_op *ab, const struct seitz_op *a, const struct seitz_op *b )
+{
+    long t[3];
+    int i, j;
+
+    for( i = 0; i < 3; i++ ) {
+         t[i] = a->t[i];
+         for( j = 0; j < 3; j++ ) {
+              t[i] += bcm_element( a->bcm, i, j ) * b->t[j];
+         }
+    }
+    seitz_set( ab, bcm_multiply( a->bcm, b->bcm ), t );
+    return;
+}
+
+/* seitz_format_translation(): writes the translation as three fractions */
+int seitz_format_translation( char *buf, size_t len, const struct seitz_op *s )
+{
+    char f[3][RAT_FORMAT_LEN];
+    int i;
+
+    for( i = 0; i < 3; i++ ) {
+         rat_format( f[i], sizeof(f[i]), s->t[i], SEITZ_DEN );
+    }
+    return snprintf( buf, len, "%s %s %s", f[0], f[1], f[2] );
+}
@@ -0,0 +1,66 @@
+/* contains public interface for Seitz operators (a rotation plus a
+ * translation) for the Flack left coset decomposition program which uses
+ * alogorithms outlined in Acta Cryst. (1987), A43, 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef SEITZ_H
+#define SEITZ_H
+
+#include <stddef.h>
+
+#include "rational.h"
+
+/* A Seitz operator {R|t} maps x to R*x + t.  R is a BCM (see bcm.h) and
+ * the translation is reduced modulo lattice vectors and kept in units of
+ * 1/SEITZ_DEN, which is the least common multiple of 1..12, so fractional
+ * translations with any denominator up to 12 are exact.
+ *
+ * seitz_key packs an operator into one word: the 18 bits of the BCM above
+ * three 15 bit translation components.  Two operators are equal (modulo
+ * lattice translations) exactly when their keys are equal.
+ */
+#define SEITZ_DEN         27720
+#define SEITZ_T_BITS      15
+#define SEITZ_MAX_DEN     12
+
+#ifdef NEED_C89_COMPATIBILITY
+typedef unsigned long seitz_key;    /* must be at least 63 bits */
+#else
+#include <stdint.h>
+typedef uint64_t seitz_key;
+#endif
+
+struct seitz_op {
+       unsigned int bcm;
+       long t[3];                   /* 0 <= t[i] < SEITZ_DEN */
+       };
+
+/* prototypes */
+void seitz_set( struct seitz_op *s, unsigned int bcm, const long t[3] );
+int seitz_set_rational( struct seitz_op *s, unsigned int bcm, const rat_int num[3], rat_int den );
+seitz_key seitz_encode( const struct seitz_op *s );
+void seitz_decode( seitz_key k, struct seitz_op *s );
+void seitz_multiply( struct seitz_op *ab, const struct seitz_op *a, const struct seitz_op *b );
+int seitz_format_translation( char *buf, size_t len, const struct seitz_op *s );
+
+#endif
@@ -221,20 +221,27 @@ static SLinkedList *shelx_insert_twin_ins( char *twin, SLinkedList *s )
 
 
 
-SLinkedList *twin_ins_list( struct symm_op *s )
+/* twin_ins_list(): the BASF and TWIN instructions for the twin laws 'laws'
+ * of 'g', in the order of the group, or if 'order' isn't NULL in the order
+ * of the positions it lists, which end with -1 (see twin_law_order()).
+ */
+SLinkedList *twin_ins_list( const struct symm_group *g, group_mask laws, const int *order )
 {
     SLinkedList *list = NULL;
     char *tp;    
+    double mat[3][3];
 
-    int i;
+    int i, k;
 
     list = alloc_list_init( list, free );
     if( NULL == list )
         return NULL;
 
-    for( i = 0; 0 != s[i].bcm; i++ ) {
-         if( True == s[i].truefalse ) {
-             tp = format_shelx_twin_instruction( s[i].mat, s[i].n_fold );
+    for( k = 0; NULL != order ? order[k] >= 0 : k < g->n; k++ ) {
+         i = NULL != order ? order[k] : k;
+         if( mask_has( laws, i ) ) {
+             symm_group_matrix( g, i, mat );
+             tp = format_shelx_twin_instruction( mat, NULL != g->cold ? g->cold[i].n_fold : 0 );
              sll_insert_next( list, sll_list_tail(list), tp );
          }
     }
@@ -284,6 +291,36 @@ SLinkedList *read_shelx_ins_file( char *ins_file_name )
     return ins_list;
 }
 
+/* read_shelx_cell(): the cell from the CELL card of a SHELX .ins file.
+ * Returns 0, or -1 if the file can't be read or has no valid CELL card.
+ */
+int read_shelx_cell( const char *ins_file_name, struct unit_cell *c )
+{
+    FILE *ins;
+    char line[SHELX_LINE_LEN];
+    int i, ret = -1;
+#ifdef USE_NONSTANDARD_FOPEN
+    const char *mode = "rt";
+#else  /* use only ANSI C Standard mode */
+    const char *mode = "r";
+#endif
+
+    ins = fopen( ins_file_name, mode );
+    if( NULL == ins ) {
+        return -1;
+    }
+    while( (0 != ret) && (NULL != fgets( line, (int)sizeof(line), ins )) ) {
+           for( i = 0; (i < 4) && ('\0' != line[i]); i++ ) {
+                line[i] = toupper( line[i] );
+           }
+           if( (0 == strncmp( line, "CELL", 4 )) && isspace( (unsigned char)line[4] ) ) {
+               ret = cell_from_string( c, line + 4 );
+           }
+    }
+    fclose( ins );
+    return ret;
+}
+
 char *get_basename( char *filename, int delim_char )
 {
     char *p0, *p1, *p2;
@@ -41,13 +41,16 @@
 #define SHELX_LINE_LEN  80
 
 #include "symm_mat.h"
+#include "symm_group.h"
 #include "sll.h"
 #include "dynamic_sll.h"
+#include "twin_metric.h"
 
 /* prototypes */
 struct symm_op *pick_twin_laws( struct symm_op *s );
-SLinkedList *twin_ins_list( struct symm_op *s );
+SLinkedList *twin_ins_list( const struct symm_group *g, group_mask laws, const int *order );
 SLinkedList *read_shelx_ins_file( char *ins_file_name );
+int read_shelx_cell( const char *ins_file_name, struct unit_cell *c );
 char *get_basename(char *filename, int delim_char);
 SLinkedList *write_new_ins_files( char *base_name, SLinkedList *twin_laws, SLinkedList *ins );
 
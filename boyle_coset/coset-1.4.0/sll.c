@@ -96,7 +96,7 @@ int sll_remove_next( SLinkedList *list, SLinkedListElem *elem, void **data )
        *data = list->head->data;
        old_elem = list->head;
        list->head = list->head->next;
-       if( 0 == sll_list_size(list) )
+       if( NULL == list->head )   /* removed the only element */
             list->tail = NULL;
     }
     else {  /* handle removal from elsewhere in the list */
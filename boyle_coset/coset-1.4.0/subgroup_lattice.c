@@ -0,0 +1,288 @@
+/* contains implementation for the subgroup lattice enumerator for the
+ * Flack left coset decomposition program which uses alogorithms outlined
+ * in Acta Cryst. (1987), A43, 564-568, by H. D. Flack.
+ *
+ * Every subgroup of a holohedry is found by closure over the encoded
+ * operators: starting from the trivial group, each subgroup found so far
+ * is extended by one operator at a time and the closure of the result is
+ * added if it is new.  All of the work is done on group masks with the
+ * build time multiplication tables, so no floating point matrices are
+ * involved.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifdef NEED_C89_COMPATIBILITY
+#undef _ISOC99_SOURCE
+#else
+#define _ISOC99_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "symm_mat.h"
+#include "bcm.h"
+#include "cayley.h"
+#include "group_mask.h"
+#include "subgroup_lattice.h"
+
+#define LINE_WIDTH 79
+
+/* kinds of operator, from the determinant and trace of the matrix */
+enum { OP_1, OP_2, OP_3, OP_4, OP_6, OP_BAR1, OP_M, OP_BAR3, OP_BAR4, OP_BAR6, N_OP_KINDS };
+
+/* the geometric crystal class of a point group is fixed by how many
+ * operators of each kind it has.  Classes which differ only in their
+ * orientation (e.g. -42m and -4m2) are given their usual symbol.
+ */
+struct class_signature {
+       const char *name;
+       unsigned char n[N_OP_KINDS];  /* 1 2 3 4 6 -1 m -3 -4 -6 */
+       };
+
+static const struct class_signature classes[] = {
+       { "1",     { 1, 0, 0, 0, 0, 0, 0, 0, 0, 0 } },
+       { "-1",    { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0 } },
+       { "2",     { 1, 1, 0, 0, 0, 0, 0, 0, 0, 0 } },
+       { "m",     { 1, 0, 0, 0, 0, 0, 1, 0, 0, 0 } },
+       { "2/m",   { 1, 1, 0, 0, 0, 1, 1, 0, 0, 0 } },
+       { "222",   { 1, 3, 0, 0, 0, 0, 0, 0, 0, 0 } },
+       { "mm2",   { 1, 1, 0, 0, 0, 0, 2, 0, 0, 0 } },
+       { "mmm",   { 1, 3, 0, 0, 0, 1, 3, 0, 0, 0 } },
+       { "4",     { 1, 1, 0, 2, 0, 0, 0, 0, 0, 0 } },
+       { "-4",    { 1, 1, 0, 0, 0, 0, 0, 0, 2, 0 } },
+       { "4/m",   { 1, 1, 0, 2, 0, 1, 1, 0, 2, 0 } },
+       { "422",   { 1, 5, 0, 2, 0, 0, 0, 0, 0, 0 } },
+       { "4mm",   { 1, 1, 0, 2, 0, 0, 4, 0, 0, 0 } },
+       { "-42m",  { 1, 3, 0, 0, 0, 0, 2, 0, 2, 0 } },
+       { "4/mmm", { 1, 5, 0, 2, 0, 1, 5, 0, 2, 0 } },
+       { "3",     { 1, 0, 2, 0, 0, 0, 0, 0, 0, 0 } },
+       { "-3",    { 1, 0, 2, 0, 0, 1, 0, 2, 0, 0 } },
+       { "32",    { 1, 3, 2, 0, 0, 0, 0, 0, 0, 0 } },
+       { "3m",    { 1, 0, 2, 0, 0, 0, 3, 0, 0, 0 } },
+       { "-3m",   { 1, 3, 2, 0, 0, 1, 3, 2, 0, 0 } },
+       { "6",     { 1, 1, 2, 0, 2, 0, 0, 0, 0, 0 } },
+       { "-6",    { 1, 0, 2, 0, 0, 0, 1, 0, 0, 2 } },
+       { "6/m",   { 1, 1, 2, 0, 2, 1, 1, 2, 0, 2 } },
+       { "622",   { 1, 7, 2, 0, 2, 0, 0, 0, 0, 0 } },
+       { "6mm",   { 1, 1, 2, 0, 2, 0, 6, 0, 0, 0 } },
+       { "-6m2",  { 1, 3, 2, 0, 0, 0, 4, 0, 0, 2 } },
+       { "6/mmm", { 1, 7, 2, 0, 2, 1, 7, 2, 0, 2 } },
+       { "23",    { 1, 3, 8, 0, 0, 0, 0, 0, 0, 0 } },
+       { "m-3",   { 1, 3, 8, 0, 0, 1, 3, 8, 0, 0 } },
+       { "432",   { 1, 9, 8, 6, 0, 0, 0, 0, 0, 0 } },
+       { "-43m",  { 1, 3, 8, 0, 0, 0, 6, 0, 6, 0 } },
+       { "m-3m",  { 1, 9, 8, 6, 0, 1, 9, 8, 6, 0 } }
+       };
+
+static int op_kind( unsigned int bcm )
+{
+    static const int proper[] = { OP_2, OP_3, OP_4, OP_6, OP_1 };         /* trace -1..3 */
+    static const int improper[] = { OP_BAR1, OP_BAR6, OP_BAR4, OP_BAR3, OP_M }; /* trace -3..1 */
+    int tr;
+
+    tr = bcm_trace( bcm );
+    if( 1 == bcm_determinant( bcm ) ) {
+        return (tr >= -1) && (tr <= 3) ? proper[tr + 1] : -1;
+    }
+    return (tr >= -3) && (tr <= 1) ? improper[tr + 3] : -1;
+}
+
+/* point_group_class(): the Hermann-Mauguin symbol of the crystal class of
+ * the subgroup 'm', or "?" if it is not a crystallographic point group.
+ */
+const char *point_group_class( const struct cayley_table *t, group_mask m )
+{
+    unsigned char n[N_OP_KINDS] = { 0 };
+    int i, kind;
+    size_t c;
+
+    for( i = 0; i < t->order; i++ ) {
+         if( mask_has( m, i ) ) {
+             kind = op_kind( t->bcm[i] );
+             if( kind < 0 ) {
+                 return "?";
+             }
+             n[kind]++;
+         }
+    }
+
+    for( c = 0; c < sizeof( classes ) / sizeof( classes[0] ); c++ ) {
+         if( 0 == memcmp( n, classes[c].n, sizeof( n ) ) ) {
+             return classes[c].name;
+         }
+    }
+    return "?";
+}
+
+/* subgroups are listed by increasing order, then by their operators */
+static int compare_subgroups( const void *a, const void *b )
+{
+    group_mask ma = *(const group_mask *)a,
+               mb = *(const group_mask *)b;
+    int oa = mask_order( ma ),
+        ob = mask_order( mb );
+
+    if( oa != ob ) {
+        return oa < ob ? -1 : 1;
+    }
+    return ma == mb ? 0 : (ma < mb ? -1 : 1);
+}
+
+/* enumerate_subgroups(): fills 'sub' with the masks of all the subgroups
+ * of the supergroup, the trivial group first and the supergroup last.
+ * Returns the number of subgroups, or -1 if there are more than 'max_sub'.
+ */
+int enumerate_subgroups( const struct cayley_table *t, group_mask *sub, int max_sub )
+{
+    group_mask candidates, c;
+    int n, s, k;
+
+    if( max_sub < 1 ) {
+        return -1;
+    }
+    n = 0;
+    sub[n++] = mask_bit( t->identity );
+
+    for( s = 0; s < n; s++ ) {
+         candidates = mask_difference( mask_full( t ), sub[s] );
+         while( EMPTY_MASK != candidates ) {
+                c = mask_closure( t, sub[s] | mask_bit( mask_lowest( candidates ) ) );
+                candidates &= candidates - 1;
+                for( k = 0; (k < n) && (sub[k] != c); k++ )
+                     ;
+                if( k == n ) {
+                    if( n == max_sub ) {
+                        return -1;
+                    }
+                    sub[n++] = c;
+                }
+         }
+    }
+
+    qsort( sub, n, sizeof( *sub ), compare_subgroups );
+    return n;
+}
+
+/* print the positions of the operators in 'm' as a list, wrapped to
+ * LINE_WIDTH with continuation lines indented by 'indent' columns.
+ */
+static void print_positions( FILE *out, group_mask m, int column, int indent )
+{
+    int i;
+
+    for( i = 0; EMPTY_MASK != m; m >>= 1, i++ ) {
+         if( m & 1 ) {
+             if( column + 3 > LINE_WIDTH ) {
+                 column = fprintf( out, "\n%*s", indent, "" ) - 1;
+             }
+             column += fprintf( out, " %2d", i );
+         }
+    }
+    fputc( '\n', out );
+    return;
+}
+
+/* print_subgroup_lattice(): prints a table of all the subgroups H of the
+ * supergroup G, with the first operator of each left coset of H in G as
+ * found by Flack's algorithm A (i.e. the twin laws), followed by a list of
+ * the intermediate groups H < K < G for each subgroup.
+ * Returns the number of subgroups, or -1 on error.
+ */
+int print_subgroup_lattice( FILE *out, const struct cayley_table *t )
+{
+    group_mask sub[MAX_SUBGROUPS], reps;
+    int n, i, k, column;
+
+    n = enumerate_subgroups( t, sub, MAX_SUBGROUPS );
+    if( n < 0 ) {
+        fprintf( stderr, "%s:%d: %s has more than %d subgroups\n", __FILE__, __LINE__,
+                          t->name, MAX_SUBGROUPS );
+        return -1;
+    }
+
+    fprintf( out, "Subgroup lattice of %s (order %d): %d subgroups\n\n", t->name, t->order, n );
+    fprintf( out, "  No. Class  Order Centric Index  Twin laws (supergroup operator numbers)\n" );
+    for( i = 0; i < n; i++ ) {
+         reps = mask_difference( mask_coset_representatives( t, sub[i] ), mask_bit( t->identity ) );
+         column = fprintf( out, "%5d %-6s %5d %-7s %5d ", i + 1, point_group_class( t, sub[i] ),
+                           mask_order( sub[i] ), mask_is_centric( t, sub[i] ) ? "yes" : "no",
+                           t->order / mask_order( sub[i] ) );
+         if( EMPTY_MASK == reps ) {
+             fputs( " none\n", out );
+         }
+         else {
+             print_positions( out, reps, column, column );
+         }
+    }
+
+    fprintf( out, "\nIntermediate groups K (H < K < %s) by subgroup number:\n", t->name );
+    for( i = 0; i < n - 1; i++ ) {
+         int found = 0;
+
+         column = fprintf( out, "%5d %-6s:", i + 1, point_group_class( t, sub[i] ) );
+         for( k = i + 1; k < n - 1; k++ ) {
+              if( EMPTY_MASK == mask_difference( sub[i], sub[k] ) ) {
+                  if( column + 4 > LINE_WIDTH ) {
+                      column = fprintf( out, "\n%13s", "" ) - 1;
+                  }
+                  column += fprintf( out, " %3d", k + 1 );
+                  found = 1;
+              }
+         }
+         fputs( found ? "\n" : " none (maximal subgroup)\n", out );
+    }
+    fputc( '\n', out );
+    return n;
+}
+
+/* subgroup_lattice_mode(): prints the subgroup lattices of the named
+ * supergroups, or of all of them if 'n_names' is zero.  Returns 0 if
+ * everything is OK, -1 otherwise.
+ */
+int subgroup_lattice_mode( FILE *out, int n_names, char **names )
+{
+    const struct cayley_table *t;
+    int i, ret = 0;
+
+    if( 0 == n_names ) {
+        for( i = 0; i < n_cayley_tables; i++ ) {
+             if( print_subgroup_lattice( out, &cayley_tables[i] ) < 0 ) {
+                 ret = -1;
+             }
+        }
+        return ret;
+    }
+
+    for( i = 0; i < n_names; i++ ) {
+         t = lookup_cayley_table( lookup_supergroup( names[i] ) );
+         if( NULL == t ) {
+             fprintf( stderr, "%s is not an allowed supergroup\n", names[i] );
+             ret = -1;
+             continue;
+         }
+         if( print_subgroup_lattice( out, t ) < 0 ) {
+             ret = -1;
+         }
+    }
+    return ret;
+}
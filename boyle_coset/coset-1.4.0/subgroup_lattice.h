@@ -0,0 +1,42 @@
+/* contains public interface for the subgroup lattice enumerator for the
+ * Flack left coset decomposition program which uses alogorithms outlined
+ * in Acta Cryst. (1987), A43, 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef SUBGROUP_LATTICE_H
+#define SUBGROUP_LATTICE_H
+
+#include <stdio.h>
+
+#include "cayley.h"
+#include "group_mask.h"
+
+#define MAX_SUBGROUPS 128   /* m-3m, the largest holohedry, has 98 subgroups */
+
+/* prototypes */
+int enumerate_subgroups( const struct cayley_table *t, group_mask *sub, int max_sub );
+const char *point_group_class( const struct cayley_table *t, group_mask m );
+int print_subgroup_lattice( FILE *out, const struct cayley_table *t );
+int subgroup_lattice_mode( FILE *out, int n_names, char **names );
+
+#endif
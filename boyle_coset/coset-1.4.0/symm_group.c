@@ -0,0 +1,619 @@
+/* contains implementation for symmetry groups stored as arrays of their
+ * members' fields (see symm_group.h) for the Flack left coset decomposition
+ * program which uses alogorithms outlined in Acta Cryst. (1987), A43,
+ * 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifdef NEED_C89_COMPATIBILITY
+#undef _ISOC99_SOURCE
+#else
+#define _ISOC99_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef NEED_C89_COMPATIBILITY
+#include "c89_util.h"
+#endif
+
+#include "symm_mat.h"
+#include "bcm.h"
+#include "cayley.h"
+#include "group_mask.h"
+#include "symm_group.h"
+
+/* hash_bcm(): Fibonacci hashing of an encoded matrix to a slot */
+static unsigned int hash_bcm( unsigned int bcm )
+{
+    return (unsigned int)(((bcm * 2654435761UL) & 0xffffffffUL) >> (32 - SYMM_GROUP_HASH_BITS));
+}
+
+static void set_int_matrix( struct symm_group *g, int i )
+{
+    int e[9], k;
+
+    if( bcm_is_valid( g->bcm[i] ) ) {
+        bcm_unpack( g->bcm[i], e );
+        for( k = 0; k < 9; k++ ) {
+             g->mat[i][k] = (symm_int8)e[k];
+        }
+    }
+    else {
+        memset( g->mat[i], 0, sizeof(g->mat[i]) );
+    }
+    return;
+}
+
+static void clear_analysis( struct symm_op_cold *c )
+{
+    c->n_fold = 0;
+    c->rotation_angle = 0.0f;
+    c->eig_val = 0.0;
+    c->eig_vec[0] = c->eig_vec[1] = c->eig_vec[2] = 0.0;
+    return;
+}
+
+static struct symm_op_cold *alloc_cold( void )
+{
+    errno = 0;
+    return malloc( MAX_GROUP_OPS * sizeof(struct symm_op_cold) );
+}
+
+/* alloc_symm_group(): an empty group with room for the cold fields.
+ * Returns NULL if memory can't be allocated.
+ */
+struct symm_group *alloc_symm_group( void )
+{
+    struct symm_group *g;
+
+    errno = 0;
+    g = malloc( sizeof(*g) );
+    if( NULL == g ) {
+        return NULL;
+    }
+    g->cold = alloc_cold();
+    if( NULL == g->cold ) {
+        free( g );
+        return NULL;
+    }
+    g->n = 0;
+    g->truth = EMPTY_MASK;
+    symm_group_update( g );
+    return g;
+}
+
+void free_symm_group( struct symm_group *g )
+{
+    if( NULL != g ) {
+        free( g->cold );
+        free( g );
+    }
+    return;
+}
+
+/* copy_group(): copies 'src' into 'dst', which must have the cold
+ * fields.  If 'src' has none they are made from the integer matrices.
+ */
+static void copy_group( struct symm_group *dst, const struct symm_group *src )
+{
+    struct symm_op_cold *cold;
+    int i;
+
+    cold = dst->cold;
+    *dst = *src;
+    dst->cold = cold;
+    if( NULL != src->cold ) {
+        memcpy( dst->cold, src->cold, src->n * sizeof(*src->cold) );
+        return;
+    }
+    for( i = 0; i < src->n; i++ ) {
+         symm_group_matrix( src, i, dst->cold[i].mat );
+         clear_analysis( &dst->cold[i] );
+    }
+    return;
+}
+
+/* duplicate_group(): like duplicate_ops().  The copy always has the cold
+ * fields.  Returns NULL if memory can't be allocated.
+ */
+struct symm_group *duplicate_group( const struct symm_group *g )
+{
+    struct symm_group *ret;
+
+    ret = alloc_symm_group();
+    if( NULL != ret ) {
+        copy_group( ret, g );
+    }
+    return ret;
+}
+
+/* select_supergroup(): the supergroup 'pt_group' (see lookup_supergroup()),
+ * or NULL if there is no such supergroup.  The supergroups are built from
+ * the Cayley tables the first time one is asked for, and are then shared
+ * by every task, so they must not be changed.  Their operators are all
+ * integral, so they need no cold fields.
+ */
+const struct symm_group *select_supergroup( int pt_group )
+{
+    static struct symm_group *supergroups = NULL;
+    int i;
+
+    if( NULL == supergroups ) {
+        errno = 0;
+        supergroups = malloc( n_cayley_tables * sizeof(*supergroups) );
+        if( NULL == supergroups ) {
+            return NULL;
+        }
+        for( i = 0; i < n_cayley_tables; i++ ) {
+             supergroups[i].cold = NULL;
+             symm_group_set_bcm( &supergroups[i], cayley_tables[i].bcm, cayley_tables[i].order );
+        }
+    }
+    for( i = 0; i < n_cayley_tables; i++ ) {
+         if( pt_group == cayley_tables[i].point_group ) {
+             return &supergroups[i];
+         }
+    }
+    return NULL;
+}
+
+/* released overlay copies kept for reuse */
+#define OVERLAY_POOL_SIZE 4
+static struct symm_group *overlay_pool[OVERLAY_POOL_SIZE];
+static int n_pooled = 0;
+
+/* overlay_init(): a view of 'base' with all its truth values set */
+void overlay_init( struct group_overlay *o, const struct symm_group *base )
+{
+    o->base = base;
+    o->truth = mask_below( base->n );
+    o->copy = NULL;
+    return;
+}
+
+/* overlay_group(): the operators as the task sees them */
+const struct symm_group *overlay_group( const struct group_overlay *o )
+{
+    return NULL != o->copy ? o->copy : o->base;
+}
+
+/* own_copy(): makes the task's copy of the operators before the first
+ * write.  Returns 0, or -1 if memory can't be allocated.
+ */
+static int own_copy( struct group_overlay *o )
+{
+    if( NULL != o->copy ) {
+        return 0;
+    }
+    if( n_pooled > 0 ) {
+        o->copy = overlay_pool[--n_pooled];
+    }
+    else {
+        o->copy = alloc_symm_group();
+        if( NULL == o->copy ) {
+            return -1;
+        }
+    }
+    copy_group( o->copy, o->base );
+    return 0;
+}
+
+/* overlay_transform(): transform_symm_group() on the task's copy of the
+ * operators.  Returns 0, or -1 if memory can't be allocated.
+ */
+int overlay_transform( struct group_overlay *o, const struct rat_matrix *tm )
+{
+    if( 0 != own_copy( o ) ) {
+        return -1;
+    }
+    transform_symm_group( o->copy, tm );
+    return 0;
+}
+
+/* overlay_analyze(): symm_group_analyze() on the task's copy of the
+ * operators.  Returns 0, or -1 if memory can't be allocated.
+ */
+int overlay_analyze( struct group_overlay *o )
+{
+    if( 0 != own_copy( o ) ) {
+        return -1;
+    }
+    return symm_group_analyze( o->copy );
+}
+
+/* overlay_release(): gives up the task's copy of the operators, if any */
+void overlay_release( struct group_overlay *o )
+{
+    if( NULL != o->copy ) {
+        if( n_pooled < OVERLAY_POOL_SIZE ) {
+            overlay_pool[n_pooled++] = o->copy;
+        }
+        else {
+            free_symm_group( o->copy );
+        }
+        o->copy = NULL;
+    }
+    return;
+}
+
+/* symm_group_update(): sets the integer matrices and the stored facts
+ * about the group from its operators.  Operators which can't be encoded
+ * are left out of the BCM map, and of duplicated operators only the first
+ * is in it.
+ */
+void symm_group_update( struct symm_group *g )
+{
+    unsigned int h;
+    int i;
+
+    memset( g->slot, 0, sizeof(g->slot) );
+    g->identity = -1;
+    g->inversion = -1;
+    for( i = 0; i < g->n; i++ ) {
+         set_int_matrix( g, i );
+         if( (BCM_ERROR == g->bcm[i]) || (symm_group_lookup( g, g->bcm[i] ) >= 0) ) {
+             continue;
+         }
+         for( h = hash_bcm( g->bcm[i] ); 0 != g->slot[h]; h = (h + 1) & (SYMM_GROUP_HASH_SIZE - 1) )
+              ;
+         g->slot[h] = (unsigned char)(i + 1);
+         if( IDENTITY_BCM == g->bcm[i] ) {
+             g->identity = i;
+         }
+         else if( INVERSION_BCM == g->bcm[i] ) {
+             g->inversion = i;
+         }
+    }
+    g->centric = g->inversion >= 0 ? Centric : Acentric;
+    g->table = match_cayley_bcm( g->bcm, g->n );
+    return;
+}
+
+/* symm_group_lookup(): returns the position of the operator encoded by
+ * 'bcm', or -1 if it is not a member of the group.
+ */
+int symm_group_lookup( const struct symm_group *g, unsigned int bcm )
+{
+    unsigned int h;
+    int k;
+
+    for( h = hash_bcm( bcm ); 0 != g->slot[h]; h = (h + 1) & (SYMM_GROUP_HASH_SIZE - 1) ) {
+         k = g->slot[h] - 1;
+         if( g->bcm[k] == bcm ) {
+             return k;
+         }
+    }
+    return -1;
+}
+
+/* symm_group_set_bcm(): replaces the operators of 'g' by the 'n' encoded
+ * matrices in 'bcm' (at most MAX_GROUP_OPS), all with their truth values
+ * set.
+ */
+void symm_group_set_bcm( struct symm_group *g, const unsigned int *bcm, int n )
+{
+    int i;
+
+    for( i = 0; i < n; i++ ) {
+         g->bcm[i] = bcm[i];
+         if( NULL != g->cold ) {
+             decode_matrix( g->cold[i].mat, bcm[i] );
+             clear_analysis( &g->cold[i] );
+         }
+    }
+    g->n = n;
+    g->truth = mask_below( n );
+    symm_group_update( g );
+    return;
+}
+
+/* symm_group_append(): adds the operator 'mat' to 'g' with its truth value
+ * set.  'g' must have the cold fields, since 'mat' needn't be an integer
+ * matrix.  Returns the position of the new operator, or -1 if the group is
+ * full.
+ */
+int symm_group_append( struct symm_group *g, double mat[3][3] )
+{
+    int i;
+
+    i = g->n;
+    if( (i >= MAX_GROUP_OPS) || (NULL == g->cold) ) {
+        return -1;
+    }
+    memcpy( g->cold[i].mat, mat, sizeof(g->cold[i].mat) );
+    clear_analysis( &g->cold[i] );
+    g->bcm[i] = encode_matrix( mat );
+    g->truth |= mask_bit( i );
+    g->n++;
+    symm_group_update( g );
+    return i;
+}
+
+/* symm_group_swap(): exchanges the operators at positions 'i' and 'j' */
+void symm_group_swap( struct symm_group *g, int i, int j )
+{
+    struct symm_op_cold c;
+    unsigned int b;
+    group_mask ti, tj;
+
+    if( i == j ) {
+        return;
+    }
+    b = g->bcm[i];
+    g->bcm[i] = g->bcm[j];
+    g->bcm[j] = b;
+    if( NULL != g->cold ) {
+        c = g->cold[i];
+        g->cold[i] = g->cold[j];
+        g->cold[j] = c;
+    }
+    ti = mask_has( g->truth, i ) ? mask_bit( j ) : EMPTY_MASK;
+    tj = mask_has( g->truth, j ) ? mask_bit( i ) : EMPTY_MASK;
+    g->truth = mask_difference( g->truth, mask_bit( i ) | mask_bit( j ) ) | ti | tj;
+    symm_group_update( g );
+    return;
+}
+
+/* symm_group_centric_order(): puts the operators of a group in the order
+ * of bcm_centric_order(), the identity first and, if the group is centric,
+ * the proper operators before their inversion related partners.  All the
+ * operators must be encoded and distinct.  Returns 0, or -1 if 'g' is not
+ * a group.
+ */
+int symm_group_centric_order( struct symm_group *g )
+{
+    unsigned int order[MAX_GROUP_OPS];
+    int i;
+
+    memcpy( order, g->bcm, g->n * sizeof(order[0]) );
+    if( 0 != bcm_centric_order( order, g->n ) ) {
+        return -1;
+    }
+    for( i = 0; i < g->n; i++ ) {
+         symm_group_swap( g, i, symm_group_lookup( g, order[i] ) );
+    }
+    return 0;
+}
+
+/* symm_group_matrix(): the matrix of operator 'i', from the cold fields if
+ * there are any, otherwise from the integer matrix.
+ */
+void symm_group_matrix( const struct symm_group *g, int i, double m[3][3] )
+{
+    int k;
+
+    if( NULL != g->cold ) {
+        memcpy( m, g->cold[i].mat, sizeof(g->cold[i].mat) );
+        return;
+    }
+    for( k = 0; k < 9; k++ ) {
+         m[k / 3][k % 3] = g->mat[i][k];
+    }
+    return;
+}
+
+/* symm_group_mask(): the mask of the operators of 'g' which are members of
+ * the supergroup of the Cayley table 't', like mask_of_ops().
+ */
+group_mask symm_group_mask( const struct symm_group *g, const struct cayley_table *t )
+{
+    group_mask m = EMPTY_MASK;
+    int i, k;
+
+    for( i = 0; i < g->n; i++ ) {
+         k = cayley_index( t, g->bcm[i] );
+         if( k >= 0 ) {
+             m |= mask_bit( k );
+         }
+    }
+    return m;
+}
+
+/* transform_symm_group(): like transform_group(), all the operators in
+ * one transform_bcm_batch() call, and the stored facts about the group are
+ * updated to match.  Without the cold fields only
+ * operators with a valid bcm can be transformed, and the others are
+ * marked with BCM_ERROR.
+ */
+void transform_symm_group( struct symm_group *g, const struct rat_matrix *tm )
+{
+    unsigned int out[MAX_GROUP_OPS];
+    double m[3][3];
+    int i;
+
+    transform_bcm_batch( out, g->bcm, g->n, tm );
+    for( i = 0; i < g->n; i++ ) {
+         if( 0 != out[i] ) {
+             g->bcm[i] = out[i];
+             if( NULL != g->cold ) {
+                 decode_matrix( g->cold[i].mat, out[i] );
+             }
+         }
+         else if( NULL != g->cold ) {
+             g->bcm[i] = transform_matrix( g->cold[i].mat, g->bcm[i], tm );
+         }
+         else if( bcm_is_valid( g->bcm[i] ) ) {
+             g->bcm[i] = transform_matrix( m, g->bcm[i], tm );
+         }
+         else {
+             g->bcm[i] = BCM_ERROR;
+         }
+    }
+    symm_group_update( g );
+    return;
+}
+
+/* symm_group_from_ops(): fills 'g' from the sentinel terminated array 's'.
+ * The cold fields are copied too if 'with_cold' is set, otherwise 'g' has
+ * none.  Returns 0, or -1 if 's' has more than MAX_GROUP_OPS operators or
+ * the cold fields can't be allocated.
+ */
+int symm_group_from_ops( struct symm_group *g, struct symm_op *s, int with_cold )
+{
+    int i;
+
+    g->cold = NULL;
+    g->truth = EMPTY_MASK;
+    for( i = 0; 0 != s[i].bcm; i++ ) {
+         if( i == MAX_GROUP_OPS ) {
+             return -1;
+         }
+         g->bcm[i] = s[i].bcm;
+         if( True == s[i].truefalse ) {
+             g->truth |= mask_bit( i );
+         }
+    }
+    g->n = i;
+    symm_group_update( g );
+
+    if( with_cold ) {
+        g->cold = alloc_cold();
+        if( NULL == g->cold ) {
+            return -1;
+        }
+        for( i = 0; i < g->n; i++ ) {
+             memcpy( g->cold[i].mat, s[i].mat, sizeof(g->cold[i].mat) );
+             g->cold[i].n_fold = s[i].n_fold;
+             g->cold[i].rotation_angle = s[i].rotation_angle;
+             g->cold[i].eig_val = s[i].eig_val;
+             memcpy( g->cold[i].eig_vec, s[i].eig_vec, sizeof(g->cold[i].eig_vec) );
+        }
+    }
+    return 0;
+}
+
+/* symm_group_to_ops(): writes 'g' back to 's', which must have room for
+ * g->n operators and the sentinel.  Without the cold fields the matrices
+ * come from the integer matrices and the analysis fields are cleared.
+ */
+void symm_group_to_ops( const struct symm_group *g, struct symm_op *s )
+{
+    int i;
+
+    for( i = 0; i < g->n; i++ ) {
+         s[i].bcm = g->bcm[i];
+         s[i].truefalse = mask_has( g->truth, i ) ? True : False;
+         symm_group_matrix( g, i, s[i].mat );
+         if( NULL != g->cold ) {
+             s[i].n_fold = g->cold[i].n_fold;
+             s[i].rotation_angle = g->cold[i].rotation_angle;
+             s[i].eig_val = g->cold[i].eig_val;
+             memcpy( s[i].eig_vec, g->cold[i].eig_vec, sizeof(s[i].eig_vec) );
+         }
+         else {
+             s[i].n_fold = 0;
+             s[i].rotation_angle = 0.0f;
+             s[i].eig_val = 0.0;
+             s[i].eig_vec[0] = s[i].eig_vec[1] = s[i].eig_vec[2] = 0.0;
+         }
+    }
+    s[g->n].bcm = 0;
+    s[g->n].truefalse = False;
+    return;
+}
+
+/* symm_group_analyze(): the counterpart of analyze_symm_group() (see
+ * symm_mat.c).  Fills the cold fields with analyze_symm_group(),
+ * allocating them if need be.  Returns 0, or -1 if the allocation fails.
+ */
+int symm_group_analyze( struct symm_group *g )
+{
+    struct symm_op op[MAX_GROUP_OPS + 1];
+    int i;
+
+    if( NULL == g->cold ) {
+        g->cold = alloc_cold();
+        if( NULL == g->cold ) {
+            return -1;
+        }
+        for( i = 0; i < g->n; i++ ) {
+             symm_group_matrix( g, i, g->cold[i].mat );
+        }
+    }
+    for( i = 0; i < g->n; i++ ) {
+         op[i].bcm = g->bcm[i];
+         op[i].truefalse = mask_has( g->truth, i ) ? True : False;
+         memcpy( op[i].mat, g->cold[i].mat, sizeof(op[i].mat) );
+    }
+    op[g->n].bcm = 0;
+    analyze_symm_group( op );
+    for( i = 0; i < g->n; i++ ) {
+         g->cold[i].n_fold = op[i].n_fold;
+         g->cold[i].rotation_angle = op[i].rotation_angle;
+         g->cold[i].eig_val = op[i].eig_val;
+         memcpy( g->cold[i].eig_vec, op[i].eig_vec, sizeof(op[i].eig_vec) );
+    }
+    return 0;
+}
+
+void symm_group_free_cold( struct symm_group *g )
+{
+    free( g->cold );
+    g->cold = NULL;
+    return;
+}
+
+/* print_2_symm_groups(): like print_2_symm_ops(), which prints the
+ * operators of 'g2' in 'laws' next to the same operators of 'g1'.
+ */
+void print_2_symm_groups( FILE *out, const char *header1, const char *header2,
+                          const struct symm_group *g1, const struct symm_group *g2, group_mask laws )
+{
+#define PRINT2_FORMAT "%6.2f%6.2f%6.2f\t\t\t%6.2f%6.2f%6.2f\n"
+    double m1[3][3], m2[3][3];
+    int i, j, n_fold;
+
+    if( g1->n != g2->n ) {
+        fprintf( out, "Arrays not equal length: s1 has %d elements, s2 has %d elements\n",
+                       g1->n, g2->n );
+        return;
+    }
+
+    fprintf( out, "%s\t%s\n", header1, header2 );
+    for( i = 0; i < g2->n; i++ ) {
+         if( !mask_has( laws, i ) ) {
+             continue;
+         }
+         n_fold = NULL != g2->cold ? g2->cold[i].n_fold : 0;
+         if( i == g2->inversion ) { /* deal with special case for inversion twinning */
+              fprintf( out, "Twin domains related by inversion\n" );
+         }
+         else if( 0 != n_fold ) {  /* deal with rotation twin laws */
+              fprintf( out, "** %d-fold (%s) rotation axis about the [%4.2f %5.2f %5.2f] direction. **\n",
+                       n_fold, n_fold > 0 ? "proper" : "improper",
+                       g2->cold[i].eig_vec[0], g2->cold[i].eig_vec[1], g2->cold[i].eig_vec[2] );
+         }
+         symm_group_matrix( g1, i, m1 );
+         symm_group_matrix( g2, i, m2 );
+         for( j = 0; j < 3; j++ ) {
+              fprintf( out, PRINT2_FORMAT, m1[j][0], m1[j][1], m1[j][2],
+                                           m2[j][0], m2[j][1], m2[j][2] );
+         }
+         fputs( "\n\n", out );
+    }
+    fputc( '\n', out );
+    fflush( out );
+    return;
+#undef PRINT2_FORMAT
+}
@@ -0,0 +1,147 @@
+/* contains public interface for symmetry groups stored as arrays of their
+ * members' fields (see symm_group.c) for the Flack left coset decomposition
+ * program which uses alogorithms outlined in Acta Cryst. (1987), A43,
+ * 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef SYMM_GROUP_H
+#define SYMM_GROUP_H
+
+#include <stdio.h>
+
+#include "symm_mat.h"
+#include "cayley.h"
+#include "group_mask.h"
+#include "rational.h"
+
+#ifdef NEED_C89_COMPATIBILITY
+typedef signed char symm_int8;
+#else
+#include <stdint.h>
+typedef int8_t symm_int8;
+#endif
+
+/* a group has at most as many operators as the largest crystallographic
+ * point group.  This is fewer than the bits of a group mask, so that
+ * mask_below(n) never shifts by the width of the mask.
+ */
+#define MAX_GROUP_OPS  MAX_HOLOHEDRY_ORDER
+
+/* the BCM -> position map is an open addressing hash table which is never
+ * more than half full
+ */
+#define SYMM_GROUP_HASH_BITS  7
+#define SYMM_GROUP_HASH_SIZE  (1 << SYMM_GROUP_HASH_BITS)
+
+/* the fields of an operator which only the analysis and the printing of
+ * results need.  They are kept apart from the group so that the
+ * decomposition loops don't pull them into the cache.
+ */
+struct symm_op_cold {
+       double mat[3][3];     /* exact matrix, also for operators which can't be encoded */
+       int n_fold;
+       float rotation_angle;
+       double eig_val;
+       double eig_vec[3];
+       };
+
+/* A symmetry group as parallel arrays (a structure of arrays) rather than
+ * an array of struct symm_op.  The decomposition engine only reads 'bcm'
+ * and 'truth': for the 48 operators of m-3m these are 200 bytes, a few
+ * cache lines, where the array of struct symm_op is nearly 6 kB.  The
+ * integer matrices are valid for operators whose bcm is valid.  'cold' is
+ * NULL unless it has been asked for, and has room for MAX_GROUP_OPS
+ * operators when it is there.
+ *
+ * 'truth' is only used when a group stands in for an array of struct
+ * symm_op (see symm_group_from_ops()).  Elsewhere the truth values are
+ * passed as a separate group mask, so that a group can be shared.
+ *
+ * The order is stored, and so are the facts about the group which used to
+ * be found by scanning a sentinel terminated array: whether it is centric,
+ * where the identity and the inversion are, the Cayley table of the group
+ * if it is one of the tabulated supergroups, and a map from bcm to position.
+ * All of them are set by symm_group_update(), which every function here
+ * that changes the operators calls, so they are always in step with the
+ * operators.  Code which changes 'bcm' or 'n' directly must call it too.
+ */
+struct symm_group {
+       int n;
+       group_mask truth;                     /* bit i is the truefalse member of operator i */
+       unsigned int bcm[MAX_GROUP_OPS];
+       unsigned char slot[SYMM_GROUP_HASH_SIZE];  /* 1 + position of a bcm, or 0 (see symm_group_lookup()) */
+       int centric;                          /* Centric or Acentric */
+       int identity;                         /* position of the identity, or -1 */
+       int inversion;                        /* position of the inversion, or -1 */
+       const struct cayley_table *table;     /* NULL if the group isn't a tabulated supergroup */
+       symm_int8 mat[MAX_GROUP_OPS][9];      /* row major */
+       struct symm_op_cold *cold;
+       };
+
+/* A task's view of a group which it must not change, such as one of the
+ * shared supergroups: its own truth values, and its own copy of the
+ * operators, which is only made when an operator is first written (copy on
+ * write), i.e. when the group is transformed or analyzed.  Released copies
+ * are kept for reuse, so a run of many tasks allocates only a few of them.
+ */
+struct group_overlay {
+       const struct symm_group *base;   /* read only */
+       group_mask truth;                /* the task's truth values */
+       struct symm_group *copy;         /* NULL until written */
+       };
+
+/* prototypes */
+
+/* caller must free_symm_group() the groups returned by these */
+struct symm_group *alloc_symm_group( void );
+struct symm_group *duplicate_group( const struct symm_group *g );
+void free_symm_group( struct symm_group *g );
+
+/* the shared supergroups, which must not be changed or freed */
+const struct symm_group *select_supergroup( int pt_group );
+
+void overlay_init( struct group_overlay *o, const struct symm_group *base );
+const struct symm_group *overlay_group( const struct group_overlay *o );
+int overlay_transform( struct group_overlay *o, const struct rat_matrix *tm );
+int overlay_analyze( struct group_overlay *o );
+void overlay_release( struct group_overlay *o );
+
+void symm_group_update( struct symm_group *g );
+int symm_group_lookup( const struct symm_group *g, unsigned int bcm );
+void symm_group_set_bcm( struct symm_group *g, const unsigned int *bcm, int n );
+int symm_group_append( struct symm_group *g, double mat[3][3] );
+void symm_group_swap( struct symm_group *g, int i, int j );
+int symm_group_centric_order( struct symm_group *g );
+void symm_group_matrix( const struct symm_group *g, int i, double m[3][3] );
+group_mask symm_group_mask( const struct symm_group *g, const struct cayley_table *t );
+void transform_symm_group( struct symm_group *g, const struct rat_matrix *tm );
+int symm_group_from_ops( struct symm_group *g, struct symm_op *s, int with_cold );
+void symm_group_to_ops( const struct symm_group *g, struct symm_op *s );
+int symm_group_analyze( struct symm_group *g );
+void symm_group_free_cold( struct symm_group *g );
+void print_2_symm_groups( FILE *out, const char *header1, const char *header2,
+                          const struct symm_group *g1, const struct symm_group *g2, group_mask laws );
+
+#define symm_group_is_centric(g)  ((g)->centric)
+
+#endif
@@ -38,6 +38,7 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <math.h>
+#include <string.h>
 #include <limits.h>
 
 #ifdef NEED_C89_COMPATIBILITY
@@ -49,13 +50,13 @@
 
 #include "symm_mat.h"
 #include "matrix.h"
+#include "bcm.h"
+#include "cayley.h"
+#include "point_group.h"
+#include "group_mask.h"
 #include "float_util.h"
 #include "eigen.h"
 
-struct symm_op_trans_tabl {
-       char *name;
-       int  id;
-       };
 
 /* First some private functions for this file (mostly for diagnostic uses)*/
 
@@ -186,165 +187,6 @@ static double decode_value(unsigned int cs, int row, int col )
 
 }
 
-/*** Symmetry matricies for the supergroups ***/
-
-/* numbers in comments refer to the symmetry operation list order given
- * Flack's paper p. 567 for spacegroup P 432 (#207)
- */
-
-static struct symm_op ops_432[N_SYMM_OPS_432] = {
-              {True, 
-                {{ 1.0,  0.0,  0.0},   /* 1 */
-                 { 0.0,  1.0,  0.0},
-                 { 0.0,  0.0,  1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{-1.0,  0.0,  0.0},   /* 3 */
-                 { 0.0,  1.0,  0.0},
-                 { 0.0,  0.0, -1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{-1.0,  0.0,  0.0},   /* 2 */
-                 { 0.0, -1.0,  0.0},
-                 { 0.0,  0.0,  1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 1.0,  0.0,  0.0},   /* 4 */
-                 { 0.0, -1.0,  0.0},
-                 { 0.0,  0.0, -1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0,  1.0,  0.0},   /* 13 */
-                 { 1.0,  0.0,  0.0},
-                 { 0.0,  0.0, -1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0, -1.0,  0.0},   /* 14 */  
-                 {-1.0,  0.0,  0.0},
-                 { 0.0,  0.0, -1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{-1.0,  0.0,  0.0},   /* 18 */
-                 { 0.0,  0.0,  1.0},
-                 { 0.0,  1.0,  0.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{-1.0,  0.0,  0.0},   /* 19 */
-                 { 0.0,  0.0, -1.0},
-                 { 0.0, -1.0,  0.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0,  0.0,  1.0},   /* 22 */
-                 { 0.0, -1.0,  0.0},
-                 { 1.0,  0.0,  0.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0,  0.0, -1.0},   /* 24 */
-                 { 0.0, -1.0,  0.0},
-                 {-1.0,  0.0,  0.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0, -1.0,  0.0},   /* 16 */
-                 { 1.0,  0.0,  0.0},
-                 { 0.0,  0.0,  1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0,  1.0,  0.0},   /* 15 */
-                 {-1.0,  0.0,  0.0},
-                 { 0.0,  0.0,  1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0,  0.0,  1.0},   /* 5 */
-                 { 1.0,  0.0,  0.0},
-                 { 0.0,  1.0,  0.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0,  0.0,  1.0},   /* 6 */
-                 {-1.0,  0.0,  0.0},
-                 { 0.0, -1.0,  0.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0,  0.0, -1.0},   /* 7 */
-                 {-1.0,  0.0,  0.0},
-                 { 0.0,  1.0,  0.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0,  0.0, -1.0},   /* 8 */
-                 { 1.0,  0.0,  0.0},
-                 { 0.0, -1.0,  0.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0,  1.0,  0.0},   /* 9 */
-                 { 0.0,  0.0,  1.0},
-                 { 1.0,  0.0,  0.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0, -1.0,  0.0},   /* 10 */
-                 { 0.0,  0.0,  1.0},
-                 {-1.0,  0.0,  0.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0,  1.0,  0.0},   /* 11 */
-                 { 0.0,  0.0, -1.0},
-                 {-1.0,  0.0,  0.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0, -1.0,  0.0},   /* 12 */
-                 { 0.0,  0.0, -1.0},
-                 { 1.0,  0.0,  0.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 1.0,  0.0,  0.0},   /* 17 */
-                 { 0.0,  0.0,  1.0},
-                 { 0.0, -1.0,  0.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 1.0,  0.0,  0.0},   /* 20 */
-                 { 0.0,  0.0, -1.0},
-                 { 0.0,  1.0,  0.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0,  0.0,  1.0},   /* 21 */
-                 { 0.0,  1.0,  0.0},
-                 {-1.0,  0.0,  0.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0,  0.0, -1.0},   /* 23 */
-                 { 0.0,  1.0,  0.0},
-                 { 1.0,  0.0,  0.0}},0,0,0.0,0.0,{0.0,0.0,0.0}} };
-              
-
-/* numbers in comments refer to the symmetry operation list order given
- * Flack's paper p. 567 for spacegroup P 622 (#177)
- */
-
-static struct symm_op ops_622[N_SYMM_OPS_622] = {
-              {True, 
-                {{ 1.0,  0.0,  0.0},   /* 1 */
-                 { 0.0,  1.0,  0.0},
-                 { 0.0,  0.0,  1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0,  1.0,  0.0},   /* 7 */
-                 { 1.0,  0.0,  0.0},
-                 { 0.0,  0.0, -1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 1.0,  0.0,  0.0},   /* 8 */
-                 {-1.0, -1.0,  0.0},
-                 { 0.0,  0.0, -1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{-1.0, -1.0,  0.0},   /* 9 */
-                 { 0.0,  1.0,  0.0},
-                 { 0.0,  0.0, -1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True, 
-                {{-1.0,  0.0,  0.0},   /* 4 */
-                 { 0.0, -1.0,  0.0},
-                 { 0.0,  0.0,  1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0, -1.0,  0.0},   /* 10 */
-                 {-1.0,  0.0,  0.0},
-                 { 0.0,  0.0, -1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{-1.0,  0.0,  0.0},   /* 11 */
-                 { 1.0,  1.0,  0.0},
-                 { 0.0,  0.0, -1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 1.0,  1.0,  0.0},   /* 12 */
-                 { 0.0, -1.0,  0.0},
-                 { 0.0,  0.0, -1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{-1.0, -1.0,  0.0},   /* 2 */
-                 { 1.0,  0.0,  0.0},
-                 { 0.0,  0.0,  1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0,  1.0,  0.0},   /* 3 */
-                 {-1.0, -1.0,  0.0},
-                 { 0.0,  0.0,  1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 1.0,  1.0,  0.0},   /* 5 */
-                 {-1.0,  0.0,  0.0},
-                 { 0.0,  0.0,  1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}},
-              {True,
-                {{ 0.0, -1.0,  0.0},   /* 6 */
-                 { 1.0,  1.0,  0.0},
-                 { 0.0,  0.0,  1.0}},0,0,0.0,0.0,{0.0,0.0,0.0}} };
-
 /**************************************************************/
                
 /* implementations for the public functions */
@@ -412,22 +254,17 @@ void unitize_eigen_vector( struct symm_op *s )
 }
 
 
-/* analyze_symm_op():  identifies the type of symmetry element the symm_op
+/* classify_symm_op():  identifies the type of symmetry element the symm_op
  * matrix represents, and calculates the rotation angle for n_fold rotations.
+ * Returns the determinant of the matrix.  The rotation axis is found from
+ * the eigenvectors afterwards (see pick_symm_eigen() and
+ * pick_non_symm_eigen() below).
  */
 
-void analyze_symm_op( struct symm_op *s )
+static double classify_symm_op( struct symm_op *s )
 {
     double tr, det, phi;
     int i_tr, i_det;  /* int values for tr and det */
-    int i, j;
-
-/* the eigen related arrays declared below are where we store the results of 
- * eigen value, eigen vector calculations.
- */
-    struct real_eigen_data real_eig[3];
-    struct complex_eigen_data cmplx_eig[3];
-
 
 /* the formula for phi coded below comes from an old version of the 
  * International Tables.  Unfortunately, I can't find it the volume and page reference.
@@ -436,8 +273,16 @@ void analyze_symm_op( struct symm_op *s )
  * https://en.wikipedia.org/wiki/Rotation_matrix#Determining_the_angle
  */
 
-    det = determinant( s->mat );
-    tr  = trace( s->mat );
+    if( BCM_ERROR != s->bcm ) {
+        i_det = bcm_determinant( s->bcm );
+        i_tr  = bcm_trace( s->bcm );
+        det = i_det;
+        tr  = i_tr;
+    }
+    else {  /* matrix has elements other than -1, 0, 1 */
+        det = determinant( s->mat );
+        tr  = trace( s->mat );
+    }
 
     phi = acos( (tr/det - 1.0) / 2.0 );
     s->rotation_angle = (float)RAD2DEG( phi );
@@ -503,79 +348,450 @@ void analyze_symm_op( struct symm_op *s )
                 __FILE__, __LINE__ );
        exit( EXIT_FAILURE );
     }
+    return det;
+}
 
-/* now we work out the eigenvalues and eigenvectors for the symmetry matrix.
- * First thing to do is to determine whether matrix is symmetric or nonsymmetric and
- * solve using the appropriate eigen solver.
+/* Once the eigenvalues and eigenvectors of the symmetry matrix are worked
+ * out (with the symmetric or the nonsymmetric eigen solver, depending on the
+ * matrix) we pick the correct eigenvalue and eigenvector.  The eigen value
+ * must be real and the sign of the eigen value should be the same as the
+ * sign of the determinant of the symmetry matrix.  Last, the smallest
+ * non-zero eigenvector component(s) are made equal to 1.
  */
 
-/* Then we pick the correct eigenvalue and eigenvector.  The eigen value must be real and the
- * sign of the eigen value should be the same as the sign of the determinant of the symmetry
- * matrix.
- */
+static void pick_symm_eigen( struct symm_op *s, double det, struct real_eigen_data *real_eig )
+{
+    int i, j;
 
-    if( is_symmetric( s ) ) {
-        symm_eigen_solve( s->mat, real_eig );
-        for( i = 0; i < 3; i++ ) {
-             if( match_signs(det, real_eig[i].eig_value) ) {
-                 s->eig_val = real_eig[i].eig_value;
-                 for( j = 0; j < 3; j++ ) { /* copy the eigen data to symm_op */
-                      s->eig_vec[j] = real_eig[i].eig_vector[j];
-                 }
+    for( i = 0; i < 3; i++ ) {
+         if( match_signs(det, real_eig[i].eig_value) ) {
+             s->eig_val = real_eig[i].eig_value;
+             for( j = 0; j < 3; j++ ) { /* copy the eigen data to symm_op */
+                  s->eig_vec[j] = real_eig[i].eig_vector[j];
              }
-        }
+         }
     }
-    else {
-        non_symm_eigen_solve( s->mat, cmplx_eig );
-        for( i = 0; i < 3; i++ ) {
-             if( is_real_eigen_value(&cmplx_eig[i]) ) {
-                 int conv_errs = 0;
-                 struct real_eigen_data tmp;
-                 conv_errs = convert_complex_eig_to_real_eig( &cmplx_eig[i], &tmp );
-                 if( 0 != conv_errs ) {
-                     print_eigen_results( stderr, "Bad Eigen results!", cmplx_eig, 3 );
-                     fprintf( stderr, "%s: %d:  Eigenvector index (%d): Invalid conversion of complex to real. Exiting.\n",
-                                       __FILE__, __LINE__, i );
-                     exit( EXIT_FAILURE );
-                 }
-                 if( match_signs( det, tmp.eig_value ) ) {
-                     s->eig_val = tmp.eig_value;
-                     for( j = 0; j < 3; j++ ) {
-                          s->eig_vec[j] = tmp.eig_vector[j];
-                     }
+    unitize_eigen_vector( s );
+    return;
+}
+
+static void pick_non_symm_eigen( struct symm_op *s, double det, struct complex_eigen_data *cmplx_eig )
+{
+    int i, j;
+
+    for( i = 0; i < 3; i++ ) {
+         if( is_real_eigen_value(&cmplx_eig[i]) ) {
+             int conv_errs = 0;
+             struct real_eigen_data tmp;
+             conv_errs = convert_complex_eig_to_real_eig( &cmplx_eig[i], &tmp );
+             if( 0 != conv_errs ) {
+                 print_eigen_results( stderr, "Bad Eigen results!", cmplx_eig, 3 );
+                 fprintf( stderr, "%s: %d:  Eigenvector index (%d): Invalid conversion of complex to real. Exiting.\n",
+                                   __FILE__, __LINE__, i );
+                 exit( EXIT_FAILURE );
+             }
+             if( match_signs( det, tmp.eig_value ) ) {
+                 s->eig_val = tmp.eig_value;
+                 for( j = 0; j < 3; j++ ) {
+                      s->eig_vec[j] = tmp.eig_vector[j];
                  }
              }
+         }
+    }
+    unitize_eigen_vector( s );
+    return;
+}
+
+/* The analysis caches.  An operator's analysis depends only on its matrix,
+ * and the few hundred distinct operators of the supergroups in their
+ * various settings come up again in every task, so analyze_symm_op() only
+ * does the work the first time it sees a matrix.  A bcm entry is free when
+ * its bcm is 0, which isn't a symmetry operator.  The tables can't be
+ * written at build time, since the eigenvectors depend on the eigen code,
+ * which is chosen at run time.
+ */
+struct op_analysis {
+       int n_fold;
+       float rotation_angle;
+       double eig_val;
+       double eig_vec[3];
+       };
+
+struct bcm_analysis {
+       unsigned int bcm;
+       struct op_analysis a;
+       };
+
+struct rat_analysis {
+       int used;
+       struct rat_matrix key;
+       struct op_analysis a;
+       };
+
+static struct bcm_analysis bcm_cache[ANALYSIS_CACHE_SIZE];
+static struct rat_analysis rat_cache[RAT_ANALYSIS_CACHE_SIZE];
+static int bcm_cache_entries = 0;
+static int rat_cache_entries = 0;
+static int cache_on = 1;
+static const struct eigen_backend *cache_backend = NULL;  /* the eigen code the caches were filled with */
+static long cache_hits = 0;
+static long cache_misses = 0;
+
+static unsigned int hash_analysis_bcm( unsigned int bcm )
+{
+    return (unsigned int)(((bcm * 2654435761UL) & 0xffffffffUL) >> (32 - ANALYSIS_CACHE_BITS));
+}
+
+/* hash_rat_matrix(): FNV-1a over the numerators and the denominator */
+static unsigned int hash_rat_matrix( const struct rat_matrix *m )
+{
+    unsigned long h = 2166136261UL;
+    int i, j;
+
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              h = ((h ^ (unsigned long)(m->num[i][j] & 0xff)) * 16777619UL) & 0xffffffffUL;
+         }
+    }
+    h = ((h ^ (unsigned long)(m->den & 0xff)) * 16777619UL) & 0xffffffffUL;
+    return (unsigned int)(h & (RAT_ANALYSIS_CACHE_SIZE - 1));
+}
+
+static int same_rat_matrix( const struct rat_matrix *a, const struct rat_matrix *b )
+{
+    int i, j;
+
+    if( a->den != b->den ) {
+        return 0;
+    }
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              if( a->num[i][j] != b->num[i][j] ) {
+                  return 0;
+              }
+         }
+    }
+    return 1;
+}
+
+/* find_analysis(): the cache entry for the matrix of 's'.  If the matrix
+ * isn't in the cache a free entry is claimed for it and '*fresh' is set.
+ * Returns NULL if the matrix isn't an exact rational matrix or its cache is
+ * full.
+ */
+static struct op_analysis *find_analysis( struct symm_op *s, int *fresh )
+{
+    struct rat_matrix key;
+    double check[3][3];
+    unsigned int h;
+    int i, j;
+
+    *fresh = 0;
+    if( bcm_is_valid( s->bcm ) ) {
+        for( h = hash_analysis_bcm( s->bcm ); 0 != bcm_cache[h].bcm; h = (h + 1) & (ANALYSIS_CACHE_SIZE - 1) ) {
+             if( s->bcm == bcm_cache[h].bcm ) {
+                 return &bcm_cache[h].a;
+             }
+        }
+        if( 2 * (bcm_cache_entries + 1) > ANALYSIS_CACHE_SIZE ) {
+            return NULL;
         }
+        bcm_cache_entries++;
+        bcm_cache[h].bcm = s->bcm;
+        *fresh = 1;
+        return &bcm_cache[h].a;
     }
 
-/* make smallest non-zero eigenvector component(s) equal to 1 */
-    unitize_eigen_vector( s );
+/* only matrices which are exactly the fractions they snap to are cached,
+ * as those are the ones transform_matrix() writes.
+ */
+    if( 0 != rat_matrix_from_double( &key, s->mat ) ) {
+        return NULL;
+    }
+    rat_matrix_to_double( check, &key );
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              if( check[i][j] != s->mat[i][j] ) {
+                  return NULL;
+              }
+         }
+    }
+    for( h = hash_rat_matrix( &key ); rat_cache[h].used; h = (h + 1) & (RAT_ANALYSIS_CACHE_SIZE - 1) ) {
+         if( same_rat_matrix( &key, &rat_cache[h].key ) ) {
+             return &rat_cache[h].a;
+         }
+    }
+    if( 2 * (rat_cache_entries + 1) > RAT_ANALYSIS_CACHE_SIZE ) {
+        return NULL;
+    }
+    rat_cache_entries++;
+    rat_cache[h].used = 1;
+    rat_cache[h].key = key;
+    *fresh = 1;
+    return &rat_cache[h].a;
+}
+
+/* clear_analysis_caches(): empties the caches, which is needed when
+ * another eigen code is chosen, since the axes it finds may point the
+ * other way.
+ */
+static void clear_analysis_caches( void )
+{
+    memset( bcm_cache, 0, sizeof(bcm_cache) );
+    memset( rat_cache, 0, sizeof(rat_cache) );
+    bcm_cache_entries = 0;
+    rat_cache_entries = 0;
+    return;
+}
+
+/* analyze_batch(): analyses the 'n' (at most EIGEN_BATCH) operators s[0..n-1].
+ * Those in the analysis caches are copied from there.  The others are
+ * classified, and their matrices are handed to the eigen code in two
+ * batches, the symmetric and the nonsymmetric ones.  An operator whose
+ * matrix is pending in the caches, because another operator of the batch
+ * has it, is copied after the solves.
+ */
+static void analyze_batch( struct symm_op *s, int n )
+{
+    struct op_analysis *a[EIGEN_BATCH];
+    int solve[EIGEN_BATCH];               /* 1 if s[i] is solved here */
+    double det[EIGEN_BATCH];
+    double sym_mat[EIGEN_BATCH][3][3], gen_mat[EIGEN_BATCH][3][3];
+    int sym_op[EIGEN_BATCH], gen_op[EIGEN_BATCH];
+    struct real_eigen_data real_eig[EIGEN_BATCH][3];
+    struct complex_eigen_data cmplx_eig[EIGEN_BATCH][3];
+    int i, k, fresh, n_sym = 0, n_gen = 0;
+
+    if( cache_on && (eigen_backend() != cache_backend) ) {
+        clear_analysis_caches();
+        cache_backend = eigen_backend();
+    }
+    for( i = 0; i < n; i++ ) {
+         a[i] = NULL;
+         fresh = 0;
+         if( cache_on ) {
+             a[i] = find_analysis( &s[i], &fresh );
+         }
+         solve[i] = (NULL == a[i]) || fresh;
+         if( !solve[i] ) {
+             continue;
+         }
+         det[i] = classify_symm_op( &s[i] );
+         if( is_symmetric( &s[i] ) ) {
+             memcpy( sym_mat[n_sym], s[i].mat, sizeof(sym_mat[n_sym]) );
+             sym_op[n_sym++] = i;
+         }
+         else {
+             memcpy( gen_mat[n_gen], s[i].mat, sizeof(gen_mat[n_gen]) );
+             gen_op[n_gen++] = i;
+         }
+    }
+
+    if( n_sym > 0 ) {
+        symm_eigen_solve_batch( sym_mat, n_sym, real_eig );
+    }
+    if( n_gen > 0 ) {
+        non_symm_eigen_solve_batch( gen_mat, n_gen, cmplx_eig );
+    }
+    for( k = 0; k < n_sym; k++ ) {
+         pick_symm_eigen( &s[sym_op[k]], det[sym_op[k]], real_eig[k] );
+    }
+    for( k = 0; k < n_gen; k++ ) {
+         pick_non_symm_eigen( &s[gen_op[k]], det[gen_op[k]], cmplx_eig[k] );
+    }
+
+    for( i = 0; i < n; i++ ) {
+         if( solve[i] ) {
+             cache_misses++;
+             if( NULL != a[i] ) {
+                 a[i]->n_fold = s[i].n_fold;
+                 a[i]->rotation_angle = s[i].rotation_angle;
+                 a[i]->eig_val = s[i].eig_val;
+                 memcpy( a[i]->eig_vec, s[i].eig_vec, sizeof(a[i]->eig_vec) );
+             }
+         }
+    }
+    for( i = 0; i < n; i++ ) {
+         if( !solve[i] ) {
+             cache_hits++;
+             s[i].n_fold = a[i]->n_fold;
+             s[i].rotation_angle = a[i]->rotation_angle;
+             s[i].eig_val = a[i]->eig_val;
+             memcpy( s[i].eig_vec, a[i]->eig_vec, sizeof(s[i].eig_vec) );
+         }
+    }
+    return;
+}
+
+/* analyze_symm_op():  identifies the type of symmetry element the symm_op
+ * matrix represents, and calculates the rotation angle for n_fold rotations.
+ * The results are looked up in the analysis caches (see above).
+ */
+
+void analyze_symm_op( struct symm_op *s )
+{
+    analyze_batch( s, 1 );
+    return;
+}
+
+/* set_analysis_cache(): turns the analysis caches on (on != 0) or off, and
+ * returns the previous setting.  The cached results are kept either way.
+ */
+int set_analysis_cache( int on )
+{
+    int was = cache_on;
+
+    cache_on = on;
+    return was;
+}
+
+/* analysis_cache_stats(): the number of analyze_symm_op() calls answered
+ * from the caches and the number which did the work, and the number of
+ * matrices in the caches.  Any of the pointers may be NULL.
+ */
+void analysis_cache_stats( long *hits, long *misses, int *entries )
+{
+    if( NULL != hits )
+        *hits = cache_hits;
+    if( NULL != misses )
+        *misses = cache_misses;
+    if( NULL != entries )
+        *entries = bcm_cache_entries + rat_cache_entries;
+    return;
+}
+
+/* transform_matrix(): transforms one matrix from one basis to another,
+ * i.e. it becomes tm * mat * tm^-1.  The work is done exactly on rational
+ * matrices (see rational.c), starting from 'bcm' if it is valid and from
+ * 'mat' otherwise, so a result is encoded only if it really is integral.
+ * Returns the new bcm, which is BCM_ERROR if the matrix is not made of
+ * small fractions or its transform can't be represented exactly.  In that
+ * case 'mat' is left as it was.
+ */
+unsigned int transform_matrix( double mat[3][3], unsigned int bcm, const struct rat_matrix *tm )
+{
+    struct rat_matrix m;
+
+    if( bcm_is_valid( bcm ) ) {
+        rat_matrix_from_bcm( &m, bcm );
+    }
+    else if( 0 != rat_matrix_from_double( &m, mat ) ) {
+        return BCM_ERROR;
+    }
+    if( 0 != rat_matrix_conjugate( &m, tm, &m ) ) {
+        return BCM_ERROR;
+    }
+    rat_matrix_to_double( mat, &m );
+    return rat_matrix_encode( &m );
+}
+
+/* integral_bcm(): encodes p / det, or returns 0 if that isn't a matrix of
+ * -1, 0 and 1.  The elements of 'p' are exact integers, so comparing them
+ * with 'det' is exact too.
+ */
+static unsigned int integral_bcm( double p[3][3], double det )
+{
+    int e[9], k;
 
+    for( k = 0; k < 9; k++ ) {
+         if( 0.0 == p[k / 3][k % 3] ) {
+             e[k] = 0;
+         }
+         else if( det == p[k / 3][k % 3] ) {
+             e[k] = 1;
+         }
+         else if( -det == p[k / 3][k % 3] ) {
+             e[k] = -1;
+         }
+         else {
+             return 0;
+         }
+    }
+    return bcm_pack( e );
+}
+
+/* transform_bcm_batch(): the transform of transform_matrix() for 'n'
+ * encoded matrices, TRANSFORM_BATCH at a time with
+ * similarity_transform_batch() (see matrix.c).  With tm = N/d the
+ * transform of an integer matrix P is N * P * adj(N) / det(N), and since
+ * the elements of N are at most RAT_MAX_VALUE every intermediate is an
+ * integer well below 2^53, i.e. exact in a double.  out[i] is the new bcm
+ * if the result is a symmetry matrix, and 0 if it isn't or bcm[i] is not
+ * valid; transform_matrix() has the last word on those.
+ */
+void transform_bcm_batch( unsigned int *out, const unsigned int *bcm, int n, const struct rat_matrix *tm )
+{
+    double in[TRANSFORM_BATCH][3][3], prod[TRANSFORM_BATCH][3][3];
+    double left[3][3], adj[3][3], det;
+    int idx[TRANSFORM_BATCH];
+    int i, j, k;
+
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              left[i][j] = (double)tm->num[i][j];
+         }
+    }
+    det = determinant( left );
+    invert_matrix( 1.0, left, adj );
+
+    k = 0;
+    for( i = 0; i < n; i++ ) {
+         out[i] = 0;
+         if( (0.0 != det) && bcm_is_valid( bcm[i] ) ) {
+             decode_matrix( in[k], bcm[i] );
+             idx[k++] = i;
+         }
+         if( (TRANSFORM_BATCH == k) || ((n - 1 == i) && (k > 0)) ) {
+             similarity_transform_batch( prod, in, k, left, adj );
+             for( j = 0; j < k; j++ ) {
+                  out[idx[j]] = integral_bcm( prod[j], det );
+             }
+             k = 0;
+         }
+    }
     return;
 }
 
 /* transform_group(): transforms an array of struct symm_op from one
- * basis to another.
+ * basis to another.  Operators go through transform_bcm_batch() in
+ * chunks, and those it can't settle through transform_matrix().
+ * Operators whose transform can't be represented exactly are marked with
+ * BCM_ERROR.
  */
 
-void transform_group( struct symm_op *g, double tm[3][3] )
+void transform_group( struct symm_op *g, const struct rat_matrix *tm )
 {
-    int i;
+    unsigned int bcm[TRANSFORM_BATCH], out[TRANSFORM_BATCH];
+    int i, j, n;
 
-    for( i = 0; 0 != g[i].bcm; i++ ) {
-         double tmp[3][3] = { {0.0} };
-         similarity_transform( tmp, g[i].mat, tm );
-         copy_matrix(g[i].mat, tmp );
-         g[i].bcm = encode_matrix( g[i].mat );
+    for( i = 0; 0 != g[i].bcm; i += n ) {
+         for( n = 0; (n < TRANSFORM_BATCH) && (0 != g[i + n].bcm); n++ ) {
+              bcm[n] = g[i + n].bcm;
+         }
+         transform_bcm_batch( out, bcm, n, tm );
+         for( j = 0; j < n; j++ ) {
+              if( 0 != out[j] ) {
+                  g[i + j].bcm = out[j];
+                  decode_matrix( g[i + j].mat, out[j] );
+              }
+              else {
+                  g[i + j].bcm = transform_matrix( g[i + j].mat, g[i + j].bcm, tm );
+              }
+         }
     }
     return;
 }
 
+/* analyze_symm_group(): analyze_symm_op() for every operator of 'g', with
+ * the eigen solves done EIGEN_BATCH operators at a time.
+ */
 void analyze_symm_group( struct symm_op *g ) {
-     int i;
+     int i, n;
 
-     for( i = 0; 0 != g[i].bcm; i++ ) {
-          analyze_symm_op( &g[i] );
+     for( i = 0; 0 != g[i].bcm; i += n ) {
+          for( n = 0; (n < EIGEN_BATCH) && (0 != g[i + n].bcm); n++ )
+               ;
+          analyze_batch( &g[i], n );
      }
    
      return;
@@ -583,147 +799,56 @@ void analyze_symm_group( struct symm_op *g ) {
 
 
 /* lookup_supergroup():  takes a character string designating the supergroup 
- * and returns an integer representation of that group.
+ * and returns an integer representation of that group, or -1 if it isn't
+ * one of the supergroups.  The name is looked up in the build time group
+ * name hash table (see point_group.h).
  */
 
 int lookup_supergroup( const char *s )
 {
-    int supergroup_point_group = -1;
-    int i,
-        n;
-    struct symm_op_trans_tabl stab[] = {
-           {"-1", 1 },
-           {"2/m", 2 },
-           {"mmm", 222 },
-           {"4/mmm", 422 },
-           {"-3m", 32 },
-           {"6/mmm", 622 },
-           {"m-3m", 432 }
-           };
-
-   n = sizeof( stab ) / sizeof( struct symm_op_trans_tabl );
-   for( i = 0; i < n; i++ ) {
-        if( 0 == strcmp( stab[i].name, s ) ) {
-            supergroup_point_group = stab[i].id;
-            break;
-        }
-   }
+    const struct group_name *g;
 
-   return supergroup_point_group;
+    g = lookup_group_name( s, NULL );
+    return NULL != g ? g->supergroup : -1;
 }
 
 
 struct symm_op *select_symm_ops( const int pt_group, int *ierr )
 {
-    struct symm_op *ret = NULL,
-                   *sp;
-    int n_elem = 0,  /* number of symmetry elements */
-        k_elem,      /* k_elem length of array including sentinel value */
-        i;           /* counting index */
-    int *ip;          
-
-/* The following declarations are arrays of indicies of the symmetry
- * operators for the holoaxial point groups to be used for the G (super)
- * group symmetry.
- */
+    struct symm_op *ret = NULL;
+    const struct cayley_table *t;
+    int i;
 
-/*first do the ones for cubic, tetragonal, orthorhombic, monoclinic,
- * and triclinic.
- */
-    int m432[N_SYMM_OPS_432] = {0,1,2,3,4,5,6,7,8,9,10,
-                                11,12,13,14,15,16,17,18,19,20,
-                                21,22,23};
-    int m422[N_SYMM_OPS_422] = {0,1,2,3,4,5,10,11};
-    int m222[N_SYMM_OPS_222] = {0,1,2,3};
-    int m2[N_SYMM_OPS_2] = {0,1};
-    int m1[N_SYMM_OPS_1] = {0};
-
-/* here are the ones for hexangonal, trigonal, and rhombohedral groups */
-    int m622[N_SYMM_OPS_622] = {0,1,2,3,4,5,6,7,8,9,10,11};
-    int m32[N_SYMM_OPS_32] = {0,1,2,3,8,9};
-
-/* here is the inversion center matrix used for expanding the 
- * supergroup symmetry operators.
+/* The supergroup operators, the holoaxial group followed by the inversion
+ * related partners, are tabulated at build time (see gen_cayley.c), so
+ * all we need to do here is decode them.
  */
+    t = lookup_cayley_table( pt_group );
+    if( NULL == t ) {
+        *ierr = -1;  /* not an allowed point group, caller deals with error */
+        return NULL;
+    }
 
-    double invcen[3][3] = {
-          {-1.0,  0.0,  0.0 },
-          { 0.0, -1.0,  0.0 },
-          { 0.0,  0.0, -1.0 }
-                         };
-
-
-    switch( pt_group ) {
-      case 432:
-           n_elem = sizeof( m432 ) / sizeof( int );
-           ip = m432;
-           sp = ops_432;
-           *ierr = 0;
-           break;
-      case 622:
-           n_elem = sizeof( m622 ) / sizeof( int );
-           ip = m622;
-           sp = ops_622;
-           *ierr = 0;
-           break;
-      case 32:
-           n_elem = sizeof( m32 ) / sizeof( int );
-           ip = m32;
-           sp = ops_622;
-           *ierr = 0;
-           break;
-      case 422:
-           n_elem = sizeof( m422 ) / sizeof( int );
-           ip = m422;
-           sp = ops_432;
-           *ierr = 0;
-           break;
-      case 222:
-           n_elem = sizeof( m222 ) / sizeof( int );
-           ip = m222;
-           sp = ops_432;
-           *ierr = 0;
-           break;
-      case 2:
-           n_elem = sizeof( m2 ) / sizeof( int );
-           ip = m2;
-           sp = ops_432;
-           *ierr = 0;
-         break;
-      case 1:
-           n_elem = sizeof( m1 ) / sizeof( int );
-           ip = m1;
-           sp = ops_432;
-           *ierr = 0;
-         break;
-      default:
-         *ierr = -1;  /* not an allowed point group, caller deals with error */
-          return ret;
-         break;
-    }
-
-/* now allocate memory for symmetry ops and their inversion related
- * pairs.  Caller must free() this allocation!!!
- */
-    k_elem = 1 + 2 * n_elem;  /* +1 to store sentinel value */
-    ret = malloc( k_elem * sizeof( *ret ) );
+/* Caller must free() this allocation!!! */
+    ret = malloc( (t->order + 1) * sizeof( *ret ) );
     if( NULL == ret ) {
         *ierr = -2;  /* memory allocation error */
         return NULL;
     }
-    ret[k_elem - 1].bcm = 0;  /* sentinel value */
-    ret[k_elem - 1].truefalse = False;
 
-/* now copy symmetry matricies to the allocated array */
-    for( i = 0; i < n_elem; i++ ) {
-         ret[i] = sp[ ip[i] ];
+    for( i = 0; i < t->order; i++ ) {
          ret[i].truefalse = True;
-         ret[i].bcm = encode_matrix( ret[i].mat );
-         matrix_multiply3x3( ret[n_elem + i].mat, ret[i].mat, invcen  );
-         ret[n_elem+i].bcm = encode_matrix( ret[n_elem+i].mat );
-         ret[n_elem+i].truefalse = True;
+         ret[i].bcm = t->bcm[i];
+         decode_matrix( ret[i].mat, ret[i].bcm );
+         ret[i].n_fold = 0;
+         ret[i].rotation_angle = 0.0;
+         ret[i].eig_val = 0.0;
+         ret[i].eig_vec[0] = ret[i].eig_vec[1] = ret[i].eig_vec[2] = 0.0;
     }
-   
+    ret[t->order].bcm = 0;  /* sentinel value */
+    ret[t->order].truefalse = False;
+
+    *ierr = 0;
     return ret;
 
 }
@@ -735,45 +860,44 @@ struct symm_op *select_symm_ops( const int pt_group, int *ierr )
  */
 int set_truth_value( struct symm_op *s, int value, int total, ... )
 {
-   int i, idx, ret_code;
-   int c; 
+   int i, idx, c;
+   group_mask selected, m;
    va_list ap;
 
 /* first do a sanity check on 'value' */
-   switch( value ) {
-       case True:
-          ret_code = 0;
-          break;
-       case False:
-          ret_code = 0;
-          break;
-       default:
-            return -1;
+   if( (True != value) && (False != value) ) {
+       return -1;
    }
 
 /* count number of symmetry ops for sanity check for array bounds */
    c = count_ops( s );
-   c = c - 1;
-
-/* for total > 0, do the 'pick and choose' mode */
-   if( total >  0 ) {
-       while( i < total ) {
-           idx = va_arg( ap, int );
-           if( (idx < 0) || (idx > c) )  {
-               return -1;
-           }
-           s[idx].truefalse = value;
-           i++;
-       }
+   if( c > (int)GROUP_MASK_BITS ) {
+       return -1;
+   }
 
+/* for total > 0, do the 'pick and choose' mode, otherwise set them all */
+   if( total > 0 ) {
+       selected = EMPTY_MASK;
+       va_start( ap, total );
+       for( i = 0; i < total; i++ ) {
+            idx = va_arg( ap, int );
+            if( (idx < 0) || (idx >= c) )  {
+                va_end( ap );
+                return -1;
+            }
+            selected |= mask_bit( idx );
+       }
        va_end( ap );
    }
-   else {  /* else -- set them all the same value */
-      for( i = 0; 0 != s[i].bcm; i++ ) {
-           s[i].truefalse = value;
-      }
+   else {
+       selected = c == (int)GROUP_MASK_BITS ? ~EMPTY_MASK : mask_below( c );
    }
-   return ret_code;
+
+   m = mask_from_truth( s );
+   m = True == value ? mask_union( m, selected ) : mask_difference( m, selected );
+   mask_to_truth( m, s );
+
+   return 0;
    
 }
 
@@ -843,18 +967,21 @@ int is_centric( struct symm_op *s )
 
 int is_symmetric ( struct symm_op *s )
 {
+    int i, j;
 
-    struct symm_op tr = {0,
-                         { { 0.0, 0.0, 0.0 },
-                           { 0.0, 0.0, 0.0 },
-                           { 0.0, 0.0, 0.0 }
-                         }, 0, 0, 0.0,0.0,{0.0,0.0,0.0}
-                        }; 
+    if( BCM_ERROR != s->bcm ) {
+        return bcm_transpose( s->bcm ) == s->bcm ? 1 : 0;
+    }
 
-    memcpy( &tr, s, sizeof(tr) );
-    transpose_matrix( tr.mat );
-    tr.bcm = encode_matrix( tr.mat );
-    return tr.bcm == s->bcm ? 1 : 0 ;
+/* matrices which can't be encoded are compared element by element */
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < i; j++ ) {
+              if( !is_equal( s->mat[i][j], s->mat[j][i] ) ) {
+                  return 0;
+              }
+         }
+    }
+    return 1;
 }
 
 
@@ -45,6 +45,7 @@
 #include <errno.h>
 
 #include "sll.h"
+#include "rational.h"
 
 #ifdef  NEED_C89_COMPATIBILITY
 #include "c89_util.h"
@@ -80,6 +81,22 @@
 
 #define READ_LINE_LEN 132
 
+/* number of matrices transform_bcm_batch() transforms per kernel call */
+#define TRANSFORM_BATCH 64
+
+/* analyze_symm_op() remembers its results for the rest of the run, keyed
+ * by bcm, or by the exact rational matrix for operators which can't be
+ * encoded.  The caches are open addressing hash tables which are never
+ * more than half full; operators which don't fit are analysed each time.
+ */
+#define ANALYSIS_CACHE_BITS      10
+#define ANALYSIS_CACHE_SIZE      (1 << ANALYSIS_CACHE_BITS)
+#define RAT_ANALYSIS_CACHE_BITS  8
+#define RAT_ANALYSIS_CACHE_SIZE  (1 << RAT_ANALYSIS_CACHE_BITS)
+
+/* number of operators analyze_symm_group() hands to the eigen code at once */
+#define EIGEN_BATCH 64
+
 
 /* set bits for the 'flags' parameter for print_symm_ops() */
 #define TRUTH_VALUE  (1 << 0)
@@ -111,12 +128,16 @@ struct symm_op {
  */
 struct symm_op *select_symm_ops( const int pt_group, int *ierr );
 int lookup_supergroup( const char *s );
-void transform_group( struct symm_op *g, double tm[3][3] );
+unsigned int transform_matrix( double mat[3][3], unsigned int bcm, const struct rat_matrix *tm );
+void transform_bcm_batch( unsigned int *out, const unsigned int *bcm, int n, const struct rat_matrix *tm );
+void transform_group( struct symm_op *g, const struct rat_matrix *tm );
 unsigned int encode_matrix( double fm[3][3] );
 void decode_matrix( double fm[3][3], unsigned int cmx );
 void unitize_eigen_vector( struct symm_op *s );
 void analyze_symm_op( struct symm_op *s );
 void analyze_symm_group( struct symm_op *g );
+int set_analysis_cache( int on );
+void analysis_cache_stats( long *hits, long *misses, int *entries );
 int is_centric( struct symm_op *s );
 int is_symmetric( struct symm_op *s );
 int count_ops( struct symm_op *s );
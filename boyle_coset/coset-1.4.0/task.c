@@ -41,7 +41,14 @@
 #include "matrix.h"
 #include "symm_mat.h"
 #include "coset.h"
+#include "bcm.h"
+#include "cayley.h"
+#include "group_mask.h"
+#include "twin_index.h"
+#include "twin_class.h"
+#include "lattice_symm.h"
 #include "task.h"
+#include "eigen.h"
 #include "version.h"
 
 
@@ -78,15 +85,21 @@ static void print_task_header( FILE *out, struct task *t )
     size_t sz = TIME_BUFLEN;
 
     get_time( timebuf, sz);
-    fprintf( out, "COSET Decomposition Program (version %s - %s eigen code) run on: %s\n\n", VERSION, EIGEN_CODE, timebuf );
+    fprintf( out, "COSET Decomposition Program (version %s - %s eigen code) run on: %s\n\n", VERSION, eigen_backend_name(), timebuf );
     fprintf( out, "Task Description: %s\n", t->title );
     fprintf( out, "Metrically Available Supergroup's Symmetry: %s\n", t->super_name );
     fprintf( out, "Crystal's Pointgroup (Subgroup): %s (%s)\n", t->sub_name,
-                   is_centric(t->sub) ? "centric" : "acentric" );
+                   Centric == t->sub->centric ? "centric" : "acentric" );
     fprintf( out, "Flack Algorithm: %c\n", t->algorithm_name );
     fprintf( out, "Matrix which transforms Subgroup's Lattice to Supergroup's Lattice:\n" );
     print_matrix( out, t->trans_mat, "%8.4f%8.4f%8.4f\n" );
     fputc( '\n', out );
+    if( t->has_cell )
+        fprintf( out, "Crystal's Unit Cell: %.4f %.4f %.4f %.3f %.3f %.3f\n\n", t->cell.a, t->cell.b,
+                       t->cell.c, t->cell.alpha, t->cell.beta, t->cell.gamma );
+    if( t->lattice_obliquity >= 0.0 )
+        fprintf( out, "Supergroup and TRANS derived from the cell's lattice symmetry (twofolds within %.3f deg)\n\n",
+                       t->lattice_obliquity );
     if( NULL != t->shelx_ins_file ) 
         fprintf( out, "Original SHELX .ins file: %s\n", t->shelx_ins_file );
     if( NULL != t->new_base_name )
@@ -104,8 +117,6 @@ static void print_task_header( FILE *out, struct task *t )
 
 void init_task( struct task *t )
 {
-    int i, j;
-
     t->coset_decomp = NULL;
     t->title = NULL;
     t->super = NULL;
@@ -113,22 +124,19 @@ void init_task( struct task *t )
     t->n_subgroup_mats = 0;
 
 /* as a default the indentity matrix is used for the transformation matrix */
-    for( i = 0; i < 3; i++ ) {
-         for( j = 0; j < 3; j++ ) {
-              if( i == j ) {
-                  t->trans_mat[i][j] = 1.0;
-              }
-              else {
-                 t->trans_mat[i][j] = 0.0;
-              }
-         }
-    }
-
-    t->trans_mat_bcm = encode_matrix( t->trans_mat );
+    rat_matrix_identity( &t->trans );
+    rat_matrix_to_double( t->trans_mat, &t->trans );
+    t->trans_mat_bcm = rat_matrix_encode( &t->trans );
     t->outfile = NULL;
     t->shelx_ins_file = NULL;
     t->new_base_name = NULL;
     t->shelx_executable = NULL;
+    t->sweep = 0;
+    t->laue = 0;
+    t->has_cell = 0;
+    t->lattice_obliquity = -1.0;
+    t->decomposed = 0;
+    t->reps = EMPTY_MASK;
 
     return;
 }
@@ -145,11 +153,8 @@ void dealloc_task( void *task )
     if( NULL != t->title )
         free( t->title );
 
-    if( NULL != t->super )
-        free( t->super );
-
     if( NULL != t->sub )
-        free( t->sub );
+        free_symm_group( t->sub );
 
     if( NULL != t->outfile )
         free( t->outfile );
@@ -168,6 +173,314 @@ void dealloc_task( void *task )
 }
 
 
+/* derive_supergroup(): without a SUPERGROUP, the supergroup and TRANS are
+ * the lattice symmetry of the crystal's cell, from CELL or the INSFILE,
+ * with twofolds of obliquity up to 'max_obliquity' degrees (see
+ * lattice_symm.h).  The cell is taken to be primitive unless 'lattice'
+ * names its centring (see centring_matrix()), and the lattice symmetry is
+ * then that of the centred lattice.  Any TRANS given is replaced.  Returns
+ * 0, or -1 if there is a cell but its lattice symmetry couldn't be found.
+ */
+int derive_supergroup( struct task *t, char lattice, double max_obliquity )
+{
+    struct lattice_symmetry ls;
+    struct rat_matrix centring;
+    struct unit_cell primitive;
+    struct group_overlay conventional;
+    int i, keep;
+
+    if( !t->has_cell && (NULL != t->shelx_ins_file) ) {
+        t->has_cell = 0 == read_shelx_cell( t->shelx_ins_file, &t->cell );
+    }
+    if( !t->has_cell ) {
+        return 0;
+    }
+    if( 0 != centring_matrix( &centring, lattice ) ) {
+        return -1;
+    }
+    primitive_cell( &primitive, &t->cell, &centring );
+    if( 0 != derive_lattice_symmetry( &ls, &primitive, max_obliquity ) ) {
+        return -1;
+    }
+    t->super = select_supergroup( ls.table->point_group );
+    if( (NULL == t->super) || (0 != rat_matrix_multiply( &t->trans, &ls.trans, &centring )) ) {
+        t->super = NULL;
+        return -1;
+    }
+    snprintf( t->super_name, sizeof(t->super_name), "%s", ls.table->name );
+
+/* a centred cell which is already a conventional cell of the lattice
+ * symmetry is kept, as lattice_symmetry_sweep() keeps a primitive one.
+ * It is one when TRANS takes the supergroup's operators onto themselves.
+ */
+    overlay_init( &conventional, t->super );
+    keep = (NULL != t->super->table) && (0 == overlay_transform( &conventional, &t->trans ));
+    for( i = 0; keep && (i < t->super->n); i++ ) {
+         keep = cayley_index( t->super->table, overlay_group( &conventional )->bcm[i] ) >= 0;
+    }
+    overlay_release( &conventional );
+    if( keep ) {
+        rat_matrix_identity( &t->trans );
+    }
+    rat_matrix_to_double( t->trans_mat, &t->trans );
+    t->trans_mat_bcm = rat_matrix_encode( &t->trans );
+    t->lattice_obliquity = ls.obliquity;
+    return 0;
+}
+
+/* validate_task(): checks that the subgroup of a task is a group before
+ * any time is spent on it: the stated number of operators were given, all
+ * of them are integral symmetry matrices, the identity is present, there
+ * are no duplicates, and products and inverses stay in the group.  Then
+ * the subgroup transformed by TRANS must be a subgroup of the supergroup.
+ * All the checks are lookups of encoded matrices.  The operators are then
+ * put in the order Flack's algorithms expect: the identity first and, for
+ * a centric subgroup, the proper operators before their inversion related
+ * partners, which algorithm B relies on (see symm_group_centric_order()).
+ * Without a SUPERGROUP, one is derived from the cell if it is known.
+ * Returns 0 if the task is OK, otherwise -1 with the reason in 'msg'.
+ */
+int validate_task( struct task *t, char *msg, size_t len )
+{
+    struct rat_matrix inv;
+    struct symm_group *h;
+    struct group_overlay transformed;
+    int i, j, n;
+
+    if( (NULL == t->super) && (0 != derive_supergroup( t, 'P', DEFAULT_MAX_OBLIQUITY )) ) {
+        snprintf( msg, len, "no SUPERGROUP given, and none could be derived from the cell" );
+        return -1;
+    }
+    if( NULL == t->super ) {
+        snprintf( msg, len, "no SUPERGROUP given" );
+        return -1;
+    }
+    h = t->sub;
+    if( NULL == h ) {
+        snprintf( msg, len, "no SUBGROUP given" );
+        return -1;
+    }
+
+    n = h->n;
+    if( n != t->n_subgroup_mats ) {
+        snprintf( msg, len, "SUBGROUP states %d operators, but %d RMAT statements were given",
+                  t->n_subgroup_mats, n );
+        return -1;
+    }
+    for( i = 0; i < n; i++ ) {
+         if( !bcm_is_valid( h->bcm[i] ) ) {
+             snprintf( msg, len, "RMAT %d is not a crystallographic symmetry matrix", i + 1 );
+             return -1;
+         }
+    }
+    for( i = 0; i < n; i++ ) {
+         if( symm_group_lookup( h, h->bcm[i] ) != i ) {
+             snprintf( msg, len, "the RMAT statements have duplicated operators" );
+             return -1;
+         }
+    }
+    if( h->identity < 0 ) {
+        snprintf( msg, len, "the identity is not one of the RMAT operators" );
+        return -1;
+    }
+    for( i = 0; i < n; i++ ) {
+         if( symm_group_lookup( h, bcm_inverse( h->bcm[i] ) ) < 0 ) {
+             snprintf( msg, len, "the inverse of RMAT %d is not in the subgroup", i + 1 );
+             return -1;
+         }
+         for( j = 0; j < n; j++ ) {
+              if( symm_group_lookup( h, bcm_multiply( h->bcm[i], h->bcm[j] ) ) < 0 ) {
+                  snprintf( msg, len, "the subgroup is not closed: RMAT %d times RMAT %d is not in it",
+                            i + 1, j + 1 );
+                  return -1;
+              }
+         }
+    }
+
+/* the subgroup transformed to the supergroup's lattice */
+    if( 0 != rat_matrix_invert( &inv, &t->trans ) ) {
+        snprintf( msg, len, "TRANS is singular or its inverse can't be represented exactly" );
+        return -1;
+    }
+    if( NULL != t->super->table ) {
+        overlay_init( &transformed, h );
+        if( 0 != overlay_transform( &transformed, &t->trans ) ) {
+            snprintf( msg, len, "%s", strerror(errno) );
+            return -1;
+        }
+        for( i = 0; i < n; i++ ) {
+             if( cayley_index( t->super->table, overlay_group( &transformed )->bcm[i] ) < 0 ) {
+                 snprintf( msg, len, "RMAT %d transformed by TRANS is not in supergroup %s",
+                           i + 1, t->super_name );
+                 overlay_release( &transformed );
+                 return -1;
+             }
+        }
+        overlay_release( &transformed );
+    }
+
+    if( 0 != symm_group_centric_order( h ) ) {
+        snprintf( msg, len, "the subgroup's operators can't be paired by the inversion" );
+        return -1;
+    }
+    return 0;
+}
+
+/* sweep_orientations(): does the coset decomposition for every distinct
+ * orientation of the subgroup in the supergroup (the SWEEP directive).
+ * The orientations are the conjugates g*H*g^-1 of the transformed subgroup
+ * H by the operators g of the supergroup.  Each conjugate is identified by
+ * its group mask, which is a canonical encoding of the subgroup, so
+ * operators g which give the same placement are only decomposed once.
+ * The orientation given by g is that of the transformation matrix g*TRANS.
+ */
+static void sweep_orientations( FILE *out, struct task *t )
+{
+    const struct cayley_table *tbl;
+    struct group_overlay sub, super;
+    group_mask h, c, orient[MAX_HOLOHEDRY_ORDER];
+    int rep[MAX_HOLOHEDRY_ORDER];
+    int g, k, n = 0;
+    struct rat_matrix op, trans_k, inverted_trans_k;
+    char line[9 * RAT_FORMAT_LEN];
+
+    tbl = t->super->table;
+    overlay_init( &sub, t->sub );
+    if( (NULL == tbl) || (0 != overlay_transform( &sub, &t->trans )) ) {
+        fprintf( stderr, "%s:%d: %s\n", __FILE__, __LINE__,
+                 NULL != tbl ? strerror(errno) : "supergroup has no multiplication table" );
+        overlay_release( &sub );
+        return;
+    }
+
+/* find the placement of the subgroup given by TRANS in the supergroup */
+    h = symm_group_mask( overlay_group( &sub ), tbl );
+    overlay_release( &sub );
+    if( mask_order( h ) != t->sub->n ) {
+        fputs( "SWEEP: the transformed subgroup is not a subgroup of the supergroup,\n"
+               "so its orientations can not be enumerated.  Check TRANS.\n", out );
+        return;
+    }
+
+    for( g = 0; g < tbl->order; g++ ) {
+         c = mask_conjugate( tbl, g, h );
+         for( k = 0; (k < n) && (orient[k] != c); k++ )
+              ;
+         if( k == n ) {
+             orient[n] = c;
+             rep[n] = g;
+             n++;
+         }
+    }
+    fprintf( out, "SWEEP: %d distinct orientation(s) of the subgroup in the supergroup.\n", n );
+
+    for( k = 0; k < n; k++ ) {
+         fprintf( out, "\n=== Orientation %d of %d (supergroup operator %d) ===\n", k + 1, n, rep[k] );
+         rat_matrix_from_bcm( &op, t->super->bcm[rep[k]] );
+         if( (0 != rat_matrix_multiply( &trans_k, &op, &t->trans )) ||
+             (0 != rat_matrix_invert( &inverted_trans_k, &trans_k )) ) {
+             fputs( "SWEEP: the TRANS matrix for this orientation can't be represented exactly.\n", out );
+             continue;
+         }
+         rat_matrix_format( line, sizeof(line), &trans_k );
+         fprintf( out, "TRANS %s\n", line );
+
+         overlay_init( &sub, t->sub );
+         overlay_init( &super, t->super );
+         if( 0 != overlay_transform( &sub, &trans_k ) ) {
+             fprintf( stderr, "%s:%d: %s\n", __FILE__, __LINE__, strerror(errno) );
+             return;
+         }
+         super.truth = t->coset_decomp( t->super, super.truth, overlay_group( &sub ) );
+         overlay_release( &sub );
+
+         if( (0 != overlay_transform( &super, &inverted_trans_k )) || (0 != overlay_analyze( &super )) ) {
+             fprintf( stderr, "%s:%d: %s\n", __FILE__, __LINE__, strerror(errno) );
+             overlay_release( &super );
+             return;
+         }
+         print_2_symm_groups( out, "Untransformed Supergroup Matricies",
+                              "Transformed to Subgroup's Lattice",
+                              t->super, overlay_group( &super ), super.truth );
+         print_twin_indices( out, &trans_k, t->super, super.truth );
+         if( t->has_cell ) {
+             print_twin_law_ranking( out, &t->cell, overlay_group( &super ), super.truth );
+         }
+         overlay_release( &super );
+    }
+    return;
+}
+
+typedef void (*batch_engine)( const struct symm_group *, const group_mask *,
+                              const struct symm_group *const *, int, group_mask * );
+
+/* task_batch_engine(): the batch version of the task's algorithm, or NULL
+ * if the task's decomposition is left to process_task().
+ */
+static batch_engine task_batch_engine( const struct task *t )
+{
+    if( t->sweep || t->decomposed || (NULL == t->super) ) {
+        return NULL;
+    }
+    if( coset_group_A == t->coset_decomp ) {
+        return coset_batch_A;
+    }
+    if( coset_group_B == t->coset_decomp ) {
+        return coset_batch_B;
+    }
+    return NULL;
+}
+
+/* decompose_tasks(): does the coset decompositions of an array of tasks
+ * ahead of process_task().  Tasks with the same supergroup and algorithm
+ * are gathered up to GROUP_MASK_BITS at a time and go through the batch
+ * engine (see coset.c) together, so in a screening run the decomposition
+ * is a few word operations per task.  The representatives are kept in the
+ * task.  SWEEP tasks, and tasks whose subgroup can't be transformed here,
+ * are decomposed by process_task() as usual.
+ */
+void decompose_tasks( struct task **tasks, int n )
+{
+    struct group_overlay sub[GROUP_MASK_BITS];
+    const struct symm_group *H[GROUP_MASK_BITS];
+    struct task *lane_task[GROUP_MASK_BITS];
+    group_mask g[GROUP_MASK_BITS], reps[GROUP_MASK_BITS];
+    batch_engine engine;
+    int i, j, L, n_lanes;
+
+    for( i = 0; i < n; i++ ) {
+         engine = task_batch_engine( tasks[i] );
+         if( NULL == engine ) {
+             continue;
+         }
+         n_lanes = 0;
+         for( j = i; (j < n) && (n_lanes < (int)GROUP_MASK_BITS); j++ ) {
+              if( (task_batch_engine( tasks[j] ) != engine) || (tasks[j]->super != tasks[i]->super) ) {
+                  continue;
+              }
+              overlay_init( &sub[n_lanes], tasks[j]->sub );
+              if( 0 != overlay_transform( &sub[n_lanes], &tasks[j]->trans ) ) {
+                  overlay_release( &sub[n_lanes] );
+                  continue;
+              }
+              H[n_lanes] = overlay_group( &sub[n_lanes] );
+              g[n_lanes] = tasks[j]->super->truth;
+              lane_task[n_lanes++] = tasks[j];
+         }
+         if( 0 == n_lanes ) {
+             continue;
+         }
+
+         engine( tasks[i]->super, g, H, n_lanes, reps );
+         for( L = 0; L < n_lanes; L++ ) {
+              lane_task[L]->reps = reps[L];
+              lane_task[L]->decomposed = 1;
+              overlay_release( &sub[L] );
+         }
+    }
+    return;
+}
+
 void process_task( struct task *t )
 {
     FILE *coset_out;
@@ -177,9 +490,11 @@ void process_task( struct task *t )
                 *new_ins_file_list = NULL, 
                 *job_list = NULL;
 
-    struct symm_op *duped = NULL;
-    double det;
-    double inverted_trans_mat[3][3] = { { 0.0 } };
+    struct group_overlay sub, super;
+    struct rat_matrix inverted_trans;
+    int twin_class[MAX_HOLOHEDRY_ORDER];
+    int order[MAX_GROUP_OPS + 1];
+    int n_classes = -1;
 #ifdef USE_NONSTANDARD_FOPEN
     const char *mode = "at";
 #else  /* use only ANSI C Standard flags for mode */
@@ -209,63 +524,102 @@ void process_task( struct task *t )
 /* invert the transformation matrix to prepare for transforming the 
  * system of representatives back to the crystal's lattice setting.
  */
-    det = determinant( t->trans_mat );
-    invert_matrix( det, t->trans_mat, inverted_trans_mat );
+    if( 0 != rat_matrix_invert( &inverted_trans, &t->trans ) ) {  /* validate_task() checks this */
+        rat_matrix_identity( &inverted_trans );
+    }
+
+/* without a CELL directive, the cell is taken from the INSFILE if it has one */
+    if( !t->has_cell && (NULL != t->shelx_ins_file) ) {
+        t->has_cell = 0 == read_shelx_cell( t->shelx_ins_file, &t->cell );
+    }
 
 /* print out the input */
     print_task_header( coset_out, t );
 
-/* save a copy of the original subgroup  and then transform the subgroup 
- * the subgroups' truefalse value is initialized to 'False', so set it to
- * 'True' so that print_2_symm_ops() will work.
+/* the supergroup is shared by all the tasks, and the subgroup is printed
+ * before and after it is transformed, so both are transformed in overlays
+ * (see symm_group.h) rather than in place.
  */
-
-    set_truth_value( t->sub, True, 0 );
-    duped = duplicate_ops( t->sub );
-    if( NULL == duped ) {  /* symm_op duplication didn't work */
-        fprintf( stderr, "%s:%d: %s\n", __FILE__, __LINE__, strerror(errno) );
+    if( t->sweep && (NULL != t->coset_decomp) ) {
+        sweep_orientations( coset_out, t );
+        fputs( "### End of COSET Output ###\n", coset_out );
+        fclose( coset_out );
+        return;
     }
-    transform_group( t->sub, t->trans_mat );
-    if( NULL != duped ) {
-        print_2_symm_ops( coset_out, "Subgroup Symmetry Matricies",
-                          "Subgroup Symmetry Matrices Transformed to Supergroup's Lattice", duped, t->sub );
+    overlay_init( &sub, t->sub );
+    overlay_init( &super, t->super );
+    if( 0 != overlay_transform( &sub, &t->trans ) ) {
+        fprintf( stderr, "%s:%d: %s\n", __FILE__, __LINE__, strerror(errno) );
+        fclose( coset_out );
+        return;
     }
+    print_2_symm_groups( coset_out, "Subgroup Symmetry Matricies",
+                         "Subgroup Symmetry Matrices Transformed to Supergroup's Lattice",
+                         t->sub, overlay_group( &sub ), sub.truth );
 
-    free( duped ); /* don't need it anymore */ 
-
-/* do the actual coset decomposition here */
-    if( NULL != t->coset_decomp ) {
-        t->coset_decomp( t->super, t->sub );
+/* do the actual coset decomposition here, unless decompose_tasks() has */
+    if( t->decomposed ) {
+        super.truth = t->reps;
+    }
+    else if( NULL != t->coset_decomp ) {
+        super.truth = t->coset_decomp( t->super, super.truth, overlay_group( &sub ) );
     }
     else {  /* no algorithm  selected */
+        overlay_release( &sub );
         fputs( "### End of COSET Output ###\n", coset_out );
         fclose( coset_out );
         return;
     }
 
-/* duplicate the supergroup to prepare for printing out the untransformed 
- * and transformed potential twin laws.
+/* transform the system of representatives to the crystal's lattice and
+ * determine types of symmetry operators which are potential twin laws.
  */
-    duped = duplicate_ops( t->super );
-    if( NULL == duped ) {  /* symm_op duplication didn't work */
+    if( (0 != overlay_transform( &super, &inverted_trans )) || (0 != overlay_analyze( &super )) ) {
         fprintf( stderr, "%s:%d: %s\n", __FILE__, __LINE__, strerror(errno) );
+        overlay_release( &sub );
+        overlay_release( &super );
+        fclose( coset_out );
+        return;
     }
 
-    transform_group( t->super, inverted_trans_mat );
- 
-/* determine types of symmetry operators which are potential twin laws */
-    analyze_symm_group( t->super );
-
 /* print out potential twin laws */
     fputs("\n*** Potential Twin Laws for this Subgroup-Supergroup Relationship ***\n", coset_out );
     fputs( "Use matricies in right hand column for creating SHELX TWIN instructions.\n\n", coset_out );
-    if( NULL != duped ) {
-        print_2_symm_ops( coset_out, "Untransformed Supergroup Matricies",
-                          "Transformed to Subgroup's Lattice",
-                           duped, t->super );
+    print_2_symm_groups( coset_out, "Untransformed Supergroup Matricies",
+                         "Transformed to Subgroup's Lattice",
+                         t->super, overlay_group( &super ), super.truth );
+    print_twin_indices( coset_out, &t->trans, t->super, super.truth );
+    n_classes = twin_law_classes( t->super, super.truth, overlay_group( &sub ), t->laue,
+                                  TWIN_CLASS_NORMALIZER, twin_class );
+    if( (n_classes > 0) && (n_classes < mask_order( super.truth )) ) {
+        print_twin_law_classes( coset_out, t->super, super.truth, twin_class, n_classes, t->laue,
+                                TWIN_CLASS_NORMALIZER );
+    }
+    n_classes = twin_law_classes( t->super, super.truth, overlay_group( &sub ), t->laue,
+                                  TWIN_CLASS_REFINEMENT, twin_class );
+    if( (n_classes > 0) && (n_classes < mask_order( super.truth )) ) {
+        print_twin_law_classes( coset_out, t->super, super.truth, twin_class, n_classes, t->laue,
+                                TWIN_CLASS_REFINEMENT );
+    }
+    if( t->has_cell ) {
+        print_twin_law_ranking( coset_out, &t->cell, overlay_group( &super ), super.truth );
     }
 
-    free( duped );
+/* the TWIN instructions for the new SHELX .ins files, best fitting law
+ * first when the cell is known
+ */
+    if( (NULL != t->shelx_ins_file) && (NULL != t->new_base_name) ) {
+        if( n_classes > 0 ) {  /* one trial refinement per class of laws giving the same refinement */
+            super.truth = class_representatives( super.truth, twin_class, n_classes );
+        }
+        if( t->has_cell ) {
+            twin_law_order( &t->cell, overlay_group( &super ), super.truth, order );
+        }
+        errno = 0;
+        twin_shelx_instr = twin_ins_list( overlay_group( &super ), super.truth, t->has_cell ? order : NULL );
+    }
+    overlay_release( &sub );
+    overlay_release( &super );
 
 /* read a SHELX .ins file if it has been specified. */
 	    if( NULL != t->shelx_ins_file ) {
@@ -274,6 +628,7 @@ void process_task( struct task *t )
         if( NULL == orig_ins_file ) {
             fprintf( stderr,"%s:%d: %s\n", __FILE__,__LINE__,
             0 != errno ? strerror(errno) : "read_shelx_ins_file() returned NULL" );
+            dealloc_list( twin_shelx_instr );
             fclose( coset_out );
             return;
         }
@@ -288,7 +643,6 @@ void process_task( struct task *t )
  * for a subdequent least-squares job(s).
  */
     if( (NULL != t->new_base_name)  ) {
-            twin_shelx_instr = twin_ins_list( t->super );
             if( NULL == twin_shelx_instr ) {
                 fprintf( stderr,"%s:%d: %s\n", __FILE__,__LINE__,
                 0 != errno ? strerror(errno) : "twin_ins_list() returned NULL" );
@@ -35,29 +35,43 @@
 #include <stdio.h>
 
 #include "symm_mat.h"
+#include "symm_group.h"
+#include "rational.h"
+#include "twin_metric.h"
 
 
 #define GROUP_NAME_LEN 6
 
 struct task {
-       void (*coset_decomp)(struct symm_op *, struct symm_op * );
+       group_mask (*coset_decomp)(const struct symm_group *, group_mask, const struct symm_group * );
        char *title;
-       struct symm_op *super;
-       struct symm_op *sub;
+       const struct symm_group *super;   /* shared, see select_supergroup() */
+       struct symm_group *sub;
        char super_name[GROUP_NAME_LEN];
        char sub_name[GROUP_NAME_LEN];
        char algorithm_name;
        int n_subgroup_mats;
-       double trans_mat[3][3];
+       struct rat_matrix trans;   /* TRANS, exact */
+       double trans_mat[3][3];    /* TRANS as doubles, for printing */
        unsigned int trans_mat_bcm;
        char *outfile;
        char *shelx_ins_file;
        char *new_base_name;
        char *shelx_executable;
+       int sweep;              /* decompose every orientation of the subgroup (SWEEP) */
+       int laue;               /* Friedel pairs are merged, so g and -g are equivalent twin laws (LAUE) */
+       int has_cell;           /* the crystal's cell is known (CELL, or the INSFILE's CELL card) */
+       struct unit_cell cell;  /* for ranking the twin laws (see twin_metric.h) */
+       double lattice_obliquity;  /* >= 0 if SUPERGROUP and TRANS were derived from the cell */
+       int decomposed;         /* the decomposition was done by decompose_tasks() */
+       group_mask reps;        /* and this is its system of representatives */
        };
 
 void init_task( struct task *t );
 void dealloc_task( void *task );
+int derive_supergroup( struct task *t, char lattice, double max_obliquity );
+int validate_task( struct task *t, char *msg, size_t len );
+void decompose_tasks( struct task **tasks, int n );
 void process_task( struct task *t );
 #endif
 
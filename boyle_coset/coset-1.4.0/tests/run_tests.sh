@@ -0,0 +1,105 @@
+#!/bin/sh
+# Regression tests for COSET.  A same_laws test runs the program on an
+# input file and on a reference input which states the same task with
+# explicit RMAT statements, and checks that both give the same twin laws
+# and classes.  An expect_output test runs the program with the arguments
+# given, in this directory, and checks its output against a .out file.
+#
+# usage: sh tests/run_tests.sh [coset executable]
+
+COSET=${1:-./coset}
+case $COSET in /*) ;; *) COSET=`pwd`/$COSET ;; esac
+DIR=`dirname "$0"`
+TMP=${TMPDIR:-/tmp}/coset_tests.$$
+failed=0
+n=0
+
+mkdir -p "$TMP" || exit 1
+
+# laws(): the twin law and class sections of the output for an input file
+laws()
+{
+    "$COSET" "$1" 2>&1 | sed -n '/Potential Twin Laws/,/End of COSET Output/p'
+}
+
+# same_laws(): compares the output for an input file with its reference
+same_laws()
+{
+    n=`expr $n + 1`
+    laws "$DIR/$2" > "$TMP/ref"
+    laws "$DIR/$1" > "$TMP/out"
+    if [ ! -s "$TMP/ref" ]; then
+        echo "FAIL: $1: no twin laws from $2"
+        failed=`expr $failed + 1`
+    elif cmp -s "$TMP/ref" "$TMP/out"; then
+        echo "ok:   $1"
+    else
+        echo "FAIL: $1 differs from $2"
+        diff "$TMP/ref" "$TMP/out" | head -20
+        failed=`expr $failed + 1`
+    fi
+}
+
+# expect_output(): compares the output of the program run with the
+# arguments after the first with the expected output in the file named by
+# the first, leaving out the date and time of the run.  The program is run
+# in a copy of this directory, and files it writes there (e.g. by NEWINS)
+# are compared too, after its output.
+expect_output()
+{
+    name=$1
+    shift
+    n=`expr $n + 1`
+    rm -rf "$TMP/work"
+    cp -r "$DIR" "$TMP/work"
+    (cd "$TMP/work" && "$COSET" "$@" 2>&1) | grep -v ' run on: ' > "$TMP/out"
+    for f in `ls "$TMP/work"`; do
+        if [ ! -f "$DIR/$f" ]; then
+            echo "==> $f <==" >> "$TMP/out"
+            grep -v ' run on: ' "$TMP/work/$f" >> "$TMP/out"
+        fi
+    done
+    if cmp -s "$DIR/$name" "$TMP/out"; then
+        echo "ok:   $name"
+    else
+        echo "FAIL: $name differs from the output of coset $*"
+        diff "$DIR/$name" "$TMP/out" | head -20
+        failed=`expr $failed + 1`
+    fi
+}
+
+# algorithm B with a centric subgroup, 4/m in m-3m
+same_laws b_4m_generators.inp b_4m_rmat.inp
+same_laws b_4m_catalogue.inp b_4m_rmat.inp
+same_laws b_4m_misordered.inp b_4m_rmat.inp
+
+# bulk screening: the inversion twin of a non-centric crystal is not
+# lattice twinning
+expect_output bulk_none.out -B bulk_none.csv
+
+# TRANS given as fractions and as decimals (a C-centred cell), for which
+# no twin indices are computed
+expect_output trans_fraction.out trans_fraction.inp
+same_laws trans_decimal.inp trans_fraction.inp
+
+# twin indices of obverse/reverse twinning of a rhombohedral cell
+expect_output twin_index.out twin_index.inp
+
+# twin laws ranked by obliquity in the INSFILE's cell, and the NEWINS
+# .ins files written best fitting law first
+expect_output anilin_rank.out anilin_rank.inp
+expect_output rank_order.out rank_order.inp
+
+# the lattice symmetry of a cell at each tolerance, for a reduced and a
+# non-reduced cell
+expect_output lattice_tetragonal.out -C 10.0 10.05 14.0 90 90 90.8
+expect_output lattice_cubic_f.out -C 7.0711 7.0711 7.0711 60 60 60 1
+
+# bulk rows from CSV, PDB and CIF files, by one and by two workers
+expect_output bulk_rows.out -B -j 1 bulk_rows.csv bulk_rows.pdb bulk_rows.cif
+expect_output bulk_rows.out -B -j 2 bulk_rows.csv bulk_rows.pdb bulk_rows.cif
+expect_output bulk_rows_laue.out -B -l bulk_rows.csv bulk_rows.pdb bulk_rows.cif
+
+rm -rf "$TMP"
+echo "$n tests, $failed failed"
+[ 0 -eq $failed ]
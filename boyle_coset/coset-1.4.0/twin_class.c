@@ -0,0 +1,232 @@
+/* contains implementation for equivalence classes of twin laws (see twin_class.h)
+ * for the Flack left coset decomposition program which uses alogorithms
+ * outlined in Acta Cryst. (1987), A43, 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifdef NEED_C89_COMPATIBILITY
+#undef _ISOC99_SOURCE
+#else
+#define _ISOC99_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#ifdef NEED_C89_COMPATIBILITY
+#include "c89_util.h"
+#endif
+
+#include "symm_mat.h"
+#include "cayley.h"
+#include "group_mask.h"
+#include "symm_group.h"
+#include "twin_class.h"
+
+/* find_class(): union-find root with path halving */
+static int find_class( int *parent, int i )
+{
+    while( parent[i] != i ) {
+           parent[i] = parent[parent[i]];
+           i = parent[i];
+    }
+    return i;
+}
+
+static void join_classes( int *parent, int i, int j )
+{
+    i = find_class( parent, i );
+    j = find_class( parent, j );
+    if( i < j ) {
+        parent[j] = i;
+    }
+    else {
+        parent[i] = j;
+    }
+    return;
+}
+
+/* join_same_coset(): joins representative i to every representative whose
+ * coset is 'c'
+ */
+static void join_same_coset( int *parent, const group_mask *coset, const int *pos, int n, int i, group_mask c )
+{
+    int j;
+
+    for( j = 0; j < n; j++ ) {
+         if( (pos[j] >= 0) && (coset[j] == c) ) {
+             join_classes( parent, i, j );
+         }
+    }
+    return;
+}
+
+/* twin_law_classes(): sorts the coset representatives 'laws' of 'super'
+ * (still in the supergroup's cell) into classes of twin laws.  Laws in the
+ * same left coset gH are always in the same class, and if 'laue' is set so
+ * are the cosets gH and -gH, since with Friedel pairs merged the data
+ * can't tell them apart.  Further, with 'how':
+ *
+ *   - TWIN_CLASS_REFINEMENT, cosets in the same double coset HgH.  These
+ *     give the same twinned refinement of a fixed model, since h*g*h'
+ *     only permutes the twin domains by symmetry of the crystal.
+ *   - TWIN_CLASS_NORMALIZER, cosets conjugate by an operator n of the
+ *     normalizer of H in G, since n*g*H*n^-1 is the same twin seen from a
+ *     crystal re-indexed by n.  They are the same kind of twin, but they
+ *     are different refinements unless the model and the data are
+ *     re-indexed too.
+ *
+ * 'sub' is the subgroup transformed to the supergroup's cell.  On return
+ * class_of[i] is the class (numbered from 0 in order of first member) of
+ * the representative super[i], or -1 if super[i] is not a representative.
+ * Returns the number of classes, or -1 if the supergroup has no Cayley
+ * table or the subgroup is not in it.
+ */
+int twin_law_classes( const struct symm_group *super, group_mask laws, const struct symm_group *sub,
+                      int laue, int how, int *class_of )
+{
+    const struct cayley_table *t;
+    group_mask h, normalizer = EMPTY_MASK, coset[MAX_HOLOHEDRY_ORDER], m;
+    int parent[MAX_HOLOHEDRY_ORDER], class_id[MAX_HOLOHEDRY_ORDER];
+    int pos[MAX_HOLOHEDRY_ORDER];
+    int i, n, k, n_classes = 0;
+
+    t = super->table;
+    if( NULL == t ) {
+        return -1;
+    }
+    h = symm_group_mask( sub, t );
+    if( mask_order( h ) != sub->n ) {
+        return -1;
+    }
+    if( TWIN_CLASS_NORMALIZER == how ) {
+        for( n = 0; n < t->order; n++ ) {
+             if( mask_conjugate( t, n, h ) == h ) {
+                 normalizer |= mask_bit( n );
+             }
+        }
+    }
+
+    n = super->n;
+    for( i = 0; i < n; i++ ) {
+         class_of[i] = -1;
+         parent[i] = i;
+         pos[i] = mask_has( laws, i ) ? i : -1;
+         coset[i] = pos[i] >= 0 ? mask_left_coset( t, pos[i], h ) : EMPTY_MASK;
+    }
+
+    for( i = 0; i < n; i++ ) {
+         if( pos[i] < 0 ) {
+             continue;
+         }
+         if( TWIN_CLASS_NORMALIZER == how ) {
+             for( m = normalizer; EMPTY_MASK != m; m &= m - 1 ) {
+                  join_same_coset( parent, coset, pos, n, i, mask_conjugate( t, mask_lowest( m ), coset[i] ) );
+             }
+         }
+         else {  /* h*g*H for each h of H */
+             for( m = h; EMPTY_MASK != m; m &= m - 1 ) {
+                  k = cayley_product( t, mask_lowest( m ), pos[i] );
+                  join_same_coset( parent, coset, pos, n, i, mask_left_coset( t, k, h ) );
+             }
+         }
+         if( laue && (t->inversion >= 0) ) {
+             join_same_coset( parent, coset, pos, n, i, mask_left_coset( t, t->inversion, coset[i] ) );
+         }
+    }
+
+/* number the classes in order of their first member */
+    for( i = 0; i < n; i++ ) {
+         class_id[i] = -1;
+    }
+    for( i = 0; i < n; i++ ) {
+         if( pos[i] < 0 ) {
+             continue;
+         }
+         k = find_class( parent, i );
+         if( class_id[k] < 0 ) {
+             class_id[k] = n_classes++;
+         }
+         class_of[i] = class_id[k];
+    }
+    return n_classes;
+}
+
+/* print_twin_law_classes(): lists the members of each class of 'how' (see
+ * twin_law_classes()), with the twin laws numbered in the order they are
+ * listed in the output.
+ */
+void print_twin_law_classes( FILE *out, const struct symm_group *super, group_mask laws,
+                             const int *class_of, int n_classes, int laue, int how )
+{
+    int c, i, law;
+
+    if( TWIN_CLASS_NORMALIZER == how ) {
+        fputs( "*** Classes of Equivalent Twin Laws ***\n", out );
+        fprintf( out, "Twin laws in a class are related by the normalizer of the subgroup%s,\n",
+                 laue ? " or by inversion" : "" );
+        fputs( "i.e. they are the same twin seen from a re-indexed crystal.\n", out );
+    }
+    else {
+        fputs( "*** Twin Laws Giving the Same Refinement ***\n", out );
+        fprintf( out, "Twin laws in a class are in the same double coset HgH of the subgroup%s,\n",
+                 laue ? " or related by inversion" : "" );
+        fputs( "so only the first law of each class is used for SHELX refinements.\n", out );
+    }
+    fputs( "(twin laws numbered as listed above)\n", out );
+    for( c = 0; c < n_classes; c++ ) {
+         fprintf( out, "Class %d:", c + 1 );
+         law = 0;
+         for( i = 0; i < super->n; i++ ) {
+              if( !mask_has( laws, i ) ) {
+                  continue;
+              }
+              law++;
+              if( class_of[i] == c ) {
+                  fprintf( out, " %d", law );
+              }
+         }
+         fputc( '\n', out );
+    }
+    fputc( '\n', out );
+    return;
+}
+
+/* class_representatives(): the first member of each class of the twin
+ * laws 'laws', so that twin_ins_list() writes one trial refinement per
+ * class.
+ */
+group_mask class_representatives( group_mask laws, const int *class_of, int n_classes )
+{
+    int seen[MAX_HOLOHEDRY_ORDER] = { 0 };
+    int i;
+
+    for( i = 0; i < MAX_HOLOHEDRY_ORDER; i++ ) {
+         if( !mask_has( laws, i ) || (class_of[i] < 0) || (class_of[i] >= n_classes) ) {
+             continue;
+         }
+         if( seen[class_of[i]] ) {
+             laws = mask_difference( laws, mask_bit( i ) );
+         }
+         seen[class_of[i]] = 1;
+    }
+    return laws;
+}
@@ -0,0 +1,44 @@
+/* contains public interface for equivalence classes of twin laws for
+ * the Flack left coset decomposition program which uses alogorithms
+ * outlined in Acta Cryst. (1987), A43, 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef TWIN_CLASS_H
+#define TWIN_CLASS_H
+
+#include <stdio.h>
+
+#include "symm_group.h"
+
+/* how twin_law_classes() groups the twin laws */
+#define TWIN_CLASS_REFINEMENT  0   /* laws giving the same refinement: double cosets HgH */
+#define TWIN_CLASS_NORMALIZER  1   /* laws related by the normalizer of H: the same twin re-indexed */
+
+/* prototypes */
+int twin_law_classes( const struct symm_group *super, group_mask laws, const struct symm_group *sub,
+                      int laue, int how, int *class_of );
+void print_twin_law_classes( FILE *out, const struct symm_group *super, group_mask laws,
+                             const int *class_of, int n_classes, int laue, int how );
+group_mask class_representatives( group_mask laws, const int *class_of, int n_classes );
+
+#endif
@@ -0,0 +1,188 @@
+/* contains implementation for the twin index engine (see twin_index.h)
+ * for the Flack left coset decomposition program which uses alogorithms
+ * outlined in Acta Cryst. (1987), A43, 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifdef NEED_C89_COMPATIBILITY
+#undef _ISOC99_SOURCE
+#else
+#define _ISOC99_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#ifdef NEED_C89_COMPATIBILITY
+#include "c89_util.h"
+#endif
+
+#include "symm_mat.h"
+#include "bcm.h"
+#include "rational.h"
+#include "seitz.h"
+#include "symm_group.h"
+#include "twin_index.h"
+
+static int find_node( const struct twin_lattice *c, seitz_key k )
+{
+    int i;
+
+    for( i = 0; i < c->n; i++ ) {
+         if( c->key[i] == k ) {
+             return i;
+         }
+    }
+    return -1;
+}
+
+/* twin_lattice_from_trans(): finds the centring translations of the
+ * crystal's lattice in the supergroup's cell.  The rows of TRANS^-1 are the
+ * crystal's cell vectors in the supergroup's cell, and the nodes are all of
+ * their sums modulo the supergroup's lattice.  Returns the number of nodes
+ * (|det TRANS|), -1 if TRANS is not an integer matrix, or -2 if there are
+ * more than MAX_TWIN_INDEX nodes.
+ */
+int twin_lattice_from_trans( struct twin_lattice *c, const struct rat_matrix *trans )
+{
+    struct rat_matrix inv;
+    struct seitz_op gen[3], next;
+    seitz_key k;
+    int i, g;
+    long origin[3] = { 0, 0, 0 };
+
+    if( (1 != trans->den) || (0 != rat_matrix_invert( &inv, trans )) ) {
+        return -1;
+    }
+    for( g = 0; g < 3; g++ ) {
+         if( 0 != seitz_set_rational( &gen[g], IDENTITY_BCM, inv.num[g], inv.den ) ) {
+             return -2;
+         }
+    }
+
+/* the nodes found so far are the work list */
+    seitz_set( &c->node[0], IDENTITY_BCM, origin );
+    c->key[0] = seitz_encode( &c->node[0] );
+    c->n = 1;
+    for( i = 0; i < c->n; i++ ) {
+         for( g = 0; g < 3; g++ ) {
+              seitz_multiply( &next, &gen[g], &c->node[i] );
+              k = seitz_encode( &next );
+              if( find_node( c, k ) < 0 ) {
+                  if( c->n == MAX_TWIN_INDEX ) {
+                      return -2;
+                  }
+                  c->node[c->n] = next;
+                  c->key[c->n] = seitz_encode( &next );
+                  c->n++;
+              }
+         }
+    }
+    return c->n;
+}
+
+/* shared_nodes(): marks in 'shared' the nodes of the crystal's lattice
+ * which the twin law maps onto nodes, i.e. the lattice common to both twin
+ * domains.  The law is given as stored for the supergroup, the inverse
+ * transpose of its direct space matrix.  Returns the twin index, which is
+ * the number of nodes over the number of shared nodes, or -1 if the law
+ * can't be applied.
+ */
+int shared_nodes( const struct twin_lattice *c, unsigned int law_bcm, int *shared )
+{
+    struct seitz_op law, image;
+    long zero[3] = { 0, 0, 0 };
+    int i, n_shared = 0;
+
+    seitz_set( &law, bcm_transpose( bcm_inverse( law_bcm ) ), zero );
+    if( !bcm_is_valid( law.bcm ) ) {
+        return -1;
+    }
+    for( i = 0; i < c->n; i++ ) {
+         seitz_multiply( &image, &law, &c->node[i] );
+         image.bcm = IDENTITY_BCM;
+         shared[i] = find_node( c, seitz_encode( &image ) ) >= 0;
+         n_shared += shared[i];
+    }
+    return c->n / n_shared;
+}
+
+/* print_twin_indices(): for twinning by reticular merohedry, prints the
+ * twin index of each coset representative 'laws' of 'super', which must
+ * still be in the supergroup's cell.  Nothing is printed when TRANS is unimodular,
+ * since the twin index is then 1 for every twin law.  When the indices
+ * can't be computed, e.g. for a fractional TRANS from a centred or
+ * rhombohedral setting, a note says why.
+ */
+void print_twin_indices( FILE *out, const struct rat_matrix *trans, const struct symm_group *super, group_mask laws )
+{
+    struct twin_lattice c;
+    char line[3 * RAT_FORMAT_LEN];
+    int shared[MAX_TWIN_INDEX], common[MAX_TWIN_INDEX];
+    int i, k, n, law = 0, n_common = 0;
+
+    n = twin_lattice_from_trans( &c, trans );
+    if( 1 == n ) {
+        return;
+    }
+    if( -1 == n ) {
+        fputs( "*** Twin Indices ***\n", out );
+        fputs( "Twin indices not computed: TRANS is not an integer matrix, so the supergroup's "
+               "cell is not a supercell of the crystal's cell.\n\n", out );
+        return;
+    }
+    if( n < 0 ) {
+        fputs( "*** Twin Indices ***\n", out );
+        fprintf( out, "Twin indices not computed: |det TRANS| is larger than %d.\n\n", MAX_TWIN_INDEX );
+        return;
+    }
+
+    fputs( "*** Twin Indices (Reticular Merohedry) ***\n", out );
+    fprintf( out, "The supergroup's lattice is a sublattice of index %d of the crystal's lattice.\n", n );
+    fputs( "Nodes of the crystal's lattice in the supergroup's cell:\n", out );
+    for( i = 0; i < n; i++ ) {
+         seitz_format_translation( line, sizeof(line), &c.node[i] );
+         fprintf( out, "  %s\n", line );
+         common[i] = 1;
+    }
+    fputs( "\nTwin law    Twin index    Shared nodes  (twin laws numbered as listed above)\n", out );
+    for( i = 0; i < super->n; i++ ) {
+         if( !mask_has( laws, i ) ) {
+             continue;
+         }
+         law++;
+         k = shared_nodes( &c, super->bcm[i], shared );
+         if( k < 0 ) {
+             fprintf( out, "%8d    (not a lattice operation)\n", law );
+             continue;
+         }
+         fprintf( out, "%8d    %10d    %12d\n", law, k, n / k );
+         for( k = 0; k < n; k++ ) {
+              common[k] = common[k] && shared[k];
+         }
+    }
+    for( i = 0; i < n; i++ ) {
+         n_common += common[i];
+    }
+    fprintf( out, "Lattice common to all twin domains: index %d (%d of %d nodes)\n\n",
+             n / n_common, n_common, n );
+    return;
+}
@@ -0,0 +1,56 @@
+/* contains public interface for the twin index engine for twinning by
+ * reticular (pseudo)merohedry for the Flack left coset decomposition
+ * program which uses alogorithms outlined in Acta Cryst. (1987), A43,
+ * 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef TWIN_INDEX_H
+#define TWIN_INDEX_H
+
+#include <stdio.h>
+
+#include "symm_group.h"
+#include "rational.h"
+#include "seitz.h"
+
+/* When TRANS is an integer matrix with |det| = n > 1, the supergroup's
+ * cell is n times the crystal's cell, and the supergroup's lattice is a
+ * sublattice of index n of the crystal's lattice.  The crystal's lattice is
+ * then the supergroup's lattice plus n centring translations, which are
+ * held as Seitz operators {1|t} in the supergroup's cell.  n is the
+ * largest possible twin index, and it bounds all of the work here.
+ */
+#define MAX_TWIN_INDEX  SEITZ_MAX_DEN
+
+struct twin_lattice {
+       int n;                                  /* |det TRANS| */
+       struct seitz_op node[MAX_TWIN_INDEX];   /* node[0] is the origin */
+       seitz_key key[MAX_TWIN_INDEX];
+       };
+
+/* prototypes */
+int twin_lattice_from_trans( struct twin_lattice *c, const struct rat_matrix *trans );
+int shared_nodes( const struct twin_lattice *c, unsigned int law_bcm, int *shared );
+void print_twin_indices( FILE *out, const struct rat_matrix *trans, const struct symm_group *super, group_mask laws );
+
+#endif
@@ -0,0 +1,385 @@
+/* contains implementation for the metric ranking of twin laws for
+ * the Flack left coset decomposition program which uses alogorithms
+ * outlined in Acta Cryst. (1987), A43, 564-568, by H. D. Flack.
+ *
+ * The coset decomposition finds the twin laws from the symmetry alone.
+ * With the crystal's unit cell the laws can also be ranked by how well
+ * they fit the lattice, using the twin obliquity of Le Page, J. Appl.
+ * Cryst. (1982), 15, 255-259: the laws of low obliquity are the likely
+ * ones, and are the ones worth refining first.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifdef NEED_C89_COMPATIBILITY
+#undef _ISOC99_SOURCE
+#else
+#define _ISOC99_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#ifdef NEED_C89_COMPATIBILITY
+#include "c89_util.h"
+#endif
+
+#include "matrix.h"
+#include "float_util.h"
+#include "symm_group.h"
+#include "twin_metric.h"
+
+#define MAX_ROTATION_ORDER  6
+#define MAX_INDEX_DEN       12       /* for writing [uvw] and (hkl) as integers */
+#define INDEX_TOLERANCE     1.0e-6
+#define OBLIQUITY_TIE       1.0e-4   /* degrees; closer obliquities are ranked by the metric deviation */
+#define DEVIATION_TIE       1.0e-8
+
+/* cell_is_valid(): returns 1 if the cell has positive edges and angles
+ * which make a positive volume, 0 otherwise.
+ */
+int cell_is_valid( const struct unit_cell *c )
+{
+    double g[3][3];
+
+    if( (c->a <= 0.0) || (c->b <= 0.0) || (c->c <= 0.0) ) {
+        return 0;
+    }
+    if( !is_between( c->alpha, 0.0, 180.0 ) || !is_between( c->beta, 0.0, 180.0 ) ||
+        !is_between( c->gamma, 0.0, 180.0 ) ) {
+        return 0;
+    }
+    cell_metric( g, c );
+    return determinant( g ) > 0.0;
+}
+
+/* cell_from_string(): reads the cell from the numbers in 's', which are
+ * a b c alpha beta gamma, or as on a SHELX CELL card the wavelength
+ * followed by those.  Returns 0, or -1 if they aren't there or aren't a
+ * valid cell.
+ */
+int cell_from_string( struct unit_cell *c, const char *s )
+{
+    double v[7];
+    int n;
+
+    n = sscanf( s, "%lf%lf%lf%lf%lf%lf%lf", &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6] );
+    if( n < 6 ) {
+        return -1;
+    }
+    n -= 6;  /* skip the wavelength */
+    c->a = v[n];
+    c->b = v[n+1];
+    c->c = v[n+2];
+    c->alpha = v[n+3];
+    c->beta = v[n+4];
+    c->gamma = v[n+5];
+    return cell_is_valid( c ) ? 0 : -1;
+}
+
+/* cell_metric(): the metric tensor G of the cell, so that the squared
+ * length of the direct space vector x is x'Gx.
+ */
+void cell_metric( double g[3][3], const struct unit_cell *c )
+{
+    g[0][0] = c->a * c->a;
+    g[1][1] = c->b * c->b;
+    g[2][2] = c->c * c->c;
+    g[0][1] = g[1][0] = c->a * c->b * cos( DEG2RAD( c->gamma ) );
+    g[0][2] = g[2][0] = c->a * c->c * cos( DEG2RAD( c->beta ) );
+    g[1][2] = g[2][1] = c->b * c->c * cos( DEG2RAD( c->alpha ) );
+    return;
+}
+
+static int is_identity_matrix( double m[3][3] )
+{
+    int i, j;
+
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              if( fabs( m[i][j] - (i == j ? 1.0 : 0.0) ) > INDEX_TOLERANCE ) {
+                  return 0;
+              }
+         }
+    }
+    return 1;
+}
+
+static double quadratic_form( double m[3][3], const double v[3] )
+{
+    double sum = 0.0;
+    int i, j;
+
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              sum += v[i] * m[i][j] * v[j];
+         }
+    }
+    return sum;
+}
+
+static double frobenius_norm( double m[3][3] )
+{
+    double sum = 0.0;
+    int i, j;
+
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              sum += m[i][j] * m[i][j];
+         }
+    }
+    return sqrt( sum );
+}
+
+/* lattice_indices(): scales the lattice row or plane 'v' to the smallest
+ * integers, if it has them with a denominator up to MAX_INDEX_DEN, or else
+ * so that its largest component is 1.  The first nonzero component is made
+ * positive.
+ */
+static void lattice_indices( double v[3] )
+{
+    double least = 0.0, most = 0.0, scale, x;
+    int i, d, integral = 0;
+
+    for( i = 0; i < 3; i++ ) {
+         x = fabs( v[i] );
+         if( x > INDEX_TOLERANCE ) {
+             least = (0.0 == least) || (x < least) ? x : least;
+             most = x > most ? x : most;
+         }
+    }
+    if( 0.0 == most ) {
+        return;
+    }
+    for( d = 1; (d <= MAX_INDEX_DEN) && !integral; d++ ) {
+         integral = 1;
+         for( i = 0; i < 3; i++ ) {
+              x = d * v[i] / least;
+              integral = integral && (fabs( x - floor( x + 0.5 ) ) < INDEX_TOLERANCE);
+         }
+    }
+    scale = integral ? least / (d - 1) : most;
+    for( i = 0; (i < 3) && (fabs( v[i] ) <= INDEX_TOLERANCE); i++ )
+         ;
+    if( (i < 3) && (v[i] < 0.0) ) {
+        scale = -scale;
+    }
+    for( i = 0; i < 3; i++ ) {
+         v[i] = fabs( v[i] ) > INDEX_TOLERANCE ? v[i] / scale : 0.0;
+    }
+    return;
+}
+
+/* twin_law_metric(): the twin axis and plane, the obliquity and the metric
+ * deviation of the twin law 'law', given as stored for the groups (it
+ * acts on the indices hkl), in the cell with metric tensor 'g'.  The sum S
+ * of the powers of the law's rotation P, up to its order, is P's
+ * projection onto its axis: the columns of S are the (hkl) which P leaves
+ * fixed, and the rows are the [uvw].  Returns 0, or -1 if the law is not
+ * a rotation or rotoinversion of order up to 6.
+ */
+int twin_law_metric( struct twin_law_metric *m, double law[3][3], double g[3][3] )
+{
+    double p[3][3], power[3][3], next[3][3], sum[3][3] = { { 0.0 } };
+    double r[3][3], rt[3][3], rg[3][3], rgr[3][3], diff[3][3], gstar[3][3];
+    double det, norm, best_row = 0.0, best_col = 0.0, cos_obl;
+    int i, j, n, sign;
+
+    det = determinant( law );
+    if( is_zero( det ) ) {
+        return -1;
+    }
+    sign = det > 0.0 ? 1 : -1;
+    for( i = 0; i < 3; i++ ) {
+         for( j = 0; j < 3; j++ ) {
+              p[i][j] = sign * law[i][j];
+              power[i][j] = i == j ? 1.0 : 0.0;
+         }
+    }
+    for( n = 1; n <= MAX_ROTATION_ORDER; n++ ) {
+         matrix_add3x3( sum, sum, power );
+         matrix_multiply3x3( next, power, p );
+         copy_matrix( power, next );
+         if( is_identity_matrix( power ) ) {
+             break;
+         }
+    }
+    if( n > MAX_ROTATION_ORDER ) {
+        return -1;
+    }
+    m->n_fold = sign * n;
+
+/* the metric deviation, with the law acting on direct space vectors */
+    calculate_inverse_transpose( r, law );
+    copy_matrix( rt, r );
+    transpose_matrix( rt );
+    matrix_multiply3x3( rg, rt, g );
+    matrix_multiply3x3( rgr, rg, r );
+    matrix_subtract3x3( diff, rgr, g );
+    m->deviation = frobenius_norm( diff ) / frobenius_norm( g );
+
+    for( i = 0; i < 3; i++ ) {
+         m->axis[i] = 0.0;
+         m->plane[i] = 0.0;
+    }
+    m->obliquity = 0.0;
+    if( 1 == n ) {  /* the identity or the inversion */
+        return 0;
+    }
+
+    for( i = 0; i < 3; i++ ) {
+         norm = sum[i][0] * sum[i][0] + sum[i][1] * sum[i][1] + sum[i][2] * sum[i][2];
+         if( norm > best_row ) {
+             best_row = norm;
+             for( j = 0; j < 3; j++ ) {
+                  m->axis[j] = sum[i][j];
+             }
+         }
+         norm = sum[0][i] * sum[0][i] + sum[1][i] * sum[1][i] + sum[2][i] * sum[2][i];
+         if( norm > best_col ) {
+             best_col = norm;
+             for( j = 0; j < 3; j++ ) {
+                  m->plane[j] = sum[j][i];
+             }
+         }
+    }
+
+/* [uvw].(hkl) is the scalar product of the row and the plane's normal */
+    invert_matrix( determinant( g ), g, gstar );
+    cos_obl = fabs( m->axis[0] * m->plane[0] + m->axis[1] * m->plane[1] + m->axis[2] * m->plane[2] ) /
+              sqrt( quadratic_form( g, m->axis ) * quadratic_form( gstar, m->plane ) );
+    m->obliquity = RAD2DEG( acos( cos_obl < 1.0 ? cos_obl : 1.0 ) );
+    lattice_indices( m->axis );
+    lattice_indices( m->plane );
+    return 0;
+}
+
+/* ranks_before(): whether law 'a' fits the lattice better than law 'b'.
+ * Laws which aren't lattice operations come last, and equal laws keep
+ * their order.
+ */
+static int ranks_before( const struct twin_law_metric *a, const struct twin_law_metric *b )
+{
+    if( (a->n_fold == 0) || (b->n_fold == 0) ) {
+        return (a->n_fold != 0) && (b->n_fold == 0);
+    }
+    if( fabs( a->obliquity - b->obliquity ) > OBLIQUITY_TIE ) {
+        return a->obliquity < b->obliquity;
+    }
+    if( fabs( a->deviation - b->deviation ) > DEVIATION_TIE ) {
+        return a->deviation < b->deviation;
+    }
+    return 0;
+}
+
+/* rank_twin_laws(): the metrics of the twin laws 'laws' of 'g', which must
+ * be in the crystal's cell 'c', best fitting first.  'ranked' needs room
+ * for g->n laws.  Returns the number of laws.
+ */
+int rank_twin_laws( const struct unit_cell *c, const struct symm_group *g, group_mask laws,
+                    struct twin_law_metric *ranked )
+{
+    struct twin_law_metric m;
+    double metric[3][3], mat[3][3];
+    int i, j, n = 0;
+
+    cell_metric( metric, c );
+    for( i = 0; i < g->n; i++ ) {
+         if( !mask_has( laws, i ) ) {
+             continue;
+         }
+         symm_group_matrix( g, i, mat );
+         if( 0 != twin_law_metric( &m, mat, metric ) ) {
+             m.n_fold = 0;
+         }
+         m.op = i;
+         m.number = n + 1;
+
+/* insertion sort, which keeps laws of equal rank in the order listed */
+         for( j = n; (j > 0) && ranks_before( &m, &ranked[j-1] ); j-- ) {
+              ranked[j] = ranked[j-1];
+         }
+         ranked[j] = m;
+         n++;
+    }
+    return n;
+}
+
+/* twin_law_order(): the positions in 'g' of the twin laws 'laws', best
+ * fitting first, ending with -1, for writing the SHELX .ins files in that
+ * order (see twin_ins_list()).  'order' needs room for g->n + 1 entries.
+ * Returns the number of laws.
+ */
+int twin_law_order( const struct unit_cell *c, const struct symm_group *g, group_mask laws, int *order )
+{
+    struct twin_law_metric ranked[MAX_GROUP_OPS];
+    int k, n;
+
+    n = rank_twin_laws( c, g, laws, ranked );
+    for( k = 0; k < n; k++ ) {
+         order[k] = ranked[k].op;
+    }
+    order[n] = -1;
+    return n;
+}
+
+static void format_indices( char *buf, size_t len, const double v[3] )
+{
+    snprintf( buf, len, "%.4g %.4g %.4g", v[0], v[1], v[2] );
+    return;
+}
+
+/* print_twin_law_ranking(): lists the twin laws 'laws' of 'g', which must
+ * be in the crystal's cell 'c', best fitting first.
+ */
+void print_twin_law_ranking( FILE *out, const struct unit_cell *c, const struct symm_group *g, group_mask laws )
+{
+    struct twin_law_metric ranked[MAX_GROUP_OPS];
+    char axis[40], plane[40];
+    int k, n;
+
+    n = rank_twin_laws( c, g, laws, ranked );
+    fputs( "*** Twin Laws Ranked by Obliquity ***\n", out );
+    fprintf( out, "Crystal's cell: %.4f %.4f %.4f %.3f %.3f %.3f\n",
+             c->a, c->b, c->c, c->alpha, c->beta, c->gamma );
+    fputs( "Obliquity is the angle between the twin axis [uvw] and the normal to the\n", out );
+    fputs( "twin plane (hkl) (Le Page, 1982).  Metric deviation is |R'GR - G| / |G| for\n", out );
+    fputs( "the twin law R and the metric tensor G.  Both are zero for an exact symmetry\n", out );
+    fputs( "of the lattice.  (twin laws numbered as listed above)\n\n", out );
+    fputs( "Rank  Twin law  n-fold  Obliquity (deg)  Metric deviation  Twin axis [uvw]  Twin plane (hkl)\n", out );
+    for( k = 0; k < n; k++ ) {
+         if( 0 == ranked[k].n_fold ) {
+             fprintf( out, "%4d  %8d  (not a lattice operation)\n", k + 1, ranked[k].number );
+             continue;
+         }
+         if( (1 == ranked[k].n_fold) || (-1 == ranked[k].n_fold) ) {
+             fprintf( out, "%4d  %8d  %6d  %15.3f  %16.6f\n", k + 1, ranked[k].number,
+                      ranked[k].n_fold, ranked[k].obliquity, ranked[k].deviation );
+             continue;
+         }
+         format_indices( axis, sizeof(axis), ranked[k].axis );
+         format_indices( plane, sizeof(plane), ranked[k].plane );
+         fprintf( out, "%4d  %8d  %6d  %15.3f  %16.6f  [%s]  (%s)\n", k + 1, ranked[k].number,
+                  ranked[k].n_fold, ranked[k].obliquity, ranked[k].deviation, axis, plane );
+    }
+    fputc( '\n', out );
+    return;
+}
@@ -0,0 +1,67 @@
+/* contains public interface for the metric ranking of twin laws for
+ * the Flack left coset decomposition program which uses alogorithms
+ * outlined in Acta Cryst. (1987), A43, 564-568, by H. D. Flack.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Written in October 2026 as part of COSET, which is
+ * Copyright (C) 2008, 2012, 2013 Paul D. Boyle.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef TWIN_METRIC_H
+#define TWIN_METRIC_H
+
+#include <stdio.h>
+
+#include "symm_group.h"
+
+/* the crystal's unit cell, lengths in Angstroms and angles in degrees */
+struct unit_cell {
+       double a, b, c;
+       double alpha, beta, gamma;
+       };
+
+/* How well a twin law fits the crystal's lattice.  The twin axis of the
+ * law's rotation (its proper part) is the lattice row [uvw] which the
+ * rotation leaves fixed, and the twin plane is the lattice plane (hkl)
+ * which it maps onto itself.  The obliquity is Le Page's angle between
+ * the row and the normal of the plane, and the metric deviation is the
+ * change of the metric tensor G under the law, |R'GR - G| / |G|.  Both
+ * are zero when the law is an exact symmetry of the lattice.
+ */
+struct twin_law_metric {
+       int op;              /* position of the law in the group */
+       int number;          /* the law's number as listed in the output */
+       int n_fold;          /* order of the rotation, negative if improper */
+       double obliquity;    /* degrees */
+       double deviation;
+       double axis[3];      /* [uvw], zero when the rotation is the identity */
+       double plane[3];     /* (hkl) */
+       };
+
+/* prototypes */
+int cell_is_valid( const struct unit_cell *c );
+int cell_from_string( struct unit_cell *c, const char *s );
+void cell_metric( double g[3][3], const struct unit_cell *c );
+int twin_law_metric( struct twin_law_metric *m, double law[3][3], double g[3][3] );
+int rank_twin_laws( const struct unit_cell *c, const struct symm_group *g, group_mask laws,
+                    struct twin_law_metric *ranked );
+int twin_law_order( const struct unit_cell *c, const struct symm_group *g, group_mask laws, int *order );
+void print_twin_law_ranking( FILE *out, const struct unit_cell *c, const struct symm_group *g, group_mask laws );
+
+#endif
@@ -14,7 +14,28 @@ void usage( void )
                        "",
                        "On the command line, type:",
                        "",
-                       "coset <input_filename>",
+                       "coset [-e <eigen code>] <input_filename>",
+                       "",
+                       "or, to list every subgroup of the supergroups with their twin laws",
+                       "and intermediate groups:",
+                       "",
+                       "coset [-e <eigen code>] -L [supergroup ...]",
+                       "",
+                       "or, to find the lattice symmetry of a cell with the SUPERGROUP and TRANS",
+                       "for it at each obliquity tolerance up to max_obliquity (3 degrees):",
+                       "",
+                       "coset -C a b c alpha beta gamma [max_obliquity]",
+                       "",
+                       "or, to screen the cells and space groups of PDB CRYST1 records, CIF",
+                       "data blocks or CSV rows (id,a,b,c,alpha,beta,gamma,space_group) for",
+                       "twinning, one line of results for each:",
+                       "",
+                       "coset -B [-j jobs] [-t max_obliquity] [-f pdb|cif|csv] [-l] [file ...]",
+                       "",
+                       "The eigen code which finds the rotation axes of the symmetry operators",
+                       "may be chosen with -e or the COSET_EIGEN environment variable.  It is",
+                       "'analytic', or 'lapacke' or 'gsl' if they were built into the program.",
+                       "Otherwise the default chosen when the program was built is used.",
                        "",
                        "where <input_filename> is the name of a plaintext file which contains",
                        "a number of directives and parameters used to govern the execution of",
@@ -24,14 +45,18 @@ void usage( void )
                        "",
                        "TITLE <character string data>  [mandatory]",
                        "ALGORITHM   <single character> [mandatory]",
-                       "SUPERGROUP  <character string data> [mandatory]",
-                       "SUBGROUP  <character string> < integer> [mandatory]",
+                       "SUPERGROUP  <character string data> [mandatory unless the cell is known]",
+                       "SUBGROUP  <character string> [< integer> | <setting>] [mandatory]",
+                       "GENERATORS  <character string> < integer> [alternative to SUBGROUP]",
                        "RMAT  r11 r12 r13 r21 r22 r23 r31 f32 r33 [mandatory]",
                        "TRANS t11 t12 t13 t21 t22 t23 t31 t32 t33 [optional]",
                        "INSFILE  <character string data> [optional but needs TRANS]",
                        "OUTFILE  <character string data> [optional]",
                        "NEWINS   <character string data> [optional but needs INSFILE and TRANS]",
                        "EXEC     <character string data> [optional but needs TRANS and NEWINS]",
+                       "SWEEP    [optional, can't be used with NEWINS]",
+                       "LAUE     [optional]",
+                       "CELL  a b c alpha beta gamma [optional]",
                        "END     ",
                        "",
                        "The '#' character at the beginning of a line designates a comment and",
@@ -50,11 +75,23 @@ void usage( void )
                        "  -3m",
                        "  6/mmm",
                        "  m-3m",
+                       "  Without SUPERGROUP, the supergroup and TRANS are derived from the",
+                       "  cell (CELL or the INSFILE's) as by 'coset -C'.",
                        "",
                        "*SUBGROUP takes two parameters.  The first being a character string designation",
                        " for the crystal's point group, e.g. -3 or mm2.  The second parameter is",
                        " an integer which is equal to the number of symmetry operators for the",
-                       " crystal's point group.",
+                       " crystal's point group.  If the integer is left out, the point group's",
+                       " operators in the standard setting are taken from the program's catalogue",
+                       " of the 32 point groups and no RMAT statements are needed.  The unique",
+                       " axis of a monoclinic point group may be given as the setting, e.g.",
+                       " 'SUBGROUP 2/m c'.  Other settings have their own names, e.g. 312, 31m,",
+                       " -4m2, -62m, 2mm or m2m.",
+                       "",
+                       "*GENERATORS may be used instead of SUBGROUP.  It takes the same two",
+                       " parameters, except that the integer is the number of generators of",
+                       " the crystal's point group.  Only the generators are then given as RMAT",
+                       " statements, and the rest of the point group is generated by the program.",
                        "",
                        "*RMAT takes 9 numeric parameters, which are the matrix elements for the",
                        " symmetry operators for the point group.  Each symmetry operator takes a",
@@ -70,7 +107,9 @@ void usage( void )
                        "*TRANS takes 9 numeric elements which transform the crystal's unit cell ",
                        " parameters to the metrically available supergroup cell.  These elements",
                        " are normally obtained from a cell reduction program. If TRANS is omitted",
-                       " then the identity matrix is used",
+                       " then the identity matrix is used.  Elements may be integers, fractions",
+                       " (e.g. 1/3 or -2/3), or decimals, which are read as the nearest small",
+                       " fraction (e.g. 0.6667 is read as 2/3).",
                        "",
                        "*INSFILE takes a single character string which is filename of the SHELX",
                        " .ins file for the structure.  This file is not altered by the program but",
@@ -87,6 +126,18 @@ void usage( void )
                        "*EXEC takes a single character string which is the full pathname of the",
                        " local system's SHELX(T)L executable.",
                        "",
+                       "*SWEEP takes no parameters.  The coset decomposition is done for every",
+                       " distinct orientation (conjugate) of the subgroup in the supergroup, and",
+                       " the TRANS matrix for each orientation is printed with its twin laws.",
+                       "",
+                       "*LAUE takes no parameters.  It says that Friedel pairs are merged, so a",
+                       " twin law and its product with the inversion are treated as equivalent.",
+                       "",
+                       "*CELL takes the crystal's unit cell, or a SHELX CELL card as it is.",
+                       " Without it the INSFILE's CELL card is used.  With the cell, the twin",
+                       " laws are ranked by their Le Page obliquity and metric deviation, and",
+                       " NEWINS writes the .ins files best fitting law first.",
+                       "",
                        "*END takes no paramters and should be the last line of the file.",
                        NULL
                     };
@@ -3,9 +3,12 @@
 
 #define VERSION "1.4.0"
 
-/* EIGEN_CODE should be defined to be either "gsl" or "lapacke"
- * including the " characters
+/* EIGEN_CODE is the eigen code used unless the command line (-e) or the
+ * COSET_EIGEN environment variable names another.  It should be defined to
+ * be either "analytic", "gsl" or "lapacke" including the " characters.
+ * "analytic" needs no numerical library and is always built in; the others
+ * are built in with EIGEN_BACKENDS in the Makefile.
  */
-#define EIGEN_CODE "lapacke"
+#define EIGEN_CODE "analytic"
 
 #endif